@@ -0,0 +1,478 @@
+/****************************************************************************
+* Clase AlmacenFrio
+*
+* Almacenamiento escalonado de las listas de tweets: los tweets recientes
+* se quedan en memoria y los antiguos, que apenas se leen, se sellan en
+* segmentos de disco inmutables (ver ListaTweets::sellar_antiguos). Esta
+* clase escribe y lee los bloques sellados como secuencias de bytes; la
+* codificación de los tweets es cosa de ListaTweets.
+*
+* Los bloques se añaden uno detrás de otro al final del fichero de
+* segmento en curso, y lo escrito no se modifica nunca; cuando el fichero
+* pasa de TAM_FICHERO_FRIO bytes, se empieza otro. Cada bloque sellado se
+* identifica por una RefBloqueFrio (fichero, posición y tamaño), y un
+* fichero se cierra y se borra cuando ya no lo referencia ninguna lista.
+* En sistemas POSIX el fichero se borra del directorio nada más crearlo
+* (sigue abierto), así que no quedan segmentos huérfanos si el proceso
+* termina de forma anormal.
+*
+* Opcionalmente (activar_compresion), ListaTweets comprime los bloques
+* antes de sellarlos (ver compresion_lz.hpp); el almacén lleva la cuenta
+* de los bytes sellados antes y después de comprimir y de los bytes
+* descomprimidos y el tiempo empleado, para calcular la tasa de
+* compresión y la velocidad de descompresión.
+*
+* Los bloques leídos se guardan en una caché LRU de como mucho
+* 'max_bytes_cache' bytes: al pasarse, se descartan los que hace más
+* tiempo que no se usan. Un bloque descartado sigue en memoria mientras
+* alguien tenga el shared_ptr que devolvió leer().
+*
+* Se puede leer desde varios hilos a la vez, incluso mientras otros
+* sellan bloques.
+****************************************************************************/
+
+#ifndef __ALMACEN__FRIO__
+#define __ALMACEN__FRIO__
+#include <string>
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define __ALMACEN_FRIO_POSIX__
+#else
+#include <fstream>
+#endif
+
+namespace {
+	const std::uint64_t TAM_FICHERO_FRIO = std::uint64_t(64) << 20; // Bytes a partir de los que se empieza otro fichero de segmento
+	const unsigned MAX_INTENTOS_FICHERO_FRIO = 100; // Nombres que se prueban al crear un fichero de segmento
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// Fichero de segmento: solo se añaden bytes al final (desde un único
+	// hilo a la vez, ver AlmacenFrio::sellar) y se leen tramos ya escritos
+	class FicheroFrio {
+	public:
+		// Constructor: crea el fichero 'nombre', que no debe existir
+		FicheroFrio(const std::string &nombre, unsigned numero) :
+			nombre(nombre), numero_fichero(numero), tam(0),
+#if defined(__ALMACEN_FRIO_POSIX__)
+			fd(::open(nombre.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600)) {
+			if (fd >= 0) {
+				::unlink(nombre.c_str());
+			}
+		}
+#else
+			fichero(), cerrojo() {
+			// Sin O_EXCL: se comprueba antes que no exista
+			std::ifstream existente(nombre.c_str());
+			if (!existente.is_open()) {
+				fichero.open(nombre.c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+			}
+		}
+#endif
+
+		// Destructor: cierra y borra el fichero
+		~FicheroFrio() {
+#if defined(__ALMACEN_FRIO_POSIX__)
+			if (fd >= 0) {
+				::close(fd);
+			}
+#else
+			if (fichero.is_open()) {
+				fichero.close();
+				std::remove(nombre.c_str());
+			}
+#endif
+		}
+
+		// Indica si el fichero se ha creado
+		bool abierto() const {
+#if defined(__ALMACEN_FRIO_POSIX__)
+			return fd >= 0;
+#else
+			return fichero.is_open();
+#endif
+		}
+
+		// Número del fichero, distinto para cada fichero del proceso
+		unsigned numero() const {
+			return numero_fichero;
+		}
+
+		// Bytes escritos
+		std::uint64_t tamanyo() const {
+			return tam;
+		}
+
+		// Añade 'bytes' bytes al final y devuelve en 'posicion' dónde
+		// empiezan. Devuelve false si no se han podido escribir todos (el
+		// tamaño no cambia y se pueden sobrescribir).
+		bool anyadir(const char *datos, std::size_t bytes, std::uint64_t &posicion) {
+			posicion = tam;
+			bool correcto = abierto();
+#if defined(__ALMACEN_FRIO_POSIX__)
+			std::uint64_t pos = tam;
+			// pwrite() puede escribir solo una parte de cada vez
+			while (bytes > 0 && correcto) {
+				ssize_t escritos = ::pwrite(fd, datos, bytes, off_t(pos));
+				correcto = escritos > 0;
+				if (correcto) {
+					datos += escritos;
+					bytes -= std::size_t(escritos);
+					pos += std::uint64_t(escritos);
+				}
+			}
+			if (correcto) {
+				tam = pos;
+			}
+#else
+			if (correcto) {
+				std::lock_guard<std::mutex> bloqueo(cerrojo);
+				fichero.clear();
+				fichero.seekp(std::streamoff(tam));
+				correcto = bool(fichero.write(datos, std::streamsize(bytes)).flush());
+				if (correcto) {
+					tam += bytes;
+				}
+			}
+#endif
+			return correcto;
+		}
+
+		// Lee los 'bytes' bytes que empiezan en 'posicion'
+		// PRECONDICIÓN: ya se han escrito
+		bool leer(std::uint64_t posicion, char *datos, std::size_t bytes) const {
+			bool correcto = abierto();
+#if defined(__ALMACEN_FRIO_POSIX__)
+			while (bytes > 0 && correcto) {
+				ssize_t leidos = ::pread(fd, datos, bytes, off_t(posicion));
+				correcto = leidos > 0;
+				if (correcto) {
+					datos += leidos;
+					bytes -= std::size_t(leidos);
+					posicion += std::uint64_t(leidos);
+				}
+			}
+#else
+			if (correcto) {
+				std::lock_guard<std::mutex> bloqueo(cerrojo);
+				fichero.clear();
+				fichero.seekg(std::streamoff(posicion));
+				correcto = bool(fichero.read(datos, std::streamsize(bytes)));
+			}
+#endif
+			return correcto;
+		}
+
+	private:
+		FicheroFrio(const FicheroFrio &);
+		FicheroFrio & operator=(const FicheroFrio &);
+
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		std::string nombre;
+		unsigned numero_fichero;
+		// Bytes escritos (solo los modifica el hilo que sella)
+		std::uint64_t tam;
+#if defined(__ALMACEN_FRIO_POSIX__)
+		int fd;
+#else
+		// Un fstream no admite lecturas simultáneas
+		mutable std::fstream fichero;
+		mutable std::mutex cerrojo;
+#endif
+	};
+
+	// Bloque sellado: los 'bytes' bytes que empiezan en 'posicion' en
+	// 'fichero'
+	struct RefBloqueFrio {
+		std::shared_ptr<FicheroFrio> fichero;
+		std::uint64_t posicion;
+		std::uint32_t bytes;
+	};
+
+	//---------------------------------------------------------------------------
+	class AlmacenFrio {
+	public:
+		// Bytes de un bloque sellado
+		typedef std::vector <char> Bytes;
+
+		// Devuelve el almacén del proceso
+		static AlmacenFrio & global() {
+			static AlmacenFrio almacen;
+			return almacen;
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONFIGURACIÓN
+
+		// Activa el almacén: los segmentos se crean en 'directorio', las
+		// listas dejan en memoria al menos sus 'tweets_en_memoria' últimos
+		// tweets (como mínimo 1) y la caché de bloques leídos ocupa como
+		// mucho 'max_bytes_cache' bytes. Los bloques ya sellados se siguen
+		// leyendo de su fichero.
+		void configurar(const std::string &directorio, unsigned tweets_en_memoria, std::size_t max_bytes_cache) {
+			std::lock_guard<std::mutex> bloqueo(cerrojo);
+			dir = directorio;
+			actual.reset();
+			max_bytes = max_bytes_cache;
+			descartar_sobrantes();
+			min_en_memoria.store(std::max(tweets_en_memoria, 1u), std::memory_order_relaxed);
+			activado.store(true, std::memory_order_release);
+		}
+
+		// Indica si los bloques se comprimen al sellarlos (los ya sellados
+		// se leen igual, estén comprimidos o no)
+		void activar_compresion(bool activar) {
+			compresion.store(activar, std::memory_order_relaxed);
+		}
+
+		// Desactiva el almacén: no se sella nada más, pero los bloques ya
+		// sellados se siguen leyendo
+		void desactivar() {
+			std::lock_guard<std::mutex> bloqueo(cerrojo);
+			activado.store(false, std::memory_order_release);
+			actual.reset();
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+
+		// Indica si hay que sellar los tweets antiguos
+		bool activo() const {
+			return activado.load(std::memory_order_acquire);
+		}
+
+		// Número de tweets más recientes que se quedan en memoria
+		unsigned tweets_en_memoria() const {
+			return min_en_memoria.load(std::memory_order_relaxed);
+		}
+
+		// Indica si hay que comprimir los bloques al sellarlos
+		bool compresion_activa() const {
+			return compresion.load(std::memory_order_relaxed);
+		}
+
+		// Bytes de los bloques que hay en la caché
+		std::size_t bytes_en_cache() const {
+			std::lock_guard<std::mutex> bloqueo(cerrojo);
+			return bytes_cache;
+		}
+
+		// Número de bloques leídos del disco y servidos desde la caché
+		unsigned long long lecturas_disco() const {
+			std::lock_guard<std::mutex> bloqueo(cerrojo);
+			return num_lecturas;
+		}
+		unsigned long long aciertos_cache() const {
+			std::lock_guard<std::mutex> bloqueo(cerrojo);
+			return num_aciertos;
+		}
+
+		// Número de escrituras y lecturas fallidas y de bloques leídos
+		// cuyos datos no son válidos (ver anotar_bloque_invalido)
+		unsigned long long errores() const {
+			std::lock_guard<std::mutex> bloqueo(cerrojo);
+			return num_errores;
+		}
+
+		// Bytes sellados: escritos en disco y los que habrían ocupado sin
+		// comprimir (su cociente es la tasa de compresión)
+		unsigned long long bytes_sellados() const {
+			std::lock_guard<std::mutex> bloqueo(cerrojo);
+			return num_bytes_sellados;
+		}
+		unsigned long long bytes_sin_comprimir() const {
+			std::lock_guard<std::mutex> bloqueo(cerrojo);
+			return num_bytes_sin_comprimir;
+		}
+
+		// Bytes obtenidos al descomprimir bloques y nanosegundos empleados
+		unsigned long long bytes_descomprimidos() const {
+			return num_bytes_descomprimidos.load(std::memory_order_relaxed);
+		}
+		unsigned long long ns_descompresion() const {
+			return num_ns_descompresion.load(std::memory_order_relaxed);
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ESCRITURA Y LECTURA
+
+		// Escribe 'bytes' bytes al final del segmento en curso y devuelve
+		// en 'ref' dónde están; sin comprimir habrían sido 'sin_comprimir'
+		// bytes. Devuelve false si no se han podido escribir; si ni
+		// siquiera se puede crear el fichero, el almacén se desactiva.
+		bool sellar(const char *datos, std::size_t bytes, std::size_t sin_comprimir, RefBloqueFrio &ref) {
+			std::lock_guard<std::mutex> bloqueo(cerrojo);
+			bool correcto = activo();
+			if (correcto && (actual == nullptr || actual->tamanyo() + bytes > TAM_FICHERO_FRIO)) {
+				actual = crear_fichero();
+				if (actual == nullptr) {
+					activado.store(false, std::memory_order_release);
+					correcto = false;
+				}
+			}
+			if (correcto) {
+				correcto = actual->anyadir(datos, bytes, ref.posicion);
+				ref.fichero = actual;
+				ref.bytes = std::uint32_t(bytes);
+			}
+			if (correcto) {
+				num_bytes_sellados += bytes;
+				num_bytes_sin_comprimir += sin_comprimir;
+			}
+			else {
+				num_errores++;
+			}
+			return correcto;
+		}
+
+		// Anota que un bloque leído no tiene datos válidos (por ejemplo, no
+		// se puede descomprimir o no coincide su suma de control)
+		void anotar_bloque_invalido() {
+			std::lock_guard<std::mutex> bloqueo(cerrojo);
+			num_errores++;
+		}
+
+		// Anota que se han descomprimido 'bytes' bytes en 'ns' nanosegundos
+		void anotar_descompresion(std::size_t bytes, unsigned long long ns) {
+			num_bytes_descomprimidos.fetch_add(bytes, std::memory_order_relaxed);
+			num_ns_descompresion.fetch_add(ns, std::memory_order_relaxed);
+		}
+
+		// Devuelve los bytes del bloque 'ref', de la caché o leyéndolos del
+		// fichero (y guardándolos en la caché). Si no se pueden leer,
+		// devuelve nullptr.
+		std::shared_ptr<const Bytes> leer(const RefBloqueFrio &ref) {
+			std::uint64_t clave = (std::uint64_t(ref.fichero->numero()) << 40) | ref.posicion;
+			std::shared_ptr<const Bytes> bloque = buscar(clave);
+			if (bloque == nullptr) {
+				// Se lee sin el cerrojo, para no parar a los demás lectores
+				std::shared_ptr<Bytes> leido = std::make_shared<Bytes>(ref.bytes);
+				bool correcto = ref.fichero->leer(ref.posicion, leido->data(), leido->size());
+				std::lock_guard<std::mutex> bloqueo(cerrojo);
+				if (correcto) {
+					num_lecturas++;
+					bloque = guardar(clave, leido);
+				}
+				else {
+					num_errores++;
+				}
+			}
+			return bloque;
+		}
+
+	private:
+		AlmacenFrio() : cerrojo(), activado(false), min_en_memoria(1), compresion(false), dir(), actual(),
+			num_ficheros(0), max_bytes(0), bytes_cache(0), recientes(), posiciones(), num_lecturas(0), num_aciertos(0),
+			num_errores(0), num_bytes_sellados(0), num_bytes_sin_comprimir(0), num_bytes_descomprimidos(0),
+			num_ns_descompresion(0) {}
+		AlmacenFrio(const AlmacenFrio &);
+		AlmacenFrio & operator=(const AlmacenFrio &);
+
+		// Bloque en la caché
+		struct EntradaCache {
+			std::uint64_t clave;
+			std::shared_ptr<const Bytes> bytes;
+		};
+		typedef std::list <EntradaCache> ListaCache;
+
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		mutable std::mutex cerrojo;
+		// Configuración (se consulta sin el cerrojo en cada tweet nuevo)
+		std::atomic <bool> activado;
+		std::atomic <unsigned> min_en_memoria;
+		std::atomic <bool> compresion;
+		// Directorio de los segmentos, segmento en curso y número de
+		// ficheros creados
+		std::string dir;
+		std::shared_ptr<FicheroFrio> actual;
+		unsigned num_ficheros;
+		// Caché LRU: bloques del más al menos reciente y posición de cada
+		// uno en la lista, por clave (número de fichero y posición)
+		std::size_t max_bytes, bytes_cache;
+		ListaCache recientes;
+		std::unordered_map <std::uint64_t, ListaCache::iterator> posiciones;
+		// Estadísticas (las de descompresión se anotan sin el cerrojo)
+		unsigned long long num_lecturas, num_aciertos, num_errores;
+		unsigned long long num_bytes_sellados, num_bytes_sin_comprimir;
+		std::atomic <unsigned long long> num_bytes_descomprimidos, num_ns_descompresion;
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS
+		//
+		// Crea un fichero de segmento con un nombre que no exista en el
+		// directorio (nullptr si no se puede)
+		std::shared_ptr<FicheroFrio> crear_fichero() {
+			std::shared_ptr<FicheroFrio> fichero;
+			for (unsigned i = 0; i < MAX_INTENTOS_FICHERO_FRIO && fichero == nullptr; i++) {
+				unsigned numero = num_ficheros++;
+				std::shared_ptr<FicheroFrio> nuevo = std::make_shared<FicheroFrio>(
+					dir + "/tweets_frios_" + std::to_string(numero) + ".seg", numero);
+				if (nuevo->abierto()) {
+					fichero = nuevo;
+				}
+			}
+			return fichero;
+		}
+
+		// Busca un bloque en la caché y lo pasa a ser el más reciente
+		std::shared_ptr<const Bytes> buscar(std::uint64_t clave) {
+			std::lock_guard<std::mutex> bloqueo(cerrojo);
+			std::shared_ptr<const Bytes> bloque;
+			std::unordered_map<std::uint64_t, ListaCache::iterator>::iterator it = posiciones.find(clave);
+			if (it != posiciones.end()) {
+				recientes.splice(recientes.begin(), recientes, it->second);
+				bloque = it->second->bytes;
+				num_aciertos++;
+			}
+			return bloque;
+		}
+
+		// Guarda un bloque leído en la caché como el más reciente y lo
+		// devuelve (el que ya estaba, si otro hilo lo ha leído a la vez)
+		// PRECONDICIÓN: se tiene el cerrojo
+		std::shared_ptr<const Bytes> guardar(std::uint64_t clave, const std::shared_ptr<const Bytes> &bloque) {
+			std::shared_ptr<const Bytes> guardado = bloque;
+			std::unordered_map<std::uint64_t, ListaCache::iterator>::iterator it = posiciones.find(clave);
+			if (it != posiciones.end()) {
+				guardado = it->second->bytes;
+			}
+			else if (bloque->size() <= max_bytes) {
+				EntradaCache entrada;
+				entrada.clave = clave;
+				entrada.bytes = bloque;
+				recientes.push_front(entrada);
+				posiciones.emplace(clave, recientes.begin());
+				bytes_cache += bloque->size();
+				descartar_sobrantes();
+			}
+			return guardado;
+		}
+
+		// Descarta los bloques menos recientes hasta no pasar de max_bytes
+		// PRECONDICIÓN: se tiene el cerrojo
+		void descartar_sobrantes() {
+			while (bytes_cache > max_bytes) {
+				bytes_cache -= recientes.back().bytes->size();
+				posiciones.erase(recientes.back().clave);
+				recientes.pop_back();
+			}
+		}
+	};
+}
+#endif
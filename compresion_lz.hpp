@@ -0,0 +1,295 @@
+/****************************************************************************
+* Compresión LZ con diccionario
+*
+* Compresor de bloques pequeños (unos pocos KiB) del estilo de LZ4, sin
+* dependencias externas, para los bloques de tweets sellados en disco
+* (ver ListaTweets). Un bloque comprimido es una serie de secuencias
+*
+*   token | [longitud literales] | literales | distancia | [longitud copia]
+*
+* donde el token lleva en los 4 bits altos el número de literales y en los
+* 4 bajos la longitud de la copia menos MIN_COPIA_LZ; si un campo vale 15,
+* le siguen bytes que se suman a él (255 significa que sigue otro). La
+* copia repite los bytes que empiezan 'distancia' (2 bytes, de menor a
+* mayor peso) bytes antes. La última secuencia solo tiene literales.
+*
+* Como en un bloque pequeño hay pocas repeticiones, las copias pueden
+* referirse también a un diccionario que se coloca (virtualmente) delante
+* del bloque: texto frecuente en los datos, como los @usuarios y las
+* palabras que más se repiten. entrenar_diccionario lo obtiene de una
+* muestra de los propios datos.
+****************************************************************************/
+
+#ifndef __COMPRESION__LZ__
+#define __COMPRESION__LZ__
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace {
+	const std::size_t MIN_COPIA_LZ = 4; // Longitud mínima de una copia
+	const std::size_t MAX_DISTANCIA_LZ = 0xFFFF; // Distancia máxima de una copia
+	const unsigned BITS_HASH_LZ = 12; // Bits de la tabla de posiciones del compresor
+	const std::size_t MIN_PALABRA_DICCIONARIO = 3; // Longitud mínima de una palabra del diccionario
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// FUNCIONES AUXILIARES
+
+	// Posición en la tabla del compresor de los 4 bytes que empiezan en 'p'
+	inline std::uint32_t hash_lz(const char *p) {
+		std::uint32_t cuatro;
+		std::memcpy(&cuatro, p, 4);
+		return (cuatro * 2654435761u) >> (32 - BITS_HASH_LZ);
+	}
+
+	// Añade una longitud que no cabe en su mitad del token (la parte que
+	// pasa de 15)
+	inline void escribir_longitud_lz(std::size_t resto, std::vector<char> &salida) {
+		while (resto >= 255) {
+			salida.push_back(char(255));
+			resto -= 255;
+		}
+		salida.push_back(char(resto));
+	}
+
+	// Lee la parte de una longitud que sigue al token. Devuelve false si
+	// los datos se acaban antes.
+	inline bool leer_longitud_lz(const unsigned char *&p, const unsigned char *fin, std::size_t &longitud) {
+		bool correcto = true, sigue = true;
+		while (sigue && correcto) {
+			correcto = p < fin;
+			if (correcto) {
+				longitud += *p;
+				sigue = (*p == 255);
+				p++;
+			}
+		}
+		return correcto;
+	}
+
+	// Añade una secuencia: 'num_literales' literales desde 'literales' y
+	// una copia de 'longitud_copia' bytes a 'distancia' (ninguna si
+	// 'longitud_copia' es 0)
+	inline void escribir_secuencia_lz(const char *literales, std::size_t num_literales, std::size_t distancia,
+		std::size_t longitud_copia, std::vector<char> &salida) {
+		std::size_t codigo_copia = (longitud_copia > 0) ? longitud_copia - MIN_COPIA_LZ : 0;
+		salida.push_back(char((std::min<std::size_t>(num_literales, 15) << 4) | std::min<std::size_t>(codigo_copia, 15)));
+		if (num_literales >= 15) {
+			escribir_longitud_lz(num_literales - 15, salida);
+		}
+		salida.insert(salida.end(), literales, literales + num_literales);
+		if (longitud_copia > 0) {
+			salida.push_back(char(distancia & 0xFF));
+			salida.push_back(char(distancia >> 8));
+			if (codigo_copia >= 15) {
+				escribir_longitud_lz(codigo_copia - 15, salida);
+			}
+		}
+	}
+
+	//---------------------------------------------------------------------------
+	// FUNCIONES DE COMPRESIÓN
+
+	// Añade al final de 'salida' los 'num' bytes de 'datos' comprimidos con
+	// el diccionario 'diccionario' (que puede estar vacío). Para cada
+	// posición se busca una copia con la última posición anterior que
+	// empezaba por los mismos 4 bytes (tabla de 2^BITS_HASH_LZ posiciones),
+	// y se toma si la hay.
+	inline void comprimir_lz(const char *datos, std::size_t num, std::string_view diccionario, std::vector<char> &salida) {
+		// El diccionario y los datos seguidos, para buscar copias en ambos
+		std::vector <char> historia(diccionario.size() + num);
+		std::copy(diccionario.begin(), diccionario.end(), historia.begin());
+		std::copy(datos, datos + num, historia.begin() + std::ptrdiff_t(diccionario.size()));
+		const char *base = historia.data();
+		std::size_t fin = historia.size();
+		std::vector <std::int32_t> ultima(std::size_t(1) << BITS_HASH_LZ, -1);
+		// En el peor caso, todo literales: un token y una longitud cada 255
+		salida.reserve(salida.size() + num + num / 255 + 2);
+		for (std::size_t i = 0; i + 4 <= diccionario.size(); i++) {
+			ultima[hash_lz(base + i)] = std::int32_t(i);
+		}
+		std::size_t i = diccionario.size(), inicio_literales = i;
+		while (i + MIN_COPIA_LZ <= fin) {
+			std::uint32_t h = hash_lz(base + i);
+			std::int32_t candidata = ultima[h];
+			ultima[h] = std::int32_t(i);
+			std::size_t longitud = 0;
+			if (candidata >= 0 && i - std::size_t(candidata) <= MAX_DISTANCIA_LZ &&
+				std::memcmp(base + candidata, base + i, MIN_COPIA_LZ) == 0) {
+				longitud = MIN_COPIA_LZ;
+				while (i + longitud < fin && base[candidata + longitud] == base[i + longitud]) {
+					longitud++;
+				}
+			}
+			if (longitud > 0) {
+				escribir_secuencia_lz(base + inicio_literales, i - inicio_literales, i - std::size_t(candidata),
+					longitud, salida);
+				// Las posiciones de dentro de la copia también se anotan
+				for (std::size_t j = i + 1; j < i + longitud && j + 4 <= fin; j++) {
+					ultima[hash_lz(base + j)] = std::int32_t(j);
+				}
+				i += longitud;
+				inicio_literales = i;
+			}
+			else {
+				i++;
+			}
+		}
+		escribir_secuencia_lz(base + inicio_literales, fin - inicio_literales, 0, 0, salida);
+	}
+
+	// Descomprime en salida[0, num_salida) los 'num' bytes comprimidos de
+	// 'datos', con el mismo diccionario con que se comprimieron. Devuelve
+	// false si los datos no son válidos o no ocupan exactamente
+	// 'num_salida' bytes al descomprimirlos.
+	inline bool descomprimir_lz(const char *datos, std::size_t num, std::string_view diccionario, char *salida,
+		std::size_t num_salida) {
+		const unsigned char *p = reinterpret_cast<const unsigned char *>(datos), *fin = p + num;
+		std::size_t escritos = 0;
+		bool correcto = true, terminado = false;
+		while (correcto && !terminado) {
+			correcto = p < fin;
+			std::size_t num_literales = 0, longitud = 0;
+			if (correcto) {
+				num_literales = *p >> 4;
+				longitud = *p & 0xF;
+				p++;
+				if (num_literales == 15) {
+					correcto = leer_longitud_lz(p, fin, num_literales);
+				}
+			}
+			if (correcto) {
+				correcto = std::size_t(fin - p) >= num_literales && num_salida - escritos >= num_literales;
+			}
+			if (correcto) {
+				// Los tramos cortos se copian de 16 en 16 bytes si hay sitio
+				// (lo que sobra se sobrescribe después)
+				if (num_literales <= 16 && fin - p >= 16 && num_salida - escritos >= 16) {
+					std::memcpy(salida + escritos, p, 16);
+				}
+				else {
+					std::copy(p, p + num_literales, salida + escritos);
+				}
+				p += num_literales;
+				escritos += num_literales;
+				terminado = (p == fin);
+			}
+			if (correcto && !terminado) {
+				std::size_t distancia = 0;
+				correcto = fin - p >= 2;
+				if (correcto) {
+					distancia = std::size_t(p[0]) | (std::size_t(p[1]) << 8);
+					p += 2;
+					if (longitud == 15) {
+						correcto = leer_longitud_lz(p, fin, longitud);
+					}
+					longitud += MIN_COPIA_LZ;
+				}
+				correcto = correcto && distancia > 0 && distancia <= escritos + diccionario.size() &&
+					num_salida - escritos >= longitud;
+				if (correcto) {
+					char *destino = salida + escritos;
+					if (distancia <= escritos && distancia >= 16 && longitud <= 16 && num_salida - escritos >= 16) {
+						std::memcpy(destino, destino - distancia, 16);
+					}
+					else {
+						// Parte de la copia que está en el diccionario
+						std::size_t j = 0;
+						if (distancia > escritos) {
+							std::size_t desde = diccionario.size() - (distancia - escritos);
+							j = std::min(longitud, distancia - escritos);
+							std::copy(diccionario.data() + desde, diccionario.data() + desde + j, destino);
+						}
+						// El resto, de byte en byte si se solapa con lo que se copia
+						if (j < longitud && distancia >= longitud) {
+							std::memcpy(destino + j, salida + escritos + j - distancia, longitud - j);
+						}
+						else {
+							for (; j < longitud; j++) {
+								destino[j] = salida[escritos + j - distancia];
+							}
+						}
+					}
+					escritos += longitud;
+				}
+			}
+		}
+		return correcto && escritos == num_salida;
+	}
+
+	// Suma de control de 32 bits de 'num' bytes, para comprobar que un
+	// bloque descomprimido es el que se comprimió (un bloque dañado o
+	// descomprimido con otro diccionario puede dar datos de la longitud
+	// correcta). Se procesa de 8 en 8 bytes.
+	inline std::uint32_t suma_control_lz(const char *datos, std::size_t num) {
+		std::uint64_t h = 0x9E3779B97F4A7C15ULL ^ num;
+		std::size_t i = 0;
+		for (; i + 8 <= num; i += 8) {
+			std::uint64_t palabra;
+			std::memcpy(&palabra, datos + i, 8);
+			h = (h ^ palabra) * 0xFF51AFD7ED558CCDULL;
+			h ^= h >> 29;
+		}
+		for (; i < num; i++) {
+			h = (h ^ static_cast<unsigned char>(datos[i])) * 0x100000001B3ULL;
+		}
+		h ^= h >> 32;
+		return std::uint32_t(h);
+	}
+
+	//---------------------------------------------------------------------------
+	// ENTRENAMIENTO DEL DICCIONARIO
+
+	// Devuelve en 'diccionario' (de como mucho 'max_bytes' bytes) las
+	// palabras de 'muestras' que más bytes ahorrarían como copias: las de
+	// al menos MIN_PALABRA_DICCIONARIO caracteres, separadas por espacios,
+	// que más se repiten, cada una seguida de un espacio. Las más valiosas
+	// quedan al final, más cerca de los datos.
+	inline void entrenar_diccionario(const std::vector<std::string_view> &muestras, std::size_t max_bytes,
+		std::string &diccionario) {
+		std::unordered_map <std::string_view, unsigned> apariciones;
+		for (std::size_t m = 0; m < muestras.size(); m++) {
+			std::string_view texto = muestras[m];
+			std::size_t pos = 0;
+			while (pos < texto.size()) {
+				std::size_t fin = std::min(texto.find(' ', pos), texto.size());
+				if (fin - pos >= MIN_PALABRA_DICCIONARIO) {
+					apariciones[texto.substr(pos, fin - pos)]++;
+				}
+				pos = fin + 1;
+			}
+		}
+		// Ahorro aproximado: la palabra y su espacio en cada aparición
+		// menos la primera
+		std::vector<std::pair<std::size_t, std::string_view>> valor;
+		for (std::unordered_map<std::string_view, unsigned>::const_iterator it = apariciones.begin();
+			it != apariciones.end(); ++it) {
+			if (it->second > 1) {
+				valor.push_back(std::make_pair(std::size_t(it->second - 1) * (it->first.size() + 1), it->first));
+			}
+		}
+		std::sort(valor.begin(), valor.end(), [](const std::pair<std::size_t, std::string_view> &a,
+			const std::pair<std::size_t, std::string_view> &b) {
+			return a.first > b.first || (a.first == b.first && a.second < b.second);
+		});
+		std::size_t num = 0, bytes = 0;
+		while (num < valor.size() && bytes + valor[num].second.size() + 1 <= max_bytes) {
+			bytes += valor[num].second.size() + 1;
+			num++;
+		}
+		diccionario.clear();
+		diccionario.reserve(bytes);
+		for (std::size_t i = num; i > 0; i--) {
+			diccionario.append(valor[i - 1].second.data(), valor[i - 1].second.size());
+			diccionario.push_back(' ');
+		}
+	}
+}
+#endif
@@ -0,0 +1,224 @@
+/****************************************************************************
+* Operaciones de conjuntos sobre listas de usuarios
+*
+* Intersección y diferencia de dos listas de identificadores ordenadas de
+* menor a mayor y sin repetidos (las listas de seguidores y seguidos),
+* para consultas como los seguidores mutuos de un usuario o los
+* seguidores comunes de dos usuarios.
+*
+* Si una lista es mucho más larga que la otra (MIN_PROPORCION_GALOPE
+* veces), cada elemento de la corta se busca en la larga con búsqueda
+* con galope a partir de la posición del anterior: O(c log(l / c)). Si
+* no, se recorren las dos a la vez: con instrucciones SSE2, cuando están
+* disponibles, se comparan bloques de 4 identificadores de cada lista
+* todos contra todos (16 comparaciones en 4 instrucciones) y se avanza
+* el bloque con el mayor identificador más pequeño.
+****************************************************************************/
+
+#ifndef __CONJUNTOS__USUARIOS__
+#define __CONJUNTOS__USUARIOS__
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "tabla_simbolos.hpp"
+
+namespace {
+	const std::size_t MIN_PROPORCION_GALOPE = 32; // Proporción entre las longitudes a partir de la que se busca con galope
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// FUNCIONES AUXILIARES
+
+	// Devuelve la primera posición de lista[desde, num) con un
+	// identificador mayor o igual que 'usuario', o 'num' si no la hay.
+	// Búsqueda con galope: avanza 1, 2, 4... posiciones y hace una
+	// búsqueda binaria en el último salto, O(log d) para una distancia d.
+	inline std::size_t galopar(const IdUsuario *lista, std::size_t num, std::size_t desde, IdUsuario usuario) {
+		std::size_t paso = 1;
+		while (desde + paso < num && lista[desde + paso] < usuario) {
+			desde += paso;
+			paso *= 2;
+		}
+		return std::size_t(std::lower_bound(lista + desde, lista + std::min(desde + paso, num), usuario) - lista);
+	}
+
+#if defined(__GNUC__) && defined(__SSE2__)
+	// Devuelve una máscara de 4 bits con los identificadores de a[0, 4)
+	// que están en b[0, 4)
+	inline unsigned comparar_bloques(const IdUsuario *a, const IdUsuario *b) {
+		__m128i bloque_a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+		__m128i bloque_b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+		// b comparado con a en sus cuatro rotaciones
+		__m128i iguales = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi32(bloque_a, bloque_b),
+				_mm_cmpeq_epi32(bloque_a, _mm_shuffle_epi32(bloque_b, _MM_SHUFFLE(0, 3, 2, 1)))),
+			_mm_or_si128(_mm_cmpeq_epi32(bloque_a, _mm_shuffle_epi32(bloque_b, _MM_SHUFFLE(1, 0, 3, 2))),
+				_mm_cmpeq_epi32(bloque_a, _mm_shuffle_epi32(bloque_b, _MM_SHUFFLE(2, 1, 0, 3)))));
+		return unsigned(_mm_movemask_ps(_mm_castsi128_ps(iguales)));
+	}
+#endif
+
+	// Escribe en 'salida' (si no es nulo) los identificadores de
+	// a[0, num_a) que están en b[0, num_b) o, si 'diferencia', los que no
+	// están, de menor a mayor, y devuelve cuántos son. Recorre las dos
+	// listas a la vez.
+	// PRECONDICIÓN: 'salida' tiene sitio para num_a identificadores
+	inline std::size_t fusionar_listas(const IdUsuario *a, std::size_t num_a, const IdUsuario *b, std::size_t num_b,
+		bool diferencia, IdUsuario *salida) {
+		std::size_t i = 0, j = 0, num = 0;
+		// Identificadores del bloque de 'a' en curso (el que empieza en
+		// 'i') encontrados en bloques de 'b' ya pasados
+		unsigned encontrados = 0;
+#if defined(__GNUC__) && defined(__SSE2__)
+		// Qué bloque avanza depende de los datos y no se predice bien, así
+		// que el bucle no tiene saltos condicionales: si el bloque de 'a'
+		// no ha terminado, se escribe con máscara vacía (y se sobrescribe
+		// después)
+		while (i + 4 <= num_a && j + 4 <= num_b) {
+			encontrados |= comparar_bloques(a + i, b + j);
+			IdUsuario max_a = a[i + 3], max_b = b[j + 3];
+			// El bloque de 'a' ya no puede coincidir con los siguientes de 'b'
+			bool termina_a = max_a <= max_b;
+			unsigned mascara = termina_a ? (diferencia ? ~encontrados & 0xF : encontrados) : 0;
+			if (salida != nullptr) {
+				for (unsigned k = 0; k < 4; k++) {
+					salida[num] = a[i + k];
+					num += (mascara >> k) & 1;
+				}
+			}
+			else {
+				num += unsigned(__builtin_popcount(mascara));
+			}
+			encontrados = termina_a ? 0 : encontrados;
+			i += termina_a ? 4 : 0;
+			j += (max_b <= max_a) ? 4 : 0;
+		}
+#endif
+		// Resto, de uno en uno
+		for (std::size_t inicio_bloque = i; i < num_a; i++) {
+			bool en_b = i - inicio_bloque < 4 && ((encontrados >> (i - inicio_bloque)) & 1) != 0;
+			if (!en_b) {
+				while (j < num_b && b[j] < a[i]) {
+					j++;
+				}
+				en_b = j < num_b && b[j] == a[i];
+			}
+			if (en_b != diferencia) {
+				if (salida != nullptr) {
+					salida[num] = a[i];
+				}
+				num++;
+			}
+		}
+		return num;
+	}
+
+	// Como fusionar_listas, pero buscando con galope cada identificador
+	// de la lista más corta en la más larga
+	inline std::size_t galopar_listas(const IdUsuario *a, std::size_t num_a, const IdUsuario *b, std::size_t num_b,
+		bool diferencia, IdUsuario *salida) {
+		std::size_t num = 0;
+		if (num_a <= num_b) {
+			// Cada identificador de 'a' se busca en 'b'
+			std::size_t j = 0;
+			for (std::size_t i = 0; i < num_a; i++) {
+				j = galopar(b, num_b, j, a[i]);
+				if ((j < num_b && b[j] == a[i]) != diferencia) {
+					if (salida != nullptr) {
+						salida[num] = a[i];
+					}
+					num++;
+				}
+			}
+		}
+		else {
+			// Cada identificador de 'b' se busca en 'a'; en una diferencia,
+			// los tramos de 'a' entre dos de ellos se copian enteros
+			std::size_t i = 0;
+			for (std::size_t j = 0; j < num_b && i < num_a; j++) {
+				std::size_t pos = galopar(a, num_a, i, b[j]);
+				if (diferencia) {
+					if (salida != nullptr) {
+						std::copy(a + i, a + pos, salida + num);
+					}
+					num += pos - i;
+				}
+				i = pos;
+				if (i < num_a && a[i] == b[j]) {
+					if (!diferencia) {
+						if (salida != nullptr) {
+							salida[num] = a[i];
+						}
+						num++;
+					}
+					i++;
+				}
+			}
+			if (diferencia) {
+				if (salida != nullptr) {
+					std::copy(a + i, a + num_a, salida + num);
+				}
+				num += num_a - i;
+			}
+		}
+		return num;
+	}
+
+	// Elige entre fusionar_listas y galopar_listas según la proporción
+	// entre las longitudes de las listas
+	inline std::size_t operar_listas(const IdUsuario *a, std::size_t num_a, const IdUsuario *b, std::size_t num_b,
+		bool diferencia, IdUsuario *salida) {
+		if (num_a * MIN_PROPORCION_GALOPE < num_b || num_b * MIN_PROPORCION_GALOPE < num_a) {
+			return galopar_listas(a, num_a, b, num_b, diferencia, salida);
+		}
+		return fusionar_listas(a, num_a, b, num_b, diferencia, salida);
+	}
+
+	//---------------------------------------------------------------------------
+	// FUNCIONES DE CONJUNTOS
+
+	// Devuelve en 'resultado' los identificadores que están en a[0, num_a)
+	// y en b[0, num_b), ordenados de menor a mayor
+	// PRECONDICIÓN: las dos listas están ordenadas y sin repetidos
+	inline void interseccion_usuarios(const IdUsuario *a, std::size_t num_a, const IdUsuario *b, std::size_t num_b,
+		std::vector<IdUsuario> &resultado) {
+		// La intersección es simétrica: se recorre la lista más corta
+		if (num_a > num_b) {
+			std::swap(a, b);
+			std::swap(num_a, num_b);
+		}
+		resultado.resize(num_a);
+		resultado.resize(operar_listas(a, num_a, b, num_b, false, resultado.data()));
+	}
+
+	// Devuelve cuántos identificadores están en a[0, num_a) y en
+	// b[0, num_b)
+	// PRECONDICIÓN: las dos listas están ordenadas y sin repetidos
+	inline std::size_t num_interseccion_usuarios(const IdUsuario *a, std::size_t num_a, const IdUsuario *b,
+		std::size_t num_b) {
+		return (num_a <= num_b) ? operar_listas(a, num_a, b, num_b, false, nullptr)
+			: operar_listas(b, num_b, a, num_a, false, nullptr);
+	}
+
+	// Devuelve en 'resultado' los identificadores que están en a[0, num_a)
+	// y no en b[0, num_b), ordenados de menor a mayor
+	// PRECONDICIÓN: las dos listas están ordenadas y sin repetidos
+	inline void diferencia_usuarios(const IdUsuario *a, std::size_t num_a, const IdUsuario *b, std::size_t num_b,
+		std::vector<IdUsuario> &resultado) {
+		resultado.resize(num_a);
+		resultado.resize(operar_listas(a, num_a, b, num_b, true, resultado.data()));
+	}
+
+	// Devuelve cuántos identificadores están en a[0, num_a) y no en
+	// b[0, num_b)
+	// PRECONDICIÓN: las dos listas están ordenadas y sin repetidos
+	inline std::size_t num_diferencia_usuarios(const IdUsuario *a, std::size_t num_a, const IdUsuario *b,
+		std::size_t num_b) {
+		return operar_listas(a, num_a, b, num_b, true, nullptr);
+	}
+}
+#endif
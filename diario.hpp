@@ -0,0 +1,480 @@
+/****************************************************************************
+* Clase DiarioOperaciones
+*
+* Diario (write-ahead log) de las operaciones que modifican la red social:
+* cada operación se añade al final del fichero en cuanto se realiza, en
+* lugar de reescribir todos los datos en cada guardado. Junto con una
+* instantánea (ver InstantaneaRed), permite reconstruir la red: se carga
+* la instantánea y se repiten encima las operaciones del diario.
+*
+* Formato (enteros de menor a mayor peso): una cabecera (marca de formato,
+* versión y número de generación) seguida de registros
+*
+*   longitud (4 bytes) | tipo (1 byte) | datos | suma de control (4 bytes)
+*
+* donde 'longitud' es la de los datos, las cadenas van precedidas de su
+* longitud (4 bytes) y la suma de control (FNV-1a) cubre el tipo y los
+* datos. Un registro incompleto o con la suma incorrecta (por ejemplo, por
+* una caída a mitad de escritura) marca el final del diario.
+*
+* La generación del diario se incrementa cada vez que se vuelca en una
+* instantánea, que guarda la última generación que contiene; al recuperar,
+* solo se repite el diario si es posterior a la instantánea.
+*
+* Escrituras agrupadas (group commit): los registros se acumulan en memoria
+* y se escriben y sincronizan con el disco (fsync) juntos cuando hay
+* 'ops_por_sincronizacion' pendientes o cuando el más antiguo lleva
+* 'ms_por_sincronizacion' milisegundos esperando. El tiempo solo se
+* comprueba al añadir una operación o al llamar a
+* comprobar_sincronizacion(): un programa que puede dejar de escribir
+* tras una ráfaga debe llamar a este último periódicamente (por ejemplo,
+* desde su bucle principal) para que las últimas operaciones no queden
+* pendientes indefinidamente. Las operaciones no sincronizadas se pueden
+* perder si el sistema cae.
+*
+* Si una escritura o la sincronización fallan (por ejemplo, por falta de
+* espacio), el fichero se recorta hasta el final de la última
+* sincronización correcta, para no dejar un registro a medias delante de
+* los siguientes, y las operaciones siguen pendientes: se vuelven a
+* intentar en la siguiente sincronización.
+****************************************************************************/
+
+#ifndef __DIARIO__
+#define __DIARIO__
+#include <string>
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define __DIARIO_POSIX__
+#endif
+#include "usuario_twitter.hpp"
+
+namespace {
+	const char MAGIA_DIARIO[8] = { 'B', 'B', 'L', 'T', 'W', 'L', 'O', 'G' }; // Identifica el formato
+	const std::uint32_t VERSION_DIARIO = 1; // Versión del formato
+	const std::size_t TAM_CABECERA_DIARIO = 16; // Magia, versión y generación
+	const std::uint32_t MAX_DATOS_REGISTRO = 1 << 20; // Longitud máxima de los datos de un registro
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Operaciones que se guardan en el diario
+	enum TipoOperacion {
+		OP_NUEVO_USUARIO = 1,
+		OP_SEGUIR = 2,
+		OP_DEJAR_DE_SEGUIR = 3,
+		OP_NUEVO_TWEET = 4
+	};
+	// Operación leída del diario. Los usuarios se guardan por nombre, ya
+	// que los IdUsuario dependen del proceso. 'otro' es el usuario seguido
+	// (OP_SEGUIR, OP_DEJAR_DE_SEGUIR); 'marca_tiempo' y 'texto', los del
+	// tweet (OP_NUEVO_TWEET).
+	struct OperacionDiario {
+		TipoOperacion tipo;
+		std::string usuario, otro;
+		MarcaTiempo marca_tiempo;
+		std::string texto;
+	};
+
+	//---------------------------------------------------------------------------
+	class DiarioOperaciones {
+	public:
+		// Constructor por defecto: diario cerrado; se sincroniza cada
+		// operación
+		DiarioOperaciones() : fd(-1), fic(), fin_sincronizado(0), pendientes(), num_pendientes(0), primera_pendiente(),
+			ops_por_sincronizacion(1), ms_por_sincronizacion(0), num_sincronizaciones(0) {}
+		// Destructor: escribe y sincroniza lo pendiente y cierra el diario
+		~DiarioOperaciones() {
+			cerrar();
+		}
+		// No se permite copiar (escribirían en el mismo fichero)
+		DiarioOperaciones(const DiarioOperaciones &) = delete;
+		DiarioOperaciones & operator=(const DiarioOperaciones &) = delete;
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+
+		// Indica si el diario está abierto para escribir
+		bool abierto() const {
+#if defined(__DIARIO_POSIX__)
+			return fd >= 0;
+#else
+			return fic.is_open();
+#endif
+		}
+
+		// Devuelve el número de operaciones aún no sincronizadas
+		unsigned operaciones_pendientes() const {
+			return num_pendientes;
+		}
+
+		// Devuelve cuántas veces se ha sincronizado con el disco
+		unsigned long long sincronizaciones() const {
+			return num_sincronizaciones;
+		}
+
+		// Lee el diario 'nom_fic' y llama a 'funcion(operacion)' por cada
+		// operación, en orden. Devuelve a través de 'generacion' la del
+		// diario y a través de 'fin_valido' la posición que sigue al último
+		// registro correcto, y 'OK' a través de 'res'. Si el fichero no
+		// existe o su cabecera no es válida, se devuelve 'FIC_ERROR'.
+		template <typename Funcion>
+		static void leer(const std::string &nom_fic, std::uint32_t &generacion, std::uint64_t &fin_valido,
+			Resultado &res, Funcion funcion) {
+			std::ifstream entrada(nom_fic, std::ios::binary);
+			std::vector <char> contenido((std::istreambuf_iterator<char>(entrada)), std::istreambuf_iterator<char>());
+			res = (entrada && cabecera_valida(contenido, generacion)) ? OK : FIC_ERROR;
+			fin_valido = 0;
+			if (res == OK) {
+				std::size_t pos = TAM_CABECERA_DIARIO;
+				OperacionDiario operacion;
+				while (leer_registro(contenido, pos, operacion)) {
+					funcion(operacion);
+				}
+				fin_valido = pos;
+			}
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE APERTURA Y CIERRE
+
+		// Crea (o vacía) el diario 'nom_fic' con la generación indicada y
+		// lo deja abierto para escribir; se devuelve 'OK' o 'FIC_ERROR' a
+		// través de 'res'
+		void crear(const std::string &nom_fic, std::uint32_t generacion, Resultado &res) {
+			char cabecera[TAM_CABECERA_DIARIO];
+			std::memcpy(cabecera, MAGIA_DIARIO, sizeof(MAGIA_DIARIO));
+			for (unsigned i = 0; i < 4; i++) {
+				cabecera[8 + i] = char(VERSION_DIARIO >> (8 * i));
+				cabecera[12 + i] = char(generacion >> (8 * i));
+			}
+			cerrar();
+			res = FIC_ERROR;
+#if defined(__DIARIO_POSIX__)
+			fd = ::open(nom_fic.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+			if (fd >= 0 && escribir_todo(cabecera, sizeof(cabecera)) && ::fsync(fd) == 0) {
+				res = OK;
+			}
+#else
+			fic.open(nom_fic, std::ios::binary | std::ios::trunc);
+			fic.write(cabecera, sizeof(cabecera));
+			fic.flush();
+			res = fic ? OK : FIC_ERROR;
+#endif
+			fin_sincronizado = sizeof(cabecera);
+			if (res != OK) {
+				cerrar();
+			}
+		}
+
+		// Abre el diario 'nom_fic' para añadir operaciones al final,
+		// descartando lo que haya a partir de 'fin_valido' (un registro
+		// incompleto); se devuelve 'OK' o 'FIC_ERROR' a través de 'res'
+		void abrir(const std::string &nom_fic, std::uint64_t fin_valido, Resultado &res) {
+			cerrar();
+			res = FIC_ERROR;
+#if defined(__DIARIO_POSIX__)
+			fd = ::open(nom_fic.c_str(), O_WRONLY | O_APPEND);
+			if (fd >= 0 && ::ftruncate(fd, off_t(fin_valido)) == 0) {
+				res = OK;
+			}
+#else
+			std::ifstream entrada(nom_fic, std::ios::binary);
+			std::vector <char> contenido((std::istreambuf_iterator<char>(entrada)), std::istreambuf_iterator<char>());
+			if (entrada && fin_valido <= contenido.size()) {
+				fic.open(nom_fic, std::ios::binary | std::ios::trunc);
+				fic.write(contenido.data(), std::streamsize(fin_valido));
+				fic.flush();
+				res = fic ? OK : FIC_ERROR;
+			}
+#endif
+			fin_sincronizado = fin_valido;
+			if (res != OK) {
+				cerrar();
+			}
+		}
+
+		// Escribe y sincroniza lo pendiente y cierra el diario. Devuelve
+		// false si lo pendiente no se ha podido sincronizar (y se ha
+		// perdido).
+		bool cerrar() {
+			bool correcto = true;
+			if (abierto()) {
+				correcto = sincronizar();
+			}
+#if defined(__DIARIO_POSIX__)
+			if (fd >= 0) {
+				::close(fd);
+			}
+#endif
+			fd = -1;
+			fic.close();
+			pendientes.clear();
+			num_pendientes = 0;
+			return correcto;
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ACTUALIZACIÓN
+
+		// Configura las escrituras agrupadas: se sincroniza al acumular
+		// 'ops' operaciones (1: cada operación) o cuando la más antigua
+		// lleva 'ms' milisegundos pendiente (0: sin límite de tiempo)
+		void configurar_sincronizacion(unsigned ops, unsigned ms) {
+			ops_por_sincronizacion = (ops > 0) ? ops : 1;
+			ms_por_sincronizacion = ms;
+			comprobar_sincronizacion();
+		}
+
+		// Sincroniza si se ha alcanzado el número de operaciones o el tiempo
+		// de espera configurados (ver configurar_sincronizacion). Devuelve
+		// false si tocaba y no se ha podido (ver sincronizar).
+		bool comprobar_sincronizacion() {
+			bool correcto = true;
+			if (num_pendientes >= ops_por_sincronizacion
+				|| (num_pendientes > 0 && ms_por_sincronizacion > 0
+					&& std::chrono::steady_clock::now() - primera_pendiente >= std::chrono::milliseconds(ms_por_sincronizacion))) {
+				correcto = sincronizar();
+			}
+			return correcto;
+		}
+
+		// Añaden una operación al diario. Devuelven false si al añadirla
+		// tocaba sincronizar y no se ha podido (la operación queda
+		// pendiente, ver sincronizar).
+		// PRECONDICIÓN (todos): abierto()
+		bool nuevo_usuario(const std::string &usuario) {
+			std::size_t inicio = empezar_registro(OP_NUEVO_USUARIO);
+			poner_cadena(usuario);
+			return terminar_registro(inicio);
+		}
+		bool seguir(const std::string &seguidor, const std::string &seguido) {
+			std::size_t inicio = empezar_registro(OP_SEGUIR);
+			poner_cadena(seguidor);
+			poner_cadena(seguido);
+			return terminar_registro(inicio);
+		}
+		bool dejar_de_seguir(const std::string &seguidor, const std::string &seguido) {
+			std::size_t inicio = empezar_registro(OP_DEJAR_DE_SEGUIR);
+			poner_cadena(seguidor);
+			poner_cadena(seguido);
+			return terminar_registro(inicio);
+		}
+		bool nuevo_tweet(const std::string &autor, MarcaTiempo marca_tiempo, const std::string &texto) {
+			std::size_t inicio = empezar_registro(OP_NUEVO_TWEET);
+			poner_cadena(autor);
+			poner_entero(std::uint64_t(marca_tiempo), 8);
+			poner_cadena(texto);
+			return terminar_registro(inicio);
+		}
+
+		// Escribe las operaciones pendientes y las sincroniza con el
+		// disco. Devuelve false si no se ha podido: el fichero se recorta
+		// hasta el final de la última sincronización correcta y las
+		// operaciones siguen pendientes.
+		bool sincronizar() {
+			bool correcto = true;
+			if (!pendientes.empty()) {
+#if defined(__DIARIO_POSIX__)
+				correcto = fd >= 0 && escribir_todo(pendientes.data(), pendientes.size()) && ::fsync(fd) == 0;
+				if (!correcto && fd >= 0) {
+					// Sin el registro a medias; con O_APPEND, el siguiente
+					// intento escribe a partir de aquí
+					if (::ftruncate(fd, off_t(fin_sincronizado)) != 0) {
+						::close(fd);
+						fd = -1;
+					}
+				}
+#else
+				correcto = fic.is_open();
+				if (correcto) {
+					fic.write(pendientes.data(), std::streamsize(pendientes.size()));
+					fic.flush();
+					correcto = bool(fic);
+					if (!correcto) {
+						fic.clear();
+						fic.seekp(std::streamoff(fin_sincronizado));
+					}
+				}
+#endif
+				if (correcto) {
+					fin_sincronizado += pendientes.size();
+					pendientes.clear();
+					num_pendientes = 0;
+					num_sincronizaciones++;
+				}
+			}
+			return correcto;
+		}
+
+	private:
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		// Fichero del diario (descriptor POSIX o, si no hay, flujo) y
+		// tamaño que tenía tras la última sincronización correcta
+		int fd;
+		std::ofstream fic;
+		std::uint64_t fin_sincronizado;
+		// Registros aún no escritos, cuántos son y cuándo se añadió el primero
+		std::vector <char> pendientes;
+		unsigned num_pendientes;
+		std::chrono::steady_clock::time_point primera_pendiente;
+		// Configuración de las escrituras agrupadas
+		unsigned ops_por_sincronizacion, ms_por_sincronizacion;
+		unsigned long long num_sincronizaciones;
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS
+		//
+		// Suma de control FNV-1a de 'longitud' bytes
+		static std::uint32_t suma_control(const char *datos, std::size_t longitud) {
+			std::uint32_t suma = 2166136261u;
+			for (std::size_t i = 0; i < longitud; i++) {
+				suma = (suma ^ static_cast<unsigned char>(datos[i])) * 16777619u;
+			}
+			return suma;
+		}
+
+		// Añade a 'pendientes' un entero de 'bytes' bytes (de menor a mayor
+		// peso) o una cadena precedida de su longitud (4 bytes)
+		void poner_entero(std::uint64_t valor, unsigned bytes) {
+			for (unsigned i = 0; i < bytes; i++) {
+				pendientes.push_back(char(valor >> (8 * i)));
+			}
+		}
+		void poner_cadena(const std::string &cadena) {
+			poner_entero(cadena.size(), 4);
+			pendientes.insert(pendientes.end(), cadena.begin(), cadena.end());
+		}
+
+		// Empieza un registro: deja hueco para la longitud y pone el tipo.
+		// Devuelve la posición del registro en 'pendientes'.
+		std::size_t empezar_registro(TipoOperacion tipo) {
+			std::size_t inicio = pendientes.size();
+			if (num_pendientes == 0) {
+				primera_pendiente = std::chrono::steady_clock::now();
+			}
+			poner_entero(0, 4);
+			poner_entero(unsigned(tipo), 1);
+			return inicio;
+		}
+
+		// Termina el registro que empieza en 'inicio': completa la longitud
+		// y añade la suma de control. Devuelve false si tocaba sincronizar
+		// y no se ha podido.
+		bool terminar_registro(std::size_t inicio) {
+			std::uint32_t longitud = std::uint32_t(pendientes.size() - inicio - 5);
+			for (unsigned i = 0; i < 4; i++) {
+				pendientes[inicio + i] = char(longitud >> (8 * i));
+			}
+			poner_entero(suma_control(pendientes.data() + inicio + 4, longitud + 1), 4);
+			num_pendientes++;
+			return comprobar_sincronizacion();
+		}
+
+#if defined(__DIARIO_POSIX__)
+		// Escribe 'longitud' bytes en el descriptor, aunque write() los
+		// escriba en varias veces
+		bool escribir_todo(const char *datos, std::size_t longitud) {
+			bool correcto = true;
+			while (longitud > 0 && correcto) {
+				ssize_t escritos = ::write(fd, datos, longitud);
+				correcto = escritos > 0;
+				if (correcto) {
+					datos += escritos;
+					longitud -= std::size_t(escritos);
+				}
+			}
+			return correcto;
+		}
+#endif
+
+		// Lee un entero de 'bytes' bytes o una cadena de 'contenido' a
+		// partir de 'pos', si caben antes de 'fin'
+		static bool leer_entero(const std::vector <char> &contenido, std::size_t &pos, std::size_t fin,
+			unsigned bytes, std::uint64_t &valor) {
+			bool cabe = bytes <= fin - pos;
+			valor = 0;
+			for (unsigned i = 0; i < bytes && cabe; i++) {
+				valor |= std::uint64_t(static_cast<unsigned char>(contenido[pos + i])) << (8 * i);
+			}
+			pos += cabe ? bytes : 0;
+			return cabe;
+		}
+		static bool leer_cadena(const std::vector <char> &contenido, std::size_t &pos, std::size_t fin, std::string &cadena) {
+			std::uint64_t longitud;
+			bool correcto = leer_entero(contenido, pos, fin, 4, longitud) && longitud <= fin - pos;
+			if (correcto) {
+				cadena.assign(contenido.data() + pos, std::size_t(longitud));
+				pos += std::size_t(longitud);
+			}
+			return correcto;
+		}
+
+		// Comprueba la cabecera y devuelve la generación del diario
+		static bool cabecera_valida(const std::vector <char> &contenido, std::uint32_t &generacion) {
+			std::uint64_t version = 0, valor = 0;
+			std::size_t pos = sizeof(MAGIA_DIARIO);
+			bool valida = contenido.size() >= TAM_CABECERA_DIARIO
+				&& std::memcmp(contenido.data(), MAGIA_DIARIO, sizeof(MAGIA_DIARIO)) == 0
+				&& leer_entero(contenido, pos, contenido.size(), 4, version)
+				&& leer_entero(contenido, pos, contenido.size(), 4, valor);
+			generacion = std::uint32_t(valor);
+			return valida && version == VERSION_DIARIO;
+		}
+
+		// Lee el registro que empieza en 'pos' y avanza 'pos' hasta el
+		// siguiente. Devuelve false (sin avanzar) si el registro está
+		// incompleto, su suma de control no coincide o no se entiende.
+		static bool leer_registro(const std::vector <char> &contenido, std::size_t &pos, OperacionDiario &operacion) {
+			std::size_t p = pos;
+			std::uint64_t longitud = 0, tipo = 0, suma = 0, marca = 0;
+			bool correcto = leer_entero(contenido, p, contenido.size(), 4, longitud)
+				&& longitud <= MAX_DATOS_REGISTRO && longitud + 5 <= contenido.size() - p;
+			if (correcto) {
+				std::size_t fin = p + 1 + std::size_t(longitud), pos_suma = fin;
+				correcto = leer_entero(contenido, pos_suma, contenido.size(), 4, suma)
+					&& suma == suma_control(contenido.data() + p, std::size_t(longitud) + 1)
+					&& leer_entero(contenido, p, fin, 1, tipo);
+				if (correcto) {
+					operacion.tipo = TipoOperacion(tipo);
+					switch (tipo) {
+					case OP_NUEVO_USUARIO:
+						correcto = leer_cadena(contenido, p, fin, operacion.usuario);
+						break;
+					case OP_SEGUIR:
+					case OP_DEJAR_DE_SEGUIR:
+						correcto = leer_cadena(contenido, p, fin, operacion.usuario)
+							&& leer_cadena(contenido, p, fin, operacion.otro);
+						break;
+					case OP_NUEVO_TWEET:
+						correcto = leer_cadena(contenido, p, fin, operacion.usuario)
+							&& leer_entero(contenido, p, fin, 8, marca)
+							&& leer_cadena(contenido, p, fin, operacion.texto);
+						if (correcto) {
+							operacion.marca_tiempo = MarcaTiempo(marca);
+						}
+						break;
+					default:
+						correcto = false;
+					}
+				}
+				correcto = correcto && p == fin;
+				if (correcto) {
+					pos = fin + 4;
+				}
+			}
+			return correcto;
+		}
+	};
+}
+#endif
@@ -0,0 +1,242 @@
+/****************************************************************************
+* Clase GestorEpocas
+*
+* Liberación diferida de memoria por épocas (epoch-based reclamation) para
+* estructuras con un escritor y muchos lectores concurrentes. El escritor
+* no modifica nunca un objeto que pueda estar leyéndose: crea una versión
+* nueva, la publica y "retira" la antigua, que se libera cuando ningún
+* lector puede tenerla todavía.
+*
+* Cada hilo tiene un registro con la época global que vio al empezar a
+* leer (0 si no está leyendo). Empezar y terminar una lectura son dos
+* escrituras en el registro propio, sin cerrojos ni escrituras
+* compartidas. La época global solo avanza cuando todos los lectores
+* activos la han visto; un objeto retirado en la época 'e' se libera al
+* llegar a la época 'e + 2', cuando ya han terminado todos los lectores
+* que empezaron antes de retirarlo.
+*
+* Los registros de los hilos se reservan la primera vez que un hilo lee,
+* se reutilizan cuando el hilo termina y no se liberan nunca.
+****************************************************************************/
+
+#ifndef __EPOCAS__
+#define __EPOCAS__
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+
+namespace {
+	const unsigned MAX_RETIRADOS_PENDIENTES = 64; // Retirados a partir de los que se intenta liberar
+}
+
+namespace bblProgII {
+	class GestorEpocas {
+	public:
+		// Devuelve el gestor de épocas del proceso
+		static GestorEpocas & global() {
+			static GestorEpocas gestor;
+			return gestor;
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE LOS LECTORES
+		//
+		// Entre entrar() y salir(), ningún objeto retirado después de
+		// entrar() se libera. Las lecturas se pueden anidar (cada entrar()
+		// con su salir()).
+
+		void entrar() {
+			RegistroHilo &registro = registro_hilo();
+			if (registro.anidamiento++ == 0) {
+				registro.epoca.store(epoca.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				// La época anunciada debe ser visible antes de leer nada
+				// de la estructura
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+			}
+		}
+
+		void salir() {
+			RegistroHilo &registro = registro_hilo();
+			if (--registro.anidamiento == 0) {
+				registro.epoca.store(0, std::memory_order_release);
+			}
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE LOS ESCRITORES
+
+		// Anota 'objeto' para liberarlo (con delete) cuando ya no lo pueda
+		// estar leyendo ningún lector.
+		// PRECONDICIÓN: 'objeto' ya no es accesible para los lectores que
+		// entren a partir de ahora
+		template <typename T>
+		void retirar(const T *objeto) {
+			Retirado retirado;
+			retirado.objeto = objeto;
+			retirado.borrar = [](const void *p) { delete static_cast<const T *>(p); };
+			std::vector <Retirado> liberables;
+			{
+				std::lock_guard<std::mutex> cerrojo(mutex_retirados);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				retirado.epoca = epoca.load(std::memory_order_relaxed);
+				retirados.push_back(retirado);
+				if (retirados.size() >= MAX_RETIRADOS_PENDIENTES) {
+					avanzar_epoca();
+					extraer_liberables(liberables);
+				}
+			}
+			liberar(liberables);
+		}
+
+		// Espera a que terminen las lecturas en curso y libera todos los
+		// objetos retirados.
+		// PRECONDICIÓN: el hilo que llama no está leyendo
+		void sincronizar() {
+			std::vector <Retirado> liberables;
+			{
+				std::lock_guard<std::mutex> cerrojo(mutex_retirados);
+				std::uint64_t objetivo = epoca.load(std::memory_order_relaxed) + 2;
+				while (epoca.load(std::memory_order_relaxed) < objetivo) {
+					if (!avanzar_epoca()) {
+						std::this_thread::yield();
+					}
+				}
+				extraer_liberables(liberables);
+			}
+			liberar(liberables);
+		}
+
+		// Devuelve el número de objetos retirados que aún no se han liberado
+		std::size_t num_retirados() {
+			std::lock_guard<std::mutex> cerrojo(mutex_retirados);
+			return retirados.size();
+		}
+
+	private:
+		// Registro de un hilo lector, en su propia línea de caché
+		struct alignas(64) RegistroHilo {
+			RegistroHilo() : epoca(0), en_uso(true), anidamiento(0), siguiente(nullptr) {}
+			std::atomic<std::uint64_t> epoca;
+			std::atomic<bool> en_uso;
+			// Solo lo usa el hilo propietario
+			unsigned anidamiento;
+			RegistroHilo *siguiente;
+		};
+		// Registro de hilo reservado por el hilo actual; al terminar el
+		// hilo, queda libre para otro
+		struct PropiedadRegistro {
+			RegistroHilo *registro;
+			PropiedadRegistro() : registro(nullptr) {}
+			~PropiedadRegistro() {
+				if (registro != nullptr) {
+					registro->epoca.store(0, std::memory_order_relaxed);
+					registro->en_uso.store(false, std::memory_order_release);
+				}
+			}
+		};
+		struct Retirado {
+			const void *objeto;
+			void (*borrar)(const void *);
+			std::uint64_t epoca;
+		};
+
+		GestorEpocas() : epoca(1), registros(nullptr), mutex_retirados(), retirados() {}
+		GestorEpocas(const GestorEpocas &);
+		GestorEpocas & operator=(const GestorEpocas &);
+
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		std::atomic<std::uint64_t> epoca;
+		// Lista (solo crece) de los registros de los hilos
+		std::atomic<RegistroHilo *> registros;
+		// Objetos retirados, en orden de época
+		std::mutex mutex_retirados;
+		std::vector <Retirado> retirados;
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS
+		//
+		// Devuelve el registro del hilo actual, reservándolo la primera vez
+		RegistroHilo & registro_hilo() {
+			thread_local PropiedadRegistro propio;
+			if (propio.registro == nullptr) {
+				propio.registro = reservar_registro();
+			}
+			return *propio.registro;
+		}
+
+		// Reutiliza el registro de un hilo terminado o añade uno nuevo
+		RegistroHilo * reservar_registro() {
+			RegistroHilo *registro = registros.load(std::memory_order_acquire);
+			bool libre = false;
+			while (registro != nullptr && !libre) {
+				libre = !registro->en_uso.load(std::memory_order_relaxed) && !registro->en_uso.exchange(true, std::memory_order_acquire);
+				if (!libre) {
+					registro = registro->siguiente;
+				}
+			}
+			if (!libre) {
+				registro = new RegistroHilo();
+				registro->siguiente = registros.load(std::memory_order_relaxed);
+				while (!registros.compare_exchange_weak(registro->siguiente, registro, std::memory_order_release, std::memory_order_relaxed)) {
+				}
+			}
+			return registro;
+		}
+
+		// Pasa a la época siguiente si todos los lectores activos están en
+		// la actual. Devuelve si ha avanzado.
+		// PRECONDICIÓN: se tiene 'mutex_retirados'
+		bool avanzar_epoca() {
+			std::uint64_t actual = epoca.load(std::memory_order_relaxed);
+			bool avanzar = true;
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			for (RegistroHilo *r = registros.load(std::memory_order_acquire); r != nullptr && avanzar; r = r->siguiente) {
+				std::uint64_t vista = r->epoca.load(std::memory_order_acquire);
+				avanzar = vista == 0 || vista == actual;
+			}
+			if (avanzar) {
+				epoca.store(actual + 1, std::memory_order_release);
+			}
+			return avanzar;
+		}
+
+		// Saca de 'retirados' los objetos que ya se pueden liberar
+		// PRECONDICIÓN: se tiene 'mutex_retirados'
+		void extraer_liberables(std::vector <Retirado> &liberables) {
+			std::uint64_t actual = epoca.load(std::memory_order_relaxed);
+			std::size_t num = 0;
+			while (num < retirados.size() && retirados[num].epoca + 2 <= actual) {
+				num++;
+			}
+			liberables.assign(retirados.begin(), retirados.begin() + num);
+			retirados.erase(retirados.begin(), retirados.begin() + num);
+		}
+
+		// Libera los objetos (fuera del cerrojo)
+		static void liberar(const std::vector <Retirado> &liberables) {
+			for (std::size_t i = 0; i < liberables.size(); i++) {
+				liberables[i].borrar(liberables[i].objeto);
+			}
+		}
+	};
+
+	// Lectura en curso: entra en el gestor de épocas al construirse y sale
+	// al destruirse
+	class LecturaEpoca {
+	public:
+		LecturaEpoca() {
+			GestorEpocas::global().entrar();
+		}
+		~LecturaEpoca() {
+			GestorEpocas::global().salir();
+		}
+	private:
+		LecturaEpoca(const LecturaEpoca &);
+		LecturaEpoca & operator=(const LecturaEpoca &);
+	};
+}
+#endif
@@ -0,0 +1,165 @@
+/****************************************************************************
+* Clase EscritorSalida
+*
+* Escritor con búfer para los listados de UsuarioTwitter (imprimir_* y
+* guardar_*): los registros se dan formato directamente en un bloque de
+* memoria de TAM_BLOQUE_ESCRITURA bytes, que se reutiliza, y el bloque se
+* entrega de una vez al destino cuando se llena y al vaciar el escritor.
+* Los números se convierten con std::to_chars (sin locale ni flujos), y
+* no se vacía el destino línea a línea como con std::endl.
+*
+* El destino puede ser un flujo de salida (std::cout, un std::ofstream...)
+* o, en sistemas POSIX, un descriptor de fichero.
+****************************************************************************/
+
+#ifndef __ESCRITOR__SALIDA__
+#define __ESCRITOR__SALIDA__
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <vector>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define __ESCRITOR_POSIX__
+#endif
+
+namespace {
+	const std::size_t TAM_BLOQUE_ESCRITURA = 1 << 16; // Bytes que se acumulan antes de escribir
+	const std::size_t MAX_CIFRAS_NATURAL = 20; // Cifras de un std::uint64_t
+}
+
+namespace bblProgII {
+	class EscritorSalida {
+	public:
+		//------------------------------------------------------------------
+		// CONSTRUCTORES Y DESTRUCTOR
+
+		// Constructor extendido: escribe en el flujo 'salida'
+		explicit EscritorSalida(std::ostream &salida)
+			: flujo(&salida), fd(-1), bloque(TAM_BLOQUE_ESCRITURA), ocupado(0), correcto(bool(salida)) {}
+
+#if defined(__ESCRITOR_POSIX__)
+		// Constructor extendido: escribe en el descriptor 'fd', que no se
+		// cierra al destruir el escritor
+		explicit EscritorSalida(int fd)
+			: flujo(nullptr), fd(fd), bloque(TAM_BLOQUE_ESCRITURA), ocupado(0), correcto(fd >= 0) {}
+#endif
+
+		// Destructor: escribe lo que quede en el bloque
+		~EscritorSalida() {
+			vaciar();
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ESCRITURA
+
+		// Añade un carácter
+		void caracter(char c) {
+			if (ocupado == bloque.size()) {
+				escribir_bloque();
+			}
+			bloque[ocupado++] = c;
+		}
+
+		// Añade 'longitud' caracteres a partir de 'datos'. Un texto que no
+		// cabe en el bloque se entrega directamente al destino.
+		void texto(const char *datos, std::size_t longitud) {
+			if (longitud > bloque.size() - ocupado) {
+				escribir_bloque();
+			}
+			if (longitud > bloque.size()) {
+				escribir_destino(datos, longitud);
+			}
+			else {
+				std::memcpy(bloque.data() + ocupado, datos, longitud);
+				ocupado += longitud;
+			}
+		}
+		void texto(std::string_view datos) {
+			texto(datos.data(), datos.size());
+		}
+
+		// Añade un número natural en base 10
+		void natural(std::uint64_t valor) {
+			if (bloque.size() - ocupado < MAX_CIFRAS_NATURAL) {
+				escribir_bloque();
+			}
+			char *inicio = bloque.data() + ocupado;
+			ocupado += std::size_t(std::to_chars(inicio, inicio + MAX_CIFRAS_NATURAL, valor).ptr - inicio);
+		}
+
+		// Entrega al destino lo acumulado en el bloque y lo vacía (flush).
+		// Devuelve false si alguna escritura ha fallado desde que se creó
+		// el escritor.
+		bool vaciar() {
+			escribir_bloque();
+			if (flujo != nullptr && correcto) {
+				correcto = bool(flujo->flush());
+			}
+			return correcto;
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+
+		// Indica si todas las escrituras hasta ahora han sido correctas
+		// (lo acumulado en el bloque todavía no se ha escrito)
+		bool es_correcto() const {
+			return correcto;
+		}
+
+	private:
+		EscritorSalida(const EscritorSalida &);
+		EscritorSalida & operator=(const EscritorSalida &);
+
+		// Entrega el bloque al destino y lo deja vacío
+		void escribir_bloque() {
+			if (ocupado > 0) {
+				escribir_destino(bloque.data(), ocupado);
+				ocupado = 0;
+			}
+		}
+
+		// Escribe 'longitud' bytes en el destino. Tras un error ya no se
+		// escribe nada más; en un flujo, el error se marca además con
+		// badbit, como haría el propio flujo.
+		void escribir_destino(const char *datos, std::size_t longitud) {
+			if (flujo != nullptr) {
+				correcto = correcto && flujo->rdbuf()->sputn(datos, std::streamsize(longitud)) == std::streamsize(longitud);
+				if (!correcto) {
+					flujo->setstate(std::ios::badbit);
+				}
+			}
+#if defined(__ESCRITOR_POSIX__)
+			else {
+				// write() puede escribir solo una parte de cada vez
+				while (longitud > 0 && correcto) {
+					ssize_t escritos = ::write(fd, datos, longitud);
+					correcto = escritos > 0;
+					if (correcto) {
+						datos += escritos;
+						longitud -= std::size_t(escritos);
+					}
+				}
+			}
+#endif
+		}
+
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		// Destino: un flujo o, si 'flujo' es nulo, el descriptor 'fd'
+		std::ostream *flujo;
+		int fd;
+		// Bloque de escritura y bytes ocupados en él
+		std::vector <char> bloque;
+		std::size_t ocupado;
+		// Falso desde la primera escritura fallida
+		bool correcto;
+	};
+}
+#endif
@@ -0,0 +1,171 @@
+/****************************************************************************
+* Prueba de estrés de UsuarioConcurrente
+*
+* Un hilo escritor alterna nuevo_tweet y nuevo_seguidor sobre un
+* UsuarioConcurrente mientras varios hilos lectores leen sin parar la
+* versión publicada y comprueban que es coherente:
+*   - num_tweets() coincide con los tweets que se recorren en su vista, y
+*     éstos son los que escribió el escritor, en orden,
+*   - num_seguidores() coincide con la vista de seguidores, y
+*   - los cambios se ven completos: hay tantos seguidores como tweets, o
+*     uno menos.
+* La prueba se repite con 1, 2, 4... hasta el número máximo de lectores y
+* escribe, para cada uno, las lecturas y escrituras por segundo y las
+* incoherencias encontradas. Termina con EXIT_FAILURE si ha encontrado
+* alguna.
+*
+* Uso: estresar_usuario_concurrente [opciones]
+*   --lectores N           número máximo de hilos lectores (por defecto 8)
+*   --operaciones N        operaciones del escritor (por defecto 20000)
+****************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include "usuario_concurrente.hpp"
+
+using namespace std;
+using namespace bblProgII;
+
+namespace {
+	const unsigned MAX_LECTORES_POR_DEFECTO = 8; // Hilos lectores de la última prueba si no se indican
+	const unsigned OPERACIONES_POR_DEFECTO = 20000; // Operaciones del escritor si no se indican
+	const MarcaTiempo MARCA_PRIMER_TWEET = 1400000000; // Marca de tiempo del primer tweet del escritor
+}
+
+// Resultado de una prueba
+struct Estres {
+	unsigned long long lecturas;
+	unsigned long long escrituras;
+	unsigned long long incoherencias;
+	double segundos;
+};
+
+// Lee la línea de órdenes. Devuelve false si no es correcta.
+bool leer_argumentos(int argc, char *argv[], unsigned &max_lectores, unsigned &operaciones);
+
+// Prueba con 'num_lectores' lectores y un escritor que hace 'operaciones'
+// operaciones sobre los seguidores 'ids'
+void estresar(unsigned num_lectores, unsigned operaciones, const vector <IdUsuario> &ids, Estres &estres);
+
+// Comprueba una versión del usuario y devuelve si es coherente
+bool coherente(const UsuarioTwitter &usuario);
+
+
+int main(int argc, char *argv[]) {
+	unsigned max_lectores = MAX_LECTORES_POR_DEFECTO, operaciones = OPERACIONES_POR_DEFECTO;
+	bool correcto = leer_argumentos(argc, argv, max_lectores, operaciones);
+	if (!correcto) {
+		cerr << "Uso: " << argv[0] << " [--lectores N] [--operaciones N]" << endl;
+	}
+	else {
+		// Los nombres se registran antes de empezar: la tabla de símbolos
+		// no admite lecturas mientras se registran nombres nuevos
+		vector <IdUsuario> ids(operaciones / 2 + 1);
+		for (unsigned i = 0; i < ids.size(); i++) {
+			ids[i] = TablaSimbolos::global().registrar("seguidor_" + to_string(i));
+		}
+		// Lectores de cada prueba: 1, 2, 4... y 'max_lectores'
+		vector <unsigned> barrido;
+		for (unsigned num_lectores = 1; num_lectores < max_lectores; num_lectores *= 2) {
+			barrido.push_back(num_lectores);
+		}
+		barrido.push_back(max_lectores);
+		for (unsigned i = 0; i < barrido.size(); i++) {
+			Estres estres;
+			estresar(barrido[i], operaciones, ids, estres);
+			cout << "lectores: " << barrido[i]
+				<< ", lecturas/s: " << (unsigned long long)(estres.lecturas / estres.segundos)
+				<< ", escrituras/s: " << (unsigned long long)(estres.escrituras / estres.segundos)
+				<< ", incoherencias: " << estres.incoherencias << endl;
+			correcto = correcto && estres.incoherencias == 0;
+		}
+	}
+	return correcto ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+bool leer_argumentos(int argc, char *argv[], unsigned &max_lectores, unsigned &operaciones) {
+	bool correcto = true;
+	int i = 1;
+	while (correcto && i < argc) {
+		string opcion = argv[i];
+		correcto = i + 1 < argc && (opcion == "--lectores" || opcion == "--operaciones");
+		if (correcto) {
+			unsigned valor = unsigned(strtoul(argv[i + 1], nullptr, 10));
+			correcto = valor > 0;
+			if (opcion == "--lectores") {
+				max_lectores = valor;
+			}
+			else {
+				operaciones = valor;
+			}
+		}
+		i += 2;
+	}
+	return correcto;
+}
+
+void estresar(unsigned num_lectores, unsigned operaciones, const vector <IdUsuario> &ids, Estres &estres) {
+	UsuarioConcurrente usuario(UsuarioTwitter("escritor"));
+	atomic<bool> terminado(false);
+	atomic<unsigned> preparados(0);
+	atomic<unsigned long long> lecturas(0), incoherencias(0);
+	vector <thread> lectores;
+	for (unsigned h = 0; h < num_lectores; h++) {
+		lectores.emplace_back([&usuario, &terminado, &preparados, &lecturas, &incoherencias]() {
+			unsigned long long mis_lecturas = 0, mis_incoherencias = 0;
+			preparados++;
+			while (!terminado.load(memory_order_relaxed)) {
+				UsuarioConcurrente::Lectura lectura = usuario.leer();
+				mis_incoherencias += coherente(*lectura) ? 0 : 1;
+				mis_lecturas++;
+			}
+			lecturas += mis_lecturas;
+			incoherencias += mis_incoherencias;
+		});
+	}
+	// El escritor no empieza hasta que todos los lectores están leyendo
+	// (con pocos núcleos, podría terminar antes de que arranquen)
+	while (preparados.load() < num_lectores) {
+		this_thread::yield();
+	}
+	chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+	Resultado res;
+	Tweet tweet;
+	for (unsigned i = 0; i < operaciones; i++) {
+		if (i % 2 == 0) {
+			tweet.tweet = "tweet " + to_string(i / 2);
+			tweet.fecha_hora = a_fecha_hora(MARCA_PRIMER_TWEET + i / 2);
+			usuario.nuevo_tweet(tweet, res);
+		}
+		else {
+			usuario.nuevo_seguidor(ids[i / 2], res);
+		}
+	}
+	terminado = true;
+	for (unsigned h = 0; h < lectores.size(); h++) {
+		lectores[h].join();
+	}
+	estres.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+	estres.lecturas = lecturas;
+	estres.escrituras = operaciones;
+	// La última versión también tiene que ser coherente
+	estres.incoherencias = incoherencias + (coherente(*usuario.leer()) ? 0 : 1);
+}
+
+bool coherente(const UsuarioTwitter &usuario) {
+	VistaTweets tweets = usuario.ver_tweets();
+	VistaUsuarios seguidores = usuario.ver_seguidores();
+	unsigned num_tweets = 0;
+	bool correcto = true;
+	for (VistaTweets::const_iterator it = tweets.begin(); correcto && it != tweets.end(); ++it) {
+		correcto = it->marca_tiempo == MARCA_PRIMER_TWEET + num_tweets;
+		num_tweets++;
+	}
+	return correcto && num_tweets == usuario.num_tweets() && seguidores.longitud() == usuario.num_seguidores()
+		&& (usuario.num_seguidores() == num_tweets || usuario.num_seguidores() + 1 == num_tweets);
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+/****************************************************************************
+* Generador de redes sintéticas
+*
+* generar_red() crea una red de usuarios con seguidores y tweets para las
+* pruebas de rendimiento. La red depende solo de los parámetros y de la
+* semilla, de modo que dos ejecuciones con los mismos valores miden
+* exactamente las mismas operaciones.
+*
+* Como en las redes reales, el número de seguidores está muy sesgado: el
+* usuario seguido en cada relación se elige con una distribución de Zipf
+* (el usuario de rango r es elegido con probabilidad proporcional a
+* 1 / (r + 1)^s), así que unos pocos usuarios acumulan gran parte de los
+* seguidores y la mayoría tiene muy pocos. Los tweets mezclan palabras de
+* un vocabulario fijo con menciones (@usuario) a usuarios elegidos con la
+* misma distribución.
+****************************************************************************/
+
+#ifndef __GENERADOR__RED__
+#define __GENERADOR__RED__
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+#include "usuario_twitter.hpp"
+
+namespace {
+	const double EXPONENTE_ZIPF = 0.8; // Exponente de la distribución de seguidores y menciones
+	const unsigned MAX_MENCIONES_TWEET = 2; // Menciones como máximo en cada tweet
+	const bblProgII::MarcaTiempo INICIO_TWEETS = 1388534400; // 1/1/2014 0:00:00
+	const unsigned MAX_SEGUNDOS_ENTRE_TWEETS = 30; // Separación máxima entre dos tweets consecutivos
+	const char * const PALABRAS_TWEET[] = {
+		"hoy", "he", "escrito", "un", "algoritmo", "para", "la", "maquina", "de",
+		"sumar", "numeros", "complejos", "creo", "que", "me", "hare", "famosa",
+		"no", "parece", "dificil", "con", "diferencia", "es", "mi", "favorita",
+		"programa", "analitica", "tarjetas", "perforadas", "calculo"
+	};
+	const unsigned NUM_PALABRAS_TWEET = sizeof(PALABRAS_TWEET) / sizeof(PALABRAS_TWEET[0]);
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Parámetros de la red: los usuarios siguen de media a 'siguiendo_medio'
+	// usuarios (entre 1 y 2 * siguiendo_medio - 1) y escriben de media
+	// 'tweets_medio' tweets
+	struct ParametrosRed {
+		unsigned num_usuarios;
+		unsigned siguiendo_medio;
+		unsigned tweets_medio;
+		unsigned long long semilla;
+	};
+	// Relación de seguimiento entre dos usuarios de la red (posiciones en
+	// RedSintetica::ids)
+	struct Seguimiento {
+		unsigned seguidor;
+		unsigned seguido;
+	};
+	// Tweet de un usuario de la red (posición en RedSintetica::ids)
+	struct TweetSintetico {
+		unsigned autor;
+		Tweet tweet;
+	};
+	// Red generada. El usuario de la posición 0 es el más popular. Los
+	// seguimientos no se repiten y están en orden aleatorio; los tweets
+	// están en orden cronológico.
+	struct RedSintetica {
+		std::vector <IdUsuario> ids;
+		std::vector <Seguimiento> seguimientos;
+		std::vector <TweetSintetico> tweets;
+	};
+
+	//---------------------------------------------------------------------------
+	// FUNCIONES
+
+	// Devuelve el nombre del usuario de la posición 'num' de una red
+	// sintética
+	inline std::string nombre_usuario_sintetico(unsigned num) {
+		char nombre[32];
+		std::snprintf(nombre, sizeof(nombre), "usuario_%07u", num);
+		return nombre;
+	}
+
+	// Genera la red descrita por 'parametros' y la devuelve a través de
+	// 'red'. Los nombres de los usuarios se registran en la tabla de
+	// símbolos global.
+	// PRECONDICIÓN: parametros.num_usuarios > 0, parametros.siguiendo_medio > 0
+	inline void generar_red(const ParametrosRed &parametros, RedSintetica &red) {
+		std::mt19937_64 aleatorio(parametros.semilla);
+		unsigned n = parametros.num_usuarios;
+		// Distribución acumulada de Zipf sobre los rangos de los usuarios
+		std::vector <double> acumulada(n);
+		double suma = 0.0;
+		for (unsigned r = 0; r < n; r++) {
+			suma += 1.0 / std::pow(double(r + 1), EXPONENTE_ZIPF);
+			acumulada[r] = suma;
+		}
+		std::uniform_real_distribution<double> uniforme_zipf(0.0, suma);
+		// Usuario elegido con la distribución de Zipf
+		auto elegir_zipf = [&aleatorio, &acumulada, &uniforme_zipf, n]() {
+			unsigned r = unsigned(std::upper_bound(acumulada.begin(), acumulada.end(), uniforme_zipf(aleatorio)) - acumulada.begin());
+			return (r < n) ? r : n - 1;
+		};
+
+		red.ids.resize(n);
+		for (unsigned i = 0; i < n; i++) {
+			red.ids[i] = TablaSimbolos::global().registrar(nombre_usuario_sintetico(i));
+		}
+
+		// Seguimientos: cada usuario sigue a un número uniforme de usuarios
+		// elegidos con la distribución de Zipf (sin repetir ni seguirse a sí
+		// mismo)
+		red.seguimientos.clear();
+		std::uniform_int_distribution<unsigned> num_siguiendo(1, 2 * parametros.siguiendo_medio - 1);
+		std::vector <unsigned> elegidos;
+		for (unsigned u = 0; u < n; u++) {
+			unsigned num = std::min(num_siguiendo(aleatorio), n - 1);
+			elegidos.clear();
+			// Con pocos usuarios, Zipf puede tardar en dar 'num' distintos;
+			// se limita el número de intentos
+			for (unsigned intento = 0; elegidos.size() < num && intento < 8 * num; intento++) {
+				unsigned seguido = elegir_zipf();
+				if (seguido != u && std::find(elegidos.begin(), elegidos.end(), seguido) == elegidos.end()) {
+					elegidos.push_back(seguido);
+				}
+			}
+			for (std::size_t i = 0; i < elegidos.size(); i++) {
+				Seguimiento seguimiento;
+				seguimiento.seguidor = u;
+				seguimiento.seguido = elegidos[i];
+				red.seguimientos.push_back(seguimiento);
+			}
+		}
+		std::shuffle(red.seguimientos.begin(), red.seguimientos.end(), aleatorio);
+
+		// Tweets: autores uniformes, en orden cronológico, con menciones
+		// elegidas con la distribución de Zipf
+		unsigned long long num_tweets = (unsigned long long)(n) * parametros.tweets_medio;
+		red.tweets.resize(num_tweets);
+		std::uniform_int_distribution<unsigned> autor(0, n - 1);
+		std::uniform_int_distribution<unsigned> palabra(0, NUM_PALABRAS_TWEET - 1);
+		std::uniform_int_distribution<unsigned> num_menciones(0, MAX_MENCIONES_TWEET);
+		std::uniform_int_distribution<unsigned> num_palabras(3, 15);
+		std::uniform_int_distribution<unsigned> separacion(0, MAX_SEGUNDOS_ENTRE_TWEETS);
+		MarcaTiempo marca = INICIO_TWEETS;
+		for (unsigned long long t = 0; t < num_tweets; t++) {
+			TweetSintetico &tweet = red.tweets[t];
+			tweet.autor = autor(aleatorio);
+			marca += separacion(aleatorio);
+			tweet.tweet.fecha_hora = a_fecha_hora(marca);
+			std::string &texto = tweet.tweet.tweet;
+			texto.clear();
+			// Las menciones van en posiciones al azar entre las palabras
+			unsigned quedan = num_palabras(aleatorio), menciones = num_menciones(aleatorio);
+			quedan += menciones;
+			while (quedan > 0) {
+				bool mencion = std::uniform_int_distribution<unsigned>(1, quedan)(aleatorio) <= menciones;
+				std::string trozo = mencion ? "@" + nombre_usuario_sintetico(elegir_zipf()) : PALABRAS_TWEET[palabra(aleatorio)];
+				if (texto.size() + trozo.size() + 1 <= MAX_LONG_TWEET) {
+					if (!texto.empty()) {
+						texto += ' ';
+					}
+					texto += trozo;
+				}
+				menciones -= mencion ? 1 : 0;
+				quedan--;
+			}
+		}
+	}
+}
+#endif
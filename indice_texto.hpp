@@ -0,0 +1,253 @@
+/****************************************************************************
+* Clase IndiceTexto
+*
+* Índice invertido de las palabras de los tweets: para cada palabra guarda
+* la lista ordenada de documentos (tweets) en que aparece. Los documentos
+* se numeran de forma consecutiva en el orden en que se indexan, de modo
+* que cada lista crece siempre por el final y se puede guardar comprimida:
+* cada número se guarda como la diferencia con el anterior, codificada en
+* 7 bits por byte (varint), con lo que la mayoría ocupan uno o dos bytes.
+* Cada TAM_SALTO documentos se guarda un punto de salto (documento anterior
+* y posición en los bytes), para que al cruzar una lista corta con una
+* larga no haya que descomprimir la larga entera.
+*
+* Las palabras son secuencias de letras, dígitos, '_' y bytes no ASCII
+* (letras acentuadas); no distinguen mayúsculas de minúsculas ASCII. Así,
+* "@ada_lovelace" y "#Ada" dan las palabras "ada_lovelace" y "ada".
+****************************************************************************/
+
+#ifndef __INDICE__TEXTO__
+#define __INDICE__TEXTO__
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include "menciones.hpp"
+
+namespace {
+	const unsigned TAM_SALTO = 128; // Documentos entre dos puntos de salto
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Número de documento dentro del índice
+	typedef std::uint32_t IdDocumento;
+	// Lista de documentos, de menor a mayor
+	typedef std::vector <IdDocumento> ListaDocumentos;
+
+	//---------------------------------------------------------------------------
+	// FUNCIONES DE EXTRACCIÓN DE PALABRAS
+
+	// Indica si 'c' puede formar parte de una palabra
+	inline bool es_caracter_palabra(char c) {
+		return es_caracter_nombre(c) || static_cast<unsigned char>(c) >= 0x80;
+	}
+
+	// Llama a 'funcion(palabra)' por cada palabra de 'texto', pasándola a
+	// minúsculas en 'palabra' (se reutiliza entre llamadas)
+	template <typename Funcion>
+	void recorrer_palabras(const char *texto, std::size_t longitud, std::string &palabra, Funcion funcion) {
+		std::size_t pos = 0;
+		while (pos < longitud) {
+			while (pos < longitud && !es_caracter_palabra(texto[pos])) {
+				pos++;
+			}
+			if (pos < longitud) {
+				palabra.clear();
+				while (pos < longitud && es_caracter_palabra(texto[pos])) {
+					char c = texto[pos];
+					palabra.push_back((c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c);
+					pos++;
+				}
+				funcion(palabra);
+			}
+		}
+	}
+
+	//---------------------------------------------------------------------------
+	class IndiceTexto {
+	public:
+		// Constructor por defecto: índice vacío
+		IndiceTexto() : listas(), num_posiciones(0) {}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+
+		// Devuelve el número de palabras distintas del índice
+		std::size_t num_palabras() const {
+			return listas.size();
+		}
+
+		// Devuelve el número total de pares (palabra, documento)
+		unsigned long long posiciones() const {
+			return num_posiciones;
+		}
+
+		// Devuelve una estimación de la memoria ocupada por el índice, en
+		// bytes: listas comprimidas, palabras y nodos de la tabla hash
+		std::size_t memoria() const {
+			std::size_t bytes = listas.bucket_count() * sizeof(void *);
+			for (Listas::const_iterator it = listas.begin(); it != listas.end(); ++it) {
+				bytes += sizeof(Listas::value_type) + sizeof(void *) + it->second.bytes.capacity()
+					+ it->second.saltos.capacity() * sizeof(Salto);
+				if (it->first.capacity() > sizeof(std::string)) {
+					bytes += it->first.capacity() + 1;
+				}
+			}
+			return bytes;
+		}
+
+		// Devuelve a través de 'docs' los documentos que contienen todas
+		// las palabras de 'consulta' (de menor a mayor). Una consulta sin
+		// palabras no devuelve ningún documento.
+		void buscar(const std::string &consulta, ListaDocumentos &docs) const {
+			std::vector <const ListaPosiciones *> buscadas;
+			std::string palabra;
+			bool falta = false;
+			recorrer_palabras(consulta.data(), consulta.size(), palabra, [this, &buscadas, &falta](const std::string &p) {
+				Listas::const_iterator it = listas.find(p);
+				if (it == listas.end()) {
+					falta = true;
+				}
+				else {
+					buscadas.push_back(&it->second);
+				}
+			});
+			docs.clear();
+			if (!falta && !buscadas.empty()) {
+				// Se parte de la lista más corta y se cruza con las demás,
+				// de más corta a más larga
+				std::sort(buscadas.begin(), buscadas.end(), [](const ListaPosiciones *a, const ListaPosiciones *b) {
+					return a->num < b->num;
+				});
+				decodificar(*buscadas[0], docs);
+				for (std::size_t i = 1; i < buscadas.size() && !docs.empty(); i++) {
+					cruzar(*buscadas[i], docs);
+				}
+			}
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ACTUALIZACIÓN
+
+		// Añade las palabras de 'texto' al índice como documento 'doc'
+		// PRECONDICIÓN: 'doc' es mayor que todos los documentos indexados
+		void indexar(IdDocumento doc, std::string_view texto) {
+			std::string palabra;
+			recorrer_palabras(texto.data(), texto.size(), palabra, [this, doc](const std::string &p) {
+				ListaPosiciones &lista = listas[p];
+				// Una palabra repetida en el mismo documento se anota una vez
+				if (lista.num == 0 || lista.ultimo != doc) {
+					if (lista.num % TAM_SALTO == 0) {
+						Salto salto;
+						salto.anterior = lista.ultimo;
+						salto.posicion = unsigned(lista.bytes.size());
+						lista.saltos.push_back(salto);
+					}
+					escribir_varint(lista.bytes, doc - lista.ultimo);
+					lista.ultimo = doc;
+					lista.num++;
+					num_posiciones++;
+				}
+			});
+		}
+
+	private:
+		// Punto de salto al documento número k * TAM_SALTO de una lista:
+		// documento anterior a él y posición de su varint en los bytes
+		struct Salto {
+			IdDocumento anterior;
+			unsigned posicion;
+		};
+		// Lista de documentos de una palabra, comprimida: diferencias entre
+		// documentos consecutivos (el primero, respecto a 0) en varint
+		struct ListaPosiciones {
+			ListaPosiciones() : bytes(), saltos(), ultimo(0), num(0) {}
+			std::vector <unsigned char> bytes;
+			std::vector <Salto> saltos;
+			IdDocumento ultimo;
+			unsigned num;
+		};
+		typedef std::unordered_map <std::string, ListaPosiciones> Listas;
+
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		Listas listas;
+		unsigned long long num_posiciones;
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS
+		//
+		// Añade 'valor' al final de 'bytes', 7 bits por byte empezando por
+		// los más bajos; el bit alto indica que siguen más bytes
+		static void escribir_varint(std::vector <unsigned char> &bytes, std::uint32_t valor) {
+			while (valor >= 0x80) {
+				bytes.push_back(static_cast<unsigned char>(valor | 0x80));
+				valor >>= 7;
+			}
+			bytes.push_back(static_cast<unsigned char>(valor));
+		}
+
+		// Lee el varint que empieza en 'p' y avanza 'p' hasta el siguiente
+		static std::uint32_t leer_varint(const unsigned char *&p) {
+			std::uint32_t valor = *p & 0x7F;
+			unsigned desplazamiento = 7;
+			while (*p++ & 0x80) {
+				valor |= std::uint32_t(*p & 0x7F) << desplazamiento;
+				desplazamiento += 7;
+			}
+			return valor;
+		}
+
+		// Devuelve a través de 'docs' la lista descomprimida
+		static void decodificar(const ListaPosiciones &lista, ListaDocumentos &docs) {
+			const unsigned char *p = lista.bytes.data();
+			IdDocumento doc = 0;
+			docs.resize(lista.num);
+			for (unsigned i = 0; i < lista.num; i++) {
+				doc += leer_varint(p);
+				docs[i] = doc;
+			}
+		}
+
+		// Deja en 'docs' solo los documentos que también están en 'lista',
+		// recorriendo ambas a la vez. Antes de descomprimir se salta al
+		// último bloque de 'lista' cuyo documento anterior es menor que el
+		// buscado.
+		static void cruzar(const ListaPosiciones &lista, ListaDocumentos &docs) {
+			const unsigned char *p = lista.bytes.data();
+			IdDocumento doc = 0;
+			unsigned leidos = 0;
+			std::size_t bloque = 0, quedan = 0;
+			for (std::size_t i = 0; i < docs.size() && (leidos < lista.num || doc >= docs[i]); i++) {
+				if (leidos == 0 || doc < docs[i]) {
+					std::size_t siguiente = bloque;
+					while (siguiente + 1 < lista.saltos.size() && lista.saltos[siguiente + 1].anterior < docs[i]) {
+						siguiente++;
+					}
+					if (siguiente * TAM_SALTO > leidos) {
+						p = lista.bytes.data() + lista.saltos[siguiente].posicion;
+						doc = lista.saltos[siguiente].anterior;
+						leidos = unsigned(siguiente * TAM_SALTO);
+					}
+					bloque = siguiente;
+					while (leidos < lista.num && (leidos == 0 || doc < docs[i])) {
+						doc += leer_varint(p);
+						leidos++;
+					}
+				}
+				if (leidos > 0 && doc == docs[i]) {
+					docs[quedan++] = docs[i];
+				}
+			}
+			docs.resize(quedan);
+		}
+	};
+}
+#endif
@@ -0,0 +1,390 @@
+/****************************************************************************
+* Instantáneas binarias de la red social
+*
+* Formato binario, versionado, para guardar la red completa (usuarios,
+* grafo de seguidores y seguidos y tweets) en un único fichero, como
+* alternativa a los ficheros de texto .seg/.sig/.twt de cada usuario. Se
+* escribe con RedSocial::guardar_instantanea y se lee con InstantaneaRed,
+* que proyecta el fichero en memoria (mmap) y sirve las listas de
+* seguidores y los tweets directamente desde él, sin copiarlos ni
+* interpretar texto.
+*
+* Estructura del fichero (enteros en el orden de bytes de la máquina que
+* lo escribe; cada sección empieza en un múltiplo de 8 bytes):
+*
+*   Cabecera                   tamaño fijo, con la posición de cada sección
+*   usuarios[n]                nombre de cada usuario (posición en 'cadenas')
+*   orden_nombres[n]           usuarios ordenados por nombre
+*   siguiendo_inicio[n + 1]    CSR de usuarios seguidos
+*   siguiendo[a]
+*   seguidores_inicio[n + 1]   CSR de seguidores
+*   seguidores[a]
+*   tweets_inicio[n + 1]       tweets de cada usuario, en orden de inserción
+*   tweets[t]                  marca de tiempo y texto (posición en 'cadenas')
+*   cadenas                    nombres y textos, sin separadores
+*
+* Dentro de la instantánea los usuarios se numeran 0..n-1 por orden de
+* IdUsuario, de modo que las listas del CSR siguen ordenadas.
+****************************************************************************/
+
+#ifndef __INSTANTANEA__
+#define __INSTANTANEA__
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define __INSTANTANEA_MMAP__
+#endif
+#include "usuario_twitter.hpp"
+
+namespace {
+	const char MAGIA_INSTANTANEA[8] = { 'B', 'B', 'L', 'T', 'W', 'S', 'N', 'P' }; // Identifica el formato
+	const std::uint32_t VERSION_INSTANTANEA = 1; // Versión del formato
+	const std::uint32_t MARCA_ORDEN_BYTES = 0x01020304; // Detecta un orden de bytes distinto
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// FORMATO DEL FICHERO
+	//
+	// Cabecera: posiciones (en bytes desde el principio del fichero) y
+	// número de elementos de cada sección
+	struct CabeceraInstantanea {
+		char magia[8];
+		std::uint32_t version;
+		std::uint32_t orden_bytes;
+		std::uint32_t num_usuarios;
+		std::uint32_t generacion_diario; // Último diario incluido (ver DiarioOperaciones)
+		std::uint64_t num_aristas;
+		std::uint64_t num_tweets;
+		std::uint64_t pos_usuarios;
+		std::uint64_t pos_orden_nombres;
+		std::uint64_t pos_siguiendo_inicio;
+		std::uint64_t pos_siguiendo;
+		std::uint64_t pos_seguidores_inicio;
+		std::uint64_t pos_seguidores;
+		std::uint64_t pos_tweets_inicio;
+		std::uint64_t pos_tweets;
+		std::uint64_t pos_cadenas;
+		std::uint64_t tam_cadenas;
+		std::uint64_t tam_fichero;
+	};
+	// Nombre de un usuario: posición y longitud dentro de 'cadenas'
+	struct UsuarioInstantanea {
+		std::uint64_t pos_nombre;
+		std::uint32_t long_nombre;
+		std::uint32_t reservado;
+	};
+	// Tweet: marca de tiempo y posición y longitud del texto en 'cadenas'
+	struct TweetInstantanea {
+		std::int64_t marca_tiempo;
+		std::uint64_t pos_texto;
+		std::uint32_t long_texto;
+		std::uint32_t reservado;
+	};
+
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Lista de usuarios (números de usuario de la instantánea, ordenados)
+	// guardada en el fichero
+	struct TramoUsuarios {
+		const std::uint32_t *ids;
+		std::size_t num;
+	};
+	// Tweet guardado en el fichero (el texto apunta al fichero)
+	struct VistaTweet {
+		MarcaTiempo marca_tiempo;
+		std::string_view tweet;
+	};
+
+	//---------------------------------------------------------------------------
+	// Instantánea abierta para lectura. El fichero se proyecta en memoria
+	// (o, en sistemas sin mmap, se lee entero) y todas las consultas
+	// devuelven punteros a él, válidos mientras la instantánea esté
+	// abierta.
+	class InstantaneaRed {
+	public:
+		// Constructor por defecto: instantánea cerrada
+		InstantaneaRed() : datos(nullptr), tam(0), cabecera(nullptr), copia() {}
+		// Destructor: cierra la instantánea
+		~InstantaneaRed() {
+			cerrar();
+		}
+		// No se permite copiar (tendrían la misma proyección)
+		InstantaneaRed(const InstantaneaRed &) = delete;
+		InstantaneaRed & operator=(const InstantaneaRed &) = delete;
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+		//
+		// PRECONDICIÓN (todos): está abierta
+
+		// Indica si la instantánea está abierta
+		bool abierta() const {
+			return cabecera != nullptr;
+		}
+
+		// Devuelve el número de usuarios, aristas y tweets
+		unsigned num_usuarios() const {
+			return cabecera->num_usuarios;
+		}
+		unsigned long long num_aristas() const {
+			return cabecera->num_aristas;
+		}
+		unsigned long long num_tweets() const {
+			return cabecera->num_tweets;
+		}
+
+		// Devuelve la generación del último diario de operaciones incluido
+		// en la instantánea (0 si ninguno)
+		std::uint32_t generacion_diario() const {
+			return cabecera->generacion_diario;
+		}
+
+		// Devuelve el nombre del usuario 'u'
+		// PRECONDICIÓN: u < num_usuarios()
+		std::string_view nombre(std::uint32_t u) const {
+			const UsuarioInstantanea &usuario = seccion<UsuarioInstantanea>(cabecera->pos_usuarios)[u];
+			return std::string_view(cadenas() + usuario.pos_nombre, usuario.long_nombre);
+		}
+
+		// Devuelve el número del usuario 'nombre' (búsqueda binaria por
+		// nombre), o ID_NULO si no está en la instantánea
+		std::uint32_t buscar(std::string_view nombre_buscado) const {
+			const std::uint32_t *orden = seccion<std::uint32_t>(cabecera->pos_orden_nombres);
+			const std::uint32_t *pos = std::lower_bound(orden, orden + num_usuarios(), nombre_buscado,
+				[this](std::uint32_t u, std::string_view n) { return nombre(u) < n; });
+			return (pos != orden + num_usuarios() && nombre(*pos) == nombre_buscado) ? *pos : ID_NULO;
+		}
+
+		// Devuelve los usuarios a los que sigue 'u' y sus seguidores
+		// PRECONDICIÓN: u < num_usuarios()
+		TramoUsuarios siguiendo(std::uint32_t u) const {
+			return tramo(cabecera->pos_siguiendo_inicio, cabecera->pos_siguiendo, u);
+		}
+		TramoUsuarios seguidores(std::uint32_t u) const {
+			return tramo(cabecera->pos_seguidores_inicio, cabecera->pos_seguidores, u);
+		}
+
+		// Indica si 'seguidor' sigue a 'seguido'
+		// PRECONDICIÓN: seguidor, seguido < num_usuarios()
+		bool sigue_a(std::uint32_t seguidor, std::uint32_t seguido) const {
+			TramoUsuarios lista = siguiendo(seguidor);
+			return std::binary_search(lista.ids, lista.ids + lista.num, seguido);
+		}
+
+		// Devuelve el número de tweets de 'u' y su tweet número 'i'
+		// PRECONDICIÓN: u < num_usuarios(), i < num_tweets(u)
+		unsigned num_tweets(std::uint32_t u) const {
+			const std::uint64_t *inicio = seccion<std::uint64_t>(cabecera->pos_tweets_inicio);
+			return unsigned(inicio[u + 1] - inicio[u]);
+		}
+		VistaTweet tweet(std::uint32_t u, unsigned i) const {
+			const TweetInstantanea &t = seccion<TweetInstantanea>(cabecera->pos_tweets)
+				[seccion<std::uint64_t>(cabecera->pos_tweets_inicio)[u] + i];
+			VistaTweet vista;
+			vista.marca_tiempo = t.marca_tiempo;
+			vista.tweet = std::string_view(cadenas() + t.pos_texto, t.long_texto);
+			return vista;
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE APERTURA Y CIERRE
+
+		// Abre la instantánea 'nom_fic' y devuelve 'OK' a través de 'res'.
+		// Si no se puede abrir, o no es una instantánea válida de esta
+		// versión, se devuelve 'FIC_ERROR' y queda cerrada.
+		void abrir(const std::string &nom_fic, Resultado &res) {
+			cerrar();
+			res = proyectar(nom_fic) ? OK : FIC_ERROR;
+			if (res == OK) {
+				cabecera = reinterpret_cast<const CabeceraInstantanea *>(datos);
+				if (!validar()) {
+					cerrar();
+					res = FIC_ERROR;
+				}
+			}
+		}
+
+		// Cierra la instantánea (los punteros devueltos dejan de ser válidos)
+		void cerrar() {
+#if defined(__INSTANTANEA_MMAP__)
+			if (datos != nullptr && !copia) {
+				munmap(const_cast<char *>(datos), tam);
+			}
+#endif
+			copia.reset();
+			datos = nullptr;
+			tam = 0;
+			cabecera = nullptr;
+		}
+
+	private:
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		// Contenido del fichero y su tamaño
+		const char *datos;
+		std::size_t tam;
+		const CabeceraInstantanea *cabecera;
+		// Copia del fichero cuando no se puede proyectar (en palabras de
+		// 8 bytes, para que las secciones queden alineadas)
+		std::unique_ptr <std::uint64_t[]> copia;
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS
+		//
+		// Sección que empieza en la posición 'pos' del fichero
+		template <typename T>
+		const T * seccion(std::uint64_t pos) const {
+			return reinterpret_cast<const T *>(datos + pos);
+		}
+		const char * cadenas() const {
+			return datos + cabecera->pos_cadenas;
+		}
+
+		// Lista 'u' de un CSR guardado en el fichero
+		TramoUsuarios tramo(std::uint64_t pos_inicio, std::uint64_t pos_ids, std::uint32_t u) const {
+			const std::uint64_t *inicio = seccion<std::uint64_t>(pos_inicio);
+			TramoUsuarios lista;
+			lista.ids = seccion<std::uint32_t>(pos_ids) + inicio[u];
+			lista.num = std::size_t(inicio[u + 1] - inicio[u]);
+			return lista;
+		}
+
+		// Proyecta el fichero en memoria (o lo lee entero en 'copia')
+		bool proyectar(const std::string &nom_fic) {
+			bool correcto = false;
+#if defined(__INSTANTANEA_MMAP__)
+			int fd = ::open(nom_fic.c_str(), O_RDONLY);
+			if (fd >= 0) {
+				struct stat info;
+				if (fstat(fd, &info) == 0 && info.st_size > 0) {
+					void *p = mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+					if (p != MAP_FAILED) {
+						datos = static_cast<const char *>(p);
+						tam = std::size_t(info.st_size);
+						correcto = true;
+					}
+				}
+				::close(fd);
+			}
+#else
+			std::ifstream fic(nom_fic, std::ios::binary | std::ios::ate);
+			if (fic) {
+				std::streamoff longitud = fic.tellg();
+				if (longitud > 0) {
+					copia.reset(new std::uint64_t[(std::size_t(longitud) + 7) / 8]);
+					fic.seekg(0);
+					correcto = bool(fic.read(reinterpret_cast<char *>(copia.get()), longitud));
+					datos = reinterpret_cast<const char *>(copia.get());
+					tam = std::size_t(longitud);
+				}
+			}
+#endif
+			return correcto;
+		}
+
+		// Indica si la sección de 'num' elementos de tamaño 'tam_elem' que
+		// empieza en 'pos' está alineada y dentro del fichero
+		bool seccion_valida(std::uint64_t pos, std::uint64_t num, std::size_t tam_elem) const {
+			return pos % 8 == 0 && pos <= tam && num <= (tam - pos) / tam_elem;
+		}
+
+		// Indica si un vector de inicios de CSR es creciente, empieza en 0
+		// y termina en 'total'
+		bool inicios_validos(std::uint64_t pos, std::uint64_t total) const {
+			const std::uint64_t *inicio = seccion<std::uint64_t>(pos);
+			bool valido = (inicio[0] == 0) && (inicio[num_usuarios()] == total);
+			for (std::uint32_t u = 0; u < num_usuarios() && valido; u++) {
+				valido = inicio[u] <= inicio[u + 1];
+			}
+			return valido;
+		}
+
+		// Indica si cada lista de un CSR (ya con inicios válidos) es
+		// estrictamente creciente y sus usuarios son menores que 'n'
+		bool listas_validas(std::uint64_t pos_inicio, std::uint64_t pos_ids, std::uint64_t n) const {
+			bool valido = true;
+			for (std::uint32_t u = 0; u < num_usuarios() && valido; u++) {
+				TramoUsuarios lista = tramo(pos_inicio, pos_ids, u);
+				for (std::size_t i = 0; i < lista.num && valido; i++) {
+					valido = lista.ids[i] < n && (i == 0 || lista.ids[i - 1] < lista.ids[i]);
+				}
+			}
+			return valido;
+		}
+
+		// Comprueba la cabecera y que todas las posiciones y números de
+		// usuario del fichero estén dentro de sus límites, para que las
+		// consultas no tengan que hacerlo. También comprueba lo que dan
+		// por supuesto las búsquedas binarias: que cada lista del CSR está
+		// ordenada y sin repetidos, que orden_nombres ordena los nombres
+		// (y, por tanto, que no hay dos usuarios con el mismo nombre) y que
+		// los seguidores son exactamente los inversos de los seguidos.
+		bool validar() const {
+			if (tam < sizeof(CabeceraInstantanea)) {
+				return false;
+			}
+			const CabeceraInstantanea &c = *cabecera;
+			std::uint64_t n = c.num_usuarios;
+			bool valido = std::memcmp(c.magia, MAGIA_INSTANTANEA, sizeof(c.magia)) == 0
+				&& c.version == VERSION_INSTANTANEA && c.orden_bytes == MARCA_ORDEN_BYTES
+				&& c.tam_fichero == tam
+				&& seccion_valida(c.pos_usuarios, n, sizeof(UsuarioInstantanea))
+				&& seccion_valida(c.pos_orden_nombres, n, sizeof(std::uint32_t))
+				&& seccion_valida(c.pos_siguiendo_inicio, n + 1, sizeof(std::uint64_t))
+				&& seccion_valida(c.pos_siguiendo, c.num_aristas, sizeof(std::uint32_t))
+				&& seccion_valida(c.pos_seguidores_inicio, n + 1, sizeof(std::uint64_t))
+				&& seccion_valida(c.pos_seguidores, c.num_aristas, sizeof(std::uint32_t))
+				&& seccion_valida(c.pos_tweets_inicio, n + 1, sizeof(std::uint64_t))
+				&& seccion_valida(c.pos_tweets, c.num_tweets, sizeof(TweetInstantanea))
+				&& seccion_valida(c.pos_cadenas, c.tam_cadenas, 1);
+			valido = valido && inicios_validos(c.pos_siguiendo_inicio, c.num_aristas)
+				&& inicios_validos(c.pos_seguidores_inicio, c.num_aristas)
+				&& inicios_validos(c.pos_tweets_inicio, c.num_tweets);
+			if (valido) {
+				// Las secciones están dentro del fichero: se comprueba su contenido
+				const UsuarioInstantanea *usuarios = seccion<UsuarioInstantanea>(c.pos_usuarios);
+				const std::uint32_t *orden = seccion<std::uint32_t>(c.pos_orden_nombres);
+				for (std::uint64_t u = 0; u < n && valido; u++) {
+					valido = usuarios[u].pos_nombre <= c.tam_cadenas
+						&& usuarios[u].long_nombre <= c.tam_cadenas - usuarios[u].pos_nombre
+						&& orden[u] < n;
+				}
+				for (std::uint64_t i = 1; i < n && valido; i++) {
+					valido = nombre(orden[i - 1]) < nombre(orden[i]);
+				}
+				valido = valido && listas_validas(c.pos_siguiendo_inicio, c.pos_siguiendo, n)
+					&& listas_validas(c.pos_seguidores_inicio, c.pos_seguidores, n);
+				// Hay tantos seguidores como seguidos y no se repiten: basta
+				// con que cada seguimiento aparezca también al revés
+				for (std::uint32_t u = 0; u < n && valido; u++) {
+					TramoUsuarios lista = siguiendo(u);
+					for (std::size_t i = 0; i < lista.num && valido; i++) {
+						TramoUsuarios inversa = seguidores(lista.ids[i]);
+						valido = std::binary_search(inversa.ids, inversa.ids + inversa.num, u);
+					}
+				}
+				const TweetInstantanea *tweets = seccion<TweetInstantanea>(c.pos_tweets);
+				for (std::uint64_t t = 0; t < c.num_tweets && valido; t++) {
+					valido = tweets[t].pos_texto <= c.tam_cadenas
+						&& tweets[t].long_texto <= c.tam_cadenas - tweets[t].pos_texto;
+				}
+			}
+			return valido;
+		}
+	};
+}
+#endif
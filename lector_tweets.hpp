@@ -0,0 +1,151 @@
+/****************************************************************************
+* Lector de ficheros de tweets (.twt)
+*
+* Analizador de los ficheros que escribe UsuarioTwitter::guardar_tweets,
+* una línea por tweet:
+*
+*   dia mes anyo hora minuto segundo texto del tweet
+*
+* El fichero se lee en bloques grandes (TAM_BLOQUE_LECTURA) y cada línea
+* se analiza directamente sobre el bloque: los seis campos de la fecha se
+* convierten con std::from_chars (sin locale ni flujos) y el texto se
+* entrega como un puntero y una longitud dentro del bloque, sin crear
+* cadenas temporales. Las líneas mal formadas o con una fecha fuera de
+* rango (p. ej., el 30 de febrero o la hora 24) no detienen la lectura: se
+* anota su número de línea y se continúa con la siguiente.
+****************************************************************************/
+
+#ifndef __LECTOR__TWEETS__
+#define __LECTOR__TWEETS__
+#include <string>
+#include <vector>
+#include <fstream>
+#include <charconv>
+#include <cstring>
+#include <cstddef>
+
+namespace {
+	const std::size_t TAM_BLOQUE_LECTURA = 1 << 20; // Bytes que se leen del fichero de cada vez
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Línea de un fichero de tweets ya analizada. El texto apunta al bloque
+	// de lectura y solo es válido durante la llamada que lo recibe.
+	struct LineaTweet {
+		unsigned dia, mes, anyo, hora, minuto, segundo;
+		const char *texto;
+		std::size_t longitud;
+	};
+
+	//---------------------------------------------------------------------------
+	// FUNCIONES DE LECTURA
+
+	// Indica si la fecha y hora existen: mes entre 1 y 12, día entre 1 y
+	// los días de ese mes (29 en febrero de los años bisiestos), hora
+	// hasta 23 y minuto y segundo hasta 59
+	inline bool fecha_hora_valida(unsigned dia, unsigned mes, unsigned anyo,
+		unsigned hora, unsigned minuto, unsigned segundo) {
+		const unsigned DIAS_MES[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+		bool valida = mes >= 1 && mes <= 12 && hora <= 23 && minuto <= 59 && segundo <= 59;
+		if (valida) {
+			bool bisiesto = (anyo % 4 == 0 && anyo % 100 != 0) || anyo % 400 == 0;
+			unsigned dias_mes = DIAS_MES[mes - 1] + ((mes == 2 && bisiesto) ? 1 : 0);
+			valida = dia >= 1 && dia <= dias_mes;
+		}
+		return valida;
+	}
+
+	// Analiza la línea [inicio, fin) (sin el salto de línea). Devuelve
+	// false si no empieza por seis números naturales separados por
+	// espacios o tabuladores o si la fecha y hora que forman no existen
+	// (ver fecha_hora_valida). El texto es lo que sigue al separador del
+	// sexto número (puede estar vacío).
+	inline bool analizar_linea_tweet(const char *inicio, const char *fin, LineaTweet &linea) {
+		unsigned *campos[6] = { &linea.dia, &linea.mes, &linea.anyo, &linea.hora, &linea.minuto, &linea.segundo };
+		const char *p = inicio;
+		bool correcta = true;
+		for (unsigned i = 0; i < 6 && correcta; i++) {
+			while (p < fin && (*p == ' ' || *p == '\t')) {
+				p++;
+			}
+			std::from_chars_result leido = std::from_chars(p, fin, *campos[i]);
+			// Cada número debe terminar en un separador o, el último, en
+			// el final de la línea
+			correcta = leido.ec == std::errc() && (leido.ptr == fin ? i == 5 : (*leido.ptr == ' ' || *leido.ptr == '\t'));
+			p = leido.ptr;
+		}
+		correcta = correcta && fecha_hora_valida(linea.dia, linea.mes, linea.anyo, linea.hora, linea.minuto, linea.segundo);
+		if (correcta) {
+			if (p < fin) {
+				p++;
+			}
+			linea.texto = p;
+			linea.longitud = std::size_t(fin - p);
+		}
+		return correcta;
+	}
+
+	// Lee el fichero de tweets 'nom_fic' y llama a 'funcion(linea)' con
+	// cada línea correcta, en orden. Las líneas vacías (o solo con
+	// espacios) se saltan; los números de las líneas mal formadas o con
+	// una fecha que no existe (desde 1) se devuelven a través de 'lineas_erroneas'. Admite finales de
+	// línea "\n" y "\r\n". Devuelve false si no se puede abrir el fichero.
+	template <typename Funcion>
+	bool leer_fichero_tweets(const std::string &nom_fic, std::vector <unsigned> &lineas_erroneas, Funcion funcion) {
+		std::ifstream fichero(nom_fic.c_str(), std::ios::binary);
+		std::vector <char> bloque(TAM_BLOQUE_LECTURA);
+		std::size_t ocupado = 0;
+		unsigned num_linea = 0;
+		bool fin_fichero = !fichero;
+		LineaTweet linea;
+		lineas_erroneas.clear();
+		// Analiza la línea [inicio, fin)
+		auto procesar = [&lineas_erroneas, &num_linea, &linea, &funcion](const char *inicio, const char *fin) {
+			num_linea++;
+			if (fin > inicio && fin[-1] == '\r') {
+				fin--;
+			}
+			const char *p = inicio;
+			while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r')) {
+				p++;
+			}
+			if (p < fin) {
+				if (analizar_linea_tweet(p, fin, linea)) {
+					funcion(static_cast<const LineaTweet &>(linea));
+				}
+				else {
+					lineas_erroneas.push_back(num_linea);
+				}
+			}
+		};
+		while (!fin_fichero) {
+			// Una línea más larga que el bloque: se amplía
+			if (ocupado == bloque.size()) {
+				bloque.resize(2 * bloque.size());
+			}
+			std::streamsize leidos = fichero.rdbuf()->sgetn(bloque.data() + ocupado, std::streamsize(bloque.size() - ocupado));
+			fin_fichero = leidos <= 0;
+			ocupado += std::size_t(leidos > 0 ? leidos : 0);
+			const char *p = bloque.data(), *fin = bloque.data() + ocupado;
+			const char *salto = static_cast<const char *>(std::memchr(p, '\n', std::size_t(fin - p)));
+			while (salto != nullptr) {
+				procesar(p, salto);
+				p = salto + 1;
+				salto = static_cast<const char *>(std::memchr(p, '\n', std::size_t(fin - p)));
+			}
+			// Última línea, sin salto de línea al final
+			if (fin_fichero && p < fin) {
+				procesar(p, fin);
+				p = fin;
+			}
+			// La línea incompleta pasa al principio del bloque
+			ocupado = std::size_t(fin - p);
+			std::memmove(bloque.data(), p, ocupado);
+		}
+		return bool(fichero);
+	}
+}
+#endif
@@ -0,0 +1,121 @@
+/****************************************************************************
+* Aplicación de lotes de operaciones sobre muchos usuarios
+*
+* aplicar_lote() aplica un vector de operaciones (altas y bajas de
+* seguidores y seguidos y tweets nuevos) sobre un conjunto de usuarios y
+* devuelve el resultado de cada una en el mismo orden que las operaciones.
+*
+* Las operaciones se reparten en fragmentos según un hash del usuario al
+* que afectan, de modo que todas las de un mismo usuario caen en el mismo
+* fragmento y se aplican en su orden original; operaciones de usuarios
+* distintos no tienen orden entre sí. Los fragmentos se ejecutan en
+* paralelo en una ReservaHilos (con robo de trabajo) y cada uno modifica
+* solo sus propios usuarios, sin cerrojos.
+*
+* Las operaciones identifican a los usuarios por su IdUsuario (los nombres
+* deben registrarse antes en la tabla de símbolos, que no admite
+* modificaciones concurrentes).
+****************************************************************************/
+
+#ifndef __LOTE__OPERACIONES__
+#define __LOTE__OPERACIONES__
+#include <vector>
+#include <cstdint>
+#include "usuario_twitter.hpp"
+#include "reserva_hilos.hpp"
+
+namespace {
+	const unsigned FRAGMENTOS_POR_HILO = 4; // Fragmentos por hilo, para que el robo de trabajo equilibre la carga
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Operaciones sobre un usuario (los métodos de UsuarioTwitter del mismo
+	// nombre)
+	enum TipoOperacionUsuario {
+		OPU_NUEVO_SEGUIDOR,
+		OPU_NUEVO_SIGUIENDO,
+		OPU_ELIMINAR_SEGUIDOR,
+		OPU_ELIMINAR_SIGUIENDO,
+		OPU_NUEVO_TWEET
+	};
+	// Operación de un lote: 'usuario' es el usuario que se modifica y
+	// 'otro' el seguidor o seguido (en las operaciones de usuarios) o
+	// 'tweet' el tweet nuevo (en OPU_NUEVO_TWEET)
+	struct OperacionUsuario {
+		TipoOperacionUsuario tipo;
+		IdUsuario usuario;
+		IdUsuario otro;
+		Tweet tweet;
+	};
+
+	//---------------------------------------------------------------------------
+	// FUNCIONES
+
+	// Aplica una operación a 'usuario' y devuelve su resultado
+	inline Resultado aplicar_operacion(UsuarioTwitter &usuario, const OperacionUsuario &operacion) {
+		Resultado res = OK;
+		switch (operacion.tipo) {
+		case OPU_NUEVO_SEGUIDOR:
+			usuario.nuevo_seguidor(operacion.otro, res);
+			break;
+		case OPU_NUEVO_SIGUIENDO:
+			usuario.nuevo_siguiendo(operacion.otro, res);
+			break;
+		case OPU_ELIMINAR_SEGUIDOR:
+			usuario.eliminar_seguidor(operacion.otro, res);
+			break;
+		case OPU_ELIMINAR_SIGUIENDO:
+			usuario.eliminar_siguiendo(operacion.otro, res);
+			break;
+		case OPU_NUEVO_TWEET:
+			usuario.nuevo_tweet(operacion.tweet, res);
+			break;
+		}
+		return res;
+	}
+
+	// Devuelve el fragmento (de 0 a 'num_fragmentos' - 1) al que pertenece
+	// el usuario. Hash multiplicativo: los identificadores son consecutivos
+	// y así se reparten de forma uniforme.
+	inline unsigned fragmento_usuario(IdUsuario usuario, unsigned num_fragmentos) {
+		return unsigned(((std::uint64_t(usuario) * 0x9E3779B97F4A7C15ULL) >> 32) % num_fragmentos);
+	}
+
+	// Aplica las operaciones a los usuarios ('usuarios' está indexado por
+	// IdUsuario) usando los hilos de 'reserva', y devuelve a través de
+	// 'resultados' el resultado de cada operación, en el mismo orden. Las
+	// operaciones de un mismo usuario se aplican en su orden; las de un
+	// usuario que no está en 'usuarios' devuelven 'NO_EXISTE'.
+	inline void aplicar_lote(ReservaHilos &reserva, std::vector <UsuarioTwitter> &usuarios,
+		const std::vector <OperacionUsuario> &operaciones, std::vector <Resultado> &resultados) {
+		unsigned num_fragmentos = (reserva.num_hilos() + 1) * FRAGMENTOS_POR_HILO;
+		// Posiciones de las operaciones agrupadas por fragmento, sin
+		// alterar el orden dentro de cada uno (ordenación por recuento)
+		std::vector <unsigned> inicio(num_fragmentos + 1, 0);
+		std::vector <unsigned> fragmento(operaciones.size());
+		std::vector <unsigned> orden(operaciones.size());
+		for (std::size_t i = 0; i < operaciones.size(); i++) {
+			fragmento[i] = fragmento_usuario(operaciones[i].usuario, num_fragmentos);
+			inicio[fragmento[i] + 1]++;
+		}
+		for (unsigned f = 0; f < num_fragmentos; f++) {
+			inicio[f + 1] += inicio[f];
+		}
+		std::vector <unsigned> siguiente(inicio.begin(), inicio.end() - 1);
+		for (std::size_t i = 0; i < operaciones.size(); i++) {
+			orden[siguiente[fragmento[i]]++] = unsigned(i);
+		}
+		resultados.resize(operaciones.size());
+		reserva.ejecutar(num_fragmentos, [&usuarios, &operaciones, &resultados, &inicio, &orden](unsigned f) {
+			for (unsigned k = inicio[f]; k < inicio[f + 1]; k++) {
+				const OperacionUsuario &operacion = operaciones[orden[k]];
+				resultados[orden[k]] = (operacion.usuario < usuarios.size()) ?
+					aplicar_operacion(usuarios[operacion.usuario], operacion) : NO_EXISTE;
+			}
+		});
+	}
+}
+#endif
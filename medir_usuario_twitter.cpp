@@ -0,0 +1,373 @@
+/****************************************************************************
+* Pruebas de rendimiento del TAD UsuarioTwitter
+*
+* Genera redes sintéticas de varios tamaños (ver generar_red) y mide, para
+* cada una, las operaciones principales del TAD: nuevo_seguidor,
+* me_sigue (la búsqueda de usuarios), nuevo_tweet, imprimir_tweets,
+* guardar_todo, cargar_todo, eliminar_seguidor y el crecimiento de un
+* vector de usuarios (que los traslada al realojarse). Cada medida se repite
+* varias veces sobre una red nueva y se escribe el mínimo y la mediana
+* del tiempo por operación en formato JSON, para poder comparar dos
+* ejecuciones. Si se compila con las métricas de UsuarioTwitter
+* (-D__CON_METRICAS__), el JSON incluye también las métricas acumuladas.
+*
+* Uso: medir_usuario_twitter [opciones] [usuarios...]
+*   usuarios               tamaños de las redes (por defecto 1000 10000 100000)
+*   --semilla N            semilla de la red (por defecto 42)
+*   --repeticiones N       repeticiones de cada medida (por defecto 3)
+*   --siguiendo N          usuarios seguidos de media (por defecto 10)
+*   --tweets N             tweets por usuario de media (por defecto 5)
+*   --directorio D         directorio de los ficheros temporales (por defecto .)
+*   --salida F             fichero JSON de resultados (por defecto, la salida estándar)
+****************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "usuario_twitter.hpp"
+#include "generador_red.hpp"
+#include "metricas.hpp"
+
+using namespace std;
+using namespace bblProgII;
+
+namespace {
+	const unsigned USUARIOS_POR_DEFECTO[] = { 1000, 10000, 100000 }; // Tamaños de las redes si no se indican
+	const unsigned MAX_USUARIOS_FICHEROS = 100; // Usuarios (los más seguidos) que se guardan y cargan de fichero
+	const unsigned BUSQUEDAS_POR_SEGUIMIENTO = 2; // Búsquedas con me_sigue por cada seguimiento de la red
+}
+
+// Configuración de una ejecución
+struct Configuracion {
+	vector <unsigned> usuarios;
+	unsigned long long semilla;
+	unsigned repeticiones;
+	unsigned siguiendo_medio;
+	unsigned tweets_medio;
+	string directorio;
+	string salida;
+};
+
+// Tiempos de una operación en una red: uno por repetición, en
+// nanosegundos, para 'operaciones' operaciones
+struct Medida {
+	string operacion;
+	unsigned long long operaciones;
+	vector <double> ns;
+};
+
+// Buffer de salida que descarta todo lo que se escribe, para medir
+// imprimir_tweets sin el coste de la consola
+class BufferNulo : public streambuf {
+public:
+	BufferNulo() {
+		setp(datos, datos + sizeof(datos));
+	}
+protected:
+	int overflow(int c) override {
+		setp(datos, datos + sizeof(datos));
+		return traits_type::not_eof(c);
+	}
+	streamsize xsputn(const char *, streamsize num) override {
+		return num;
+	}
+private:
+	char datos[4096];
+};
+
+// Lee las opciones de la línea de órdenes. Devuelve false si no son
+// válidas.
+bool leer_opciones(int argc, char *argv[], Configuracion &configuracion);
+
+// Mide todas las operaciones en una red de 'num_usuarios' usuarios y
+// añade los tiempos de la repetición a 'medidas'
+void medir_red(const Configuracion &configuracion, unsigned num_usuarios, vector <Medida> &medidas);
+
+// Añade el tiempo 'ns' de 'operaciones' operaciones de 'operacion' a
+// 'medidas'
+void anotar(vector <Medida> &medidas, const string &operacion, unsigned long long operaciones, double ns);
+
+// Escribe en JSON las medidas de todas las redes
+void escribir_json(ostream &salida, const Configuracion &configuracion,
+	const vector <unsigned> &usuarios, const vector < vector <Medida> > &medidas);
+
+// Nanosegundos transcurridos desde 'inicio'
+double ns_desde(chrono::steady_clock::time_point inicio);
+
+
+int main(int argc, char *argv[]) {
+	Configuracion configuracion;
+	int codigo = 0;
+	if (!leer_opciones(argc, argv, configuracion)) {
+		cerr << "Uso: " << argv[0] << " [--semilla N] [--repeticiones N] [--siguiendo N] [--tweets N]"
+			<< " [--directorio D] [--salida F] [usuarios...]" << endl;
+		codigo = 1;
+	}
+	else {
+		vector < vector <Medida> > medidas(configuracion.usuarios.size());
+		for (size_t i = 0; i < configuracion.usuarios.size(); i++) {
+			for (unsigned r = 0; r < configuracion.repeticiones; r++) {
+				cerr << "Red de " << configuracion.usuarios[i] << " usuarios, repeticion " << r + 1 << endl;
+				medir_red(configuracion, configuracion.usuarios[i], medidas[i]);
+			}
+		}
+		if (configuracion.salida.empty()) {
+			escribir_json(cout, configuracion, configuracion.usuarios, medidas);
+		}
+		else {
+			ofstream fichero(configuracion.salida.c_str());
+			escribir_json(fichero, configuracion, configuracion.usuarios, medidas);
+			if (fichero.fail()) {
+				cerr << "Error al escribir " << configuracion.salida << endl;
+				codigo = 1;
+			}
+		}
+	}
+	return codigo;
+}
+
+bool leer_opciones(int argc, char *argv[], Configuracion &configuracion) {
+	bool ok = true;
+	configuracion.semilla = 42;
+	configuracion.repeticiones = 3;
+	configuracion.siguiendo_medio = 10;
+	configuracion.tweets_medio = 5;
+	configuracion.directorio = ".";
+	configuracion.salida = "";
+	for (int i = 1; i < argc && ok; i++) {
+		string opcion = argv[i];
+		bool con_valor = (opcion == "--semilla" || opcion == "--repeticiones" || opcion == "--siguiendo"
+			|| opcion == "--tweets" || opcion == "--directorio" || opcion == "--salida");
+		if (con_valor && i + 1 < argc) {
+			string valor = argv[++i];
+			if (opcion == "--semilla") {
+				configuracion.semilla = strtoull(valor.c_str(), nullptr, 10);
+			}
+			else if (opcion == "--repeticiones") {
+				configuracion.repeticiones = unsigned(strtoul(valor.c_str(), nullptr, 10));
+				ok = configuracion.repeticiones > 0;
+			}
+			else if (opcion == "--siguiendo") {
+				configuracion.siguiendo_medio = unsigned(strtoul(valor.c_str(), nullptr, 10));
+				ok = configuracion.siguiendo_medio > 0;
+			}
+			else if (opcion == "--tweets") {
+				configuracion.tweets_medio = unsigned(strtoul(valor.c_str(), nullptr, 10));
+			}
+			else if (opcion == "--directorio") {
+				configuracion.directorio = valor;
+			}
+			else {
+				configuracion.salida = valor;
+			}
+		}
+		else if (!con_valor && !opcion.empty() && opcion[0] != '-') {
+			unsigned num = unsigned(strtoul(opcion.c_str(), nullptr, 10));
+			ok = num > 0;
+			configuracion.usuarios.push_back(num);
+		}
+		else {
+			ok = false;
+		}
+	}
+	if (configuracion.usuarios.empty()) {
+		configuracion.usuarios.assign(USUARIOS_POR_DEFECTO,
+			USUARIOS_POR_DEFECTO + sizeof(USUARIOS_POR_DEFECTO) / sizeof(USUARIOS_POR_DEFECTO[0]));
+	}
+	return ok;
+}
+
+void medir_red(const Configuracion &configuracion, unsigned num_usuarios, vector <Medida> &medidas) {
+	ParametrosRed parametros;
+	parametros.num_usuarios = num_usuarios;
+	parametros.siguiendo_medio = configuracion.siguiendo_medio;
+	parametros.tweets_medio = configuracion.tweets_medio;
+	parametros.semilla = configuracion.semilla;
+	RedSintetica red;
+	generar_red(parametros, red);
+	vector <UsuarioTwitter> usuarios(num_usuarios);
+	for (unsigned u = 0; u < num_usuarios; u++) {
+		usuarios[u].establecer_id(nombre_usuario_sintetico(u));
+	}
+	Resultado res;
+	unsigned long long correctas = 0;
+	chrono::steady_clock::time_point inicio;
+
+	// nuevo_seguidor: todos los seguimientos, en orden aleatorio
+	inicio = chrono::steady_clock::now();
+	for (size_t i = 0; i < red.seguimientos.size(); i++) {
+		const Seguimiento &seguimiento = red.seguimientos[i];
+		usuarios[seguimiento.seguido].nuevo_seguidor(red.ids[seguimiento.seguidor], res);
+		correctas += (res == OK) ? 1 : 0;
+	}
+	anotar(medidas, "nuevo_seguidor", red.seguimientos.size(), ns_desde(inicio));
+	for (size_t i = 0; i < red.seguimientos.size(); i++) {
+		const Seguimiento &seguimiento = red.seguimientos[i];
+		usuarios[seguimiento.seguidor].nuevo_siguiendo(red.ids[seguimiento.seguido], res);
+	}
+
+	// me_sigue: usuarios consultados con la distribución de los
+	// seguidores y candidatos uniformes, la mitad seguidores reales
+	mt19937_64 aleatorio(configuracion.semilla + 1);
+	unsigned long long num_busquedas = (unsigned long long)(BUSQUEDAS_POR_SEGUIMIENTO) * red.seguimientos.size();
+	vector <Seguimiento> busquedas(num_busquedas);
+	uniform_int_distribution<size_t> seguimiento_al_azar(0, red.seguimientos.size() - 1);
+	uniform_int_distribution<unsigned> usuario_al_azar(0, num_usuarios - 1);
+	for (unsigned long long i = 0; i < num_busquedas && !red.seguimientos.empty(); i++) {
+		busquedas[i] = red.seguimientos[seguimiento_al_azar(aleatorio)];
+		if (i % 2 == 1) {
+			busquedas[i].seguidor = usuario_al_azar(aleatorio);
+		}
+	}
+	unsigned long long encontrados = 0;
+	inicio = chrono::steady_clock::now();
+	for (unsigned long long i = 0; i < num_busquedas; i++) {
+		encontrados += usuarios[busquedas[i].seguido].me_sigue(red.ids[busquedas[i].seguidor]) ? 1 : 0;
+	}
+	anotar(medidas, "me_sigue", num_busquedas, ns_desde(inicio));
+
+	// nuevo_tweet: todos los tweets, en orden cronológico
+	inicio = chrono::steady_clock::now();
+	for (size_t i = 0; i < red.tweets.size(); i++) {
+		usuarios[red.tweets[i].autor].nuevo_tweet(red.tweets[i].tweet, res);
+		correctas += (res == OK) ? 1 : 0;
+	}
+	anotar(medidas, "nuevo_tweet", red.tweets.size(), ns_desde(inicio));
+
+	// imprimir_tweets: todos los tweets de todos los usuarios, sobre una
+	// salida que los descarta
+	BufferNulo nulo;
+	streambuf *consola = cout.rdbuf(&nulo);
+	inicio = chrono::steady_clock::now();
+	for (unsigned u = 0; u < num_usuarios; u++) {
+		usuarios[u].imprimir_tweets(0);
+	}
+	double ns_imprimir = ns_desde(inicio);
+	cout.rdbuf(consola);
+	anotar(medidas, "imprimir_tweets", red.tweets.size(), ns_imprimir);
+
+	// guardar_todo y cargar_todo: los usuarios más seguidos; se cuenta
+	// como operación cada línea de los ficheros
+	unsigned num_ficheros = min(num_usuarios, MAX_USUARIOS_FICHEROS);
+	unsigned long long lineas = 0;
+	vector <string> nombres(num_ficheros);
+	for (unsigned u = 0; u < num_ficheros; u++) {
+		nombres[u] = configuracion.directorio + "/" + nombre_usuario_sintetico(u);
+		lineas += usuarios[u].num_seguidores() + usuarios[u].num_siguiendo() + usuarios[u].num_tweets();
+	}
+	Resultado res_seg, res_sig, res_twt;
+	inicio = chrono::steady_clock::now();
+	for (unsigned u = 0; u < num_ficheros; u++) {
+		usuarios[u].guardar_todo(nombres[u] + ".seg", nombres[u] + ".sig", nombres[u] + ".twt", res_seg, res_sig, res_twt);
+		correctas += (res_seg == OK && res_sig == OK && res_twt == OK) ? 1 : 0;
+	}
+	anotar(medidas, "guardar_todo", lineas, ns_desde(inicio));
+	vector <UsuarioTwitter> cargados(num_ficheros);
+	inicio = chrono::steady_clock::now();
+	for (unsigned u = 0; u < num_ficheros; u++) {
+		cargados[u].cargar_todo(nombres[u] + ".seg", nombres[u] + ".sig", nombres[u] + ".twt", res_seg, res_sig, res_twt);
+		correctas += (res_seg == OK && res_sig == OK && res_twt == OK) ? 1 : 0;
+	}
+	anotar(medidas, "cargar_todo", lineas, ns_desde(inicio));
+	for (unsigned u = 0; u < num_ficheros; u++) {
+		if (cargados[u].num_seguidores() != usuarios[u].num_seguidores() || cargados[u].num_tweets() != usuarios[u].num_tweets()) {
+			cerr << "Error: " << nombres[u] << " no se ha cargado igual que se guardo" << endl;
+		}
+		remove((nombres[u] + ".seg").c_str());
+		remove((nombres[u] + ".sig").c_str());
+		remove((nombres[u] + ".twt").c_str());
+	}
+
+	// eliminar_seguidor: todos los seguimientos, en otro orden aleatorio
+	shuffle(red.seguimientos.begin(), red.seguimientos.end(), aleatorio);
+	inicio = chrono::steady_clock::now();
+	for (size_t i = 0; i < red.seguimientos.size(); i++) {
+		const Seguimiento &seguimiento = red.seguimientos[i];
+		usuarios[seguimiento.seguido].eliminar_seguidor(red.ids[seguimiento.seguidor], res);
+		correctas += (res == OK) ? 1 : 0;
+	}
+	anotar(medidas, "eliminar_seguidor", red.seguimientos.size(), ns_desde(inicio));
+
+	// Crecimiento de un vector: se añaden todos los usuarios, movidos, a
+	// un vector sin reservar, que los traslada cada vez que se realoja
+	unsigned long long tweets_antes = 0, tweets_despues = 0;
+	for (unsigned u = 0; u < num_usuarios; u++) {
+		tweets_antes += usuarios[u].num_tweets();
+	}
+	vector <UsuarioTwitter> crecido;
+	inicio = chrono::steady_clock::now();
+	for (unsigned u = 0; u < num_usuarios; u++) {
+		crecido.push_back(std::move(usuarios[u]));
+	}
+	anotar(medidas, "crecer_vector", num_usuarios, ns_desde(inicio));
+	for (unsigned u = 0; u < num_usuarios; u++) {
+		tweets_despues += crecido[u].num_tweets();
+	}
+
+	// Comprobación de que se han hecho todas las operaciones (y de que el
+	// compilador no puede eliminar las búsquedas)
+	if (correctas != 2 * red.seguimientos.size() + red.tweets.size() + 2 * num_ficheros || encontrados < num_busquedas / 2
+		|| tweets_despues != tweets_antes) {
+		cerr << "Error: resultados inesperados en la red de " << num_usuarios << " usuarios" << endl;
+	}
+}
+
+void anotar(vector <Medida> &medidas, const string &operacion, unsigned long long operaciones, double ns) {
+	size_t i = 0;
+	while (i < medidas.size() && medidas[i].operacion != operacion) {
+		i++;
+	}
+	if (i == medidas.size()) {
+		Medida medida;
+		medida.operacion = operacion;
+		medida.operaciones = operaciones;
+		medidas.push_back(medida);
+	}
+	medidas[i].ns.push_back(ns);
+}
+
+void escribir_json(ostream &salida, const Configuracion &configuracion,
+	const vector <unsigned> &usuarios, const vector < vector <Medida> > &medidas) {
+	salida << "{" << endl;
+	salida << "  \"semilla\": " << configuracion.semilla << "," << endl;
+	salida << "  \"repeticiones\": " << configuracion.repeticiones << "," << endl;
+	salida << "  \"siguiendo_medio\": " << configuracion.siguiendo_medio << "," << endl;
+	salida << "  \"tweets_medio\": " << configuracion.tweets_medio << "," << endl;
+	salida << "  \"resultados\": [";
+	bool primero = true;
+	for (size_t i = 0; i < medidas.size(); i++) {
+		for (size_t j = 0; j < medidas[i].size(); j++) {
+			const Medida &medida = medidas[i][j];
+			vector <double> ns = medida.ns;
+			sort(ns.begin(), ns.end());
+			double operaciones = (medida.operaciones > 0) ? double(medida.operaciones) : 1.0;
+			double ns_min = ns.front() / operaciones;
+			double ns_mediana = ns[ns.size() / 2] / operaciones;
+			salida << (primero ? "" : ",") << endl;
+			salida << "    {\"usuarios\": " << usuarios[i]
+				<< ", \"operacion\": \"" << medida.operacion << "\""
+				<< ", \"operaciones\": " << medida.operaciones
+				<< ", \"ns_por_operacion_min\": " << ns_min
+				<< ", \"ns_por_operacion_mediana\": " << ns_mediana
+				<< ", \"operaciones_por_segundo\": " << ((ns_mediana > 0.0) ? 1e9 / ns_mediana : 0.0) << "}";
+			primero = false;
+		}
+	}
+	salida << endl << "  ]";
+	if (Metricas::activadas()) {
+		salida << "," << endl << "  \"metricas\": ";
+		Metricas::global().volcar_json(salida);
+	}
+	salida << endl << "}" << endl;
+}
+
+double ns_desde(chrono::steady_clock::time_point inicio) {
+	return double(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicio).count());
+}
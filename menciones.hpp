@@ -0,0 +1,106 @@
+/****************************************************************************
+* Menciones entre usuarios
+*
+* Tipos para guardar las menciones que recibe un usuario y funciones para
+* recorrer las menciones (@usuario) del texto de un tweet.
+*
+* La búsqueda del carácter '@' recorre el texto de 16 en 16 bytes con
+* instrucciones SSE2 cuando están disponibles y, si no, de 8 en 8 bytes
+* con operaciones de palabra (SWAR); solo los bytes sueltos del final se
+* comparan de uno en uno.
+****************************************************************************/
+
+#ifndef __MENCIONES__
+#define __MENCIONES__
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "tabla_simbolos.hpp"
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Mención recibida por un usuario: quién la hizo y en qué tweet (número
+	// de tweet dentro de la lista de tweets del autor)
+	struct Mencion {
+		IdUsuario autor;
+		unsigned num_tweet;
+	};
+	// Lista de menciones. Su orden depende de quién la guarda:
+	// UsuarioTwitter la mantiene ordenada por autor y, para cada autor, por
+	// número de tweet (para buscar una mención con búsqueda binaria),
+	// mientras que RedSocial añade cada mención al final al insertar el
+	// tweet, es decir, en el orden en que se han producido.
+	typedef std::vector <Mencion> ListaMenciones;
+
+	//---------------------------------------------------------------------------
+	// FUNCIONES DE EXTRACCIÓN DE MENCIONES
+
+	// Indica si 'c' puede formar parte de un nombre de usuario
+	inline bool es_caracter_nombre(char c) {
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+	}
+
+	// Devuelve la posición de la primera aparición de 'byte' en
+	// texto[desde, longitud), o 'longitud' si no aparece
+	inline std::size_t buscar_byte(const char *texto, std::size_t longitud, std::size_t desde, char byte) {
+#if defined(__GNUC__) && defined(__SSE2__)
+		// 16 bytes por iteración
+		const __m128i patron = _mm_set1_epi8(byte);
+		while (desde + 16 <= longitud) {
+			__m128i bloque = _mm_loadu_si128(reinterpret_cast<const __m128i *>(texto + desde));
+			int mascara = _mm_movemask_epi8(_mm_cmpeq_epi8(bloque, patron));
+			if (mascara != 0) {
+				return desde + std::size_t(__builtin_ctz(unsigned(mascara)));
+			}
+			desde += 16;
+		}
+#endif
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+		// 8 bytes por iteración: el byte más bajo a cero de 'palabra ^ patron'
+		// es la primera aparición de 'byte'
+		const std::uint64_t unos = 0x0101010101010101ULL, altos = 0x8080808080808080ULL;
+		const std::uint64_t patron_palabra = unos * static_cast<unsigned char>(byte);
+		while (desde + 8 <= longitud) {
+			std::uint64_t palabra;
+			std::memcpy(&palabra, texto + desde, 8);
+			palabra ^= patron_palabra;
+			std::uint64_t ceros = (palabra - unos) & ~palabra & altos;
+			if (ceros != 0) {
+				return desde + std::size_t(__builtin_ctzll(ceros) >> 3);
+			}
+			desde += 8;
+		}
+#endif
+		while (desde < longitud && texto[desde] != byte) {
+			desde++;
+		}
+		return desde;
+	}
+
+	// Llama a 'funcion(inicio, longitud)' por cada etiqueta del texto que
+	// empieza por 'marca' ('@' para menciones), sin la marca. Solo cuenta
+	// como etiqueta una marca seguida de al menos un carácter de nombre y
+	// que no va pegada a una palabra anterior (así, "ada@correo" no es una
+	// mención).
+	template <typename Funcion>
+	void recorrer_etiquetas(const char *texto, std::size_t longitud, char marca, Funcion funcion) {
+		std::size_t pos = buscar_byte(texto, longitud, 0, marca);
+		while (pos < longitud) {
+			std::size_t fin = pos + 1;
+			while (fin < longitud && es_caracter_nombre(texto[fin])) {
+				fin++;
+			}
+			if (fin > pos + 1 && (pos == 0 || !es_caracter_nombre(texto[pos - 1]))) {
+				funcion(texto + pos + 1, fin - pos - 1);
+			}
+			pos = buscar_byte(texto, longitud, fin, marca);
+		}
+	}
+}
+#endif
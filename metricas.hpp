@@ -0,0 +1,428 @@
+/****************************************************************************
+* Métricas de las operaciones de UsuarioTwitter
+*
+* Cuenta cuántas veces se llama a cada operación, qué resultado devuelve
+* (OK, LISTA_LLENA, YA_EXISTE...) y cuánto tarda, en un histograma
+* logarítmico de latencias: el cubo b cuenta las llamadas que han tardado
+* entre 2^(b-1) y 2^b - 1 nanosegundos (el cubo 0, menos de 1 ns).
+*
+* Cada hilo anota en sus propios contadores, sin cerrojos ni escrituras
+* compartidas; al consultar las métricas se suman los de todos los hilos.
+* Leer el reloj cuesta tanto como las operaciones más rápidas, por lo
+* que la latencia se mide solo en una de cada MUESTREO_LATENCIA llamadas
+* a cada operación en cada hilo (las llamadas y los resultados se
+* cuentan todos).
+*
+* Las métricas solo se compilan si se define __CON_METRICAS__ (p. ej.,
+* con -D__CON_METRICAS__). Si no, MedidaOperacion es una clase vacía que
+* el compilador elimina y todas las operaciones figuran sin llamadas.
+****************************************************************************/
+
+#ifndef __METRICAS__
+#define __METRICAS__
+#include <ostream>
+#include <cstdint>
+#if defined(__CON_METRICAS__)
+#include <atomic>
+#include <chrono>
+#endif
+#if defined(__GNUC__)
+// Código de cada llamada: siempre en línea, dentro de la operación
+#define __METRICAS_EN_LINEA__ __attribute__((always_inline))
+// Código que se ejecuta pocas veces: fuera de línea y lejos del código
+// de las operaciones
+#define __METRICAS_FRIO__ __attribute__((noinline, cold))
+#else
+#define __METRICAS_EN_LINEA__
+#define __METRICAS_FRIO__
+#endif
+
+namespace {
+	const unsigned NUM_RESULTADOS_METRICAS = 5; // Resultados que se cuentan: de OK (0) a FIC_ERROR (4)
+	const unsigned NUM_CUBOS_LATENCIA = 32; // Cubos del histograma de latencias (el último, 2^30 ns o más)
+	const unsigned MUESTREO_LATENCIA = 32; // Se mide la latencia de una de cada MUESTREO_LATENCIA llamadas
+	const char * const NOMBRES_RESULTADOS_METRICAS[NUM_RESULTADOS_METRICAS] = {
+		"OK", "LISTA_LLENA", "YA_EXISTE", "NO_EXISTE", "FIC_ERROR"
+	};
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Operaciones medidas (los métodos de UsuarioTwitter del mismo nombre;
+	// las que aceptan un nombre o un IdUsuario se cuentan una sola vez, y
+	// MET_SEGUIDORES_* cuenta tanto obtener_seguidores_* como
+	// num_seguidores_*)
+	enum OperacionMetrica {
+		MET_OBTENER_SEGUIDORES,
+		MET_OBTENER_SIGUIENDO,
+		MET_OBTENER_TWEETS,
+		MET_OBTENER_TWEETS_ENTRE,
+		MET_NUM_TWEETS_ENTRE,
+		MET_ME_SIGUE,
+		MET_ESTOY_SIGUIENDO,
+		MET_SEGUIDORES_MUTUOS,
+		MET_SEGUIDORES_COMUNES,
+		MET_SEGUIDORES_EXCEPTO,
+		MET_OBTENER_MENCIONES,
+		MET_QUIEN_ME_MENCIONA,
+		MET_MENCIONES_DE,
+		MET_IMPRIMIR_SEGUIDORES,
+		MET_IMPRIMIR_SIGUIENDO,
+		MET_IMPRIMIR_TWEETS,
+		MET_GUARDAR_SEGUIDORES,
+		MET_GUARDAR_SIGUIENDO,
+		MET_GUARDAR_TWEETS,
+		MET_GUARDAR_TODO,
+		MET_NUEVO_SEGUIDOR,
+		MET_NUEVO_SIGUIENDO,
+		MET_NUEVO_SEGUIDORES,
+		MET_NUEVO_SIGUIENDOS,
+		MET_NUEVO_TWEET,
+		MET_NUEVA_MENCION,
+		MET_ELIMINAR_SEGUIDOR,
+		MET_ELIMINAR_SIGUIENDO,
+		MET_CARGAR_SEGUIDORES,
+		MET_CARGAR_SIGUIENDO,
+		MET_CARGAR_TWEETS,
+		MET_CARGAR_TODO,
+		NUM_OPERACIONES_METRICAS
+	};
+	// Métricas de una operación, sumadas las de todos los hilos.
+	// 'resultados' solo cuenta las operaciones que devuelven un Resultado;
+	// 'muestras' es el número de llamadas cuya latencia se ha medido y
+	// 'ns_muestras', la suma de sus latencias.
+	struct EstadisticasOperacion {
+		std::uint64_t llamadas;
+		std::uint64_t resultados[NUM_RESULTADOS_METRICAS];
+		std::uint64_t muestras;
+		std::uint64_t ns_muestras;
+		std::uint64_t latencias[NUM_CUBOS_LATENCIA];
+	};
+
+	//---------------------------------------------------------------------------
+	// FUNCIONES
+
+	// Devuelve el nombre de la operación
+	inline const char * nombre_operacion_metrica(OperacionMetrica operacion) {
+		static const char * const nombres[NUM_OPERACIONES_METRICAS] = {
+			"obtener_seguidores", "obtener_siguiendo", "obtener_tweets", "obtener_tweets_entre",
+			"num_tweets_entre", "me_sigue", "estoy_siguiendo", "seguidores_mutuos",
+			"seguidores_comunes", "seguidores_excepto", "obtener_menciones",
+			"quien_me_menciona", "menciones_de", "imprimir_seguidores", "imprimir_siguiendo",
+			"imprimir_tweets", "guardar_seguidores", "guardar_siguiendo", "guardar_tweets",
+			"guardar_todo", "nuevo_seguidor", "nuevo_siguiendo", "nuevo_seguidores", "nuevo_siguiendos",
+			"nuevo_tweet", "nueva_mencion",
+			"eliminar_seguidor", "eliminar_siguiendo", "cargar_seguidores", "cargar_siguiendo",
+			"cargar_tweets", "cargar_todo"
+		};
+		return nombres[operacion];
+	}
+
+	// Devuelve el cubo del histograma de latencias de 'ns' nanosegundos:
+	// el número de bits de 'ns', como máximo NUM_CUBOS_LATENCIA - 1
+	inline unsigned cubo_latencia(std::uint64_t ns) {
+		unsigned cubo = 0;
+#if defined(__GNUC__)
+		cubo = (ns == 0) ? 0 : 64 - unsigned(__builtin_clzll(ns));
+#else
+		while ((ns >> cubo) != 0 && cubo < 64) {
+			cubo++;
+		}
+#endif
+		return (cubo < NUM_CUBOS_LATENCIA) ? cubo : NUM_CUBOS_LATENCIA - 1;
+	}
+
+	// Devuelve la latencia (cota superior, en ns) por debajo de la que
+	// está la fracción 'percentil' (de 0 a 1) de las muestras, o 0 si no
+	// hay muestras
+	inline std::uint64_t percentil_latencia(const EstadisticasOperacion &estadisticas, double percentil) {
+		std::uint64_t cota = 0, acumuladas = 0;
+		double objetivo = percentil * double(estadisticas.muestras);
+		unsigned cubo = 0;
+		while (cubo < NUM_CUBOS_LATENCIA && estadisticas.muestras > 0 && (acumuladas == 0 || double(acumuladas) < objetivo)) {
+			acumuladas += estadisticas.latencias[cubo];
+			cota = (std::uint64_t(1) << cubo) - 1;
+			cubo++;
+		}
+		return cota;
+	}
+
+	class Metricas {
+	public:
+		// Devuelve las métricas del proceso
+		static Metricas & global() {
+			static Metricas metricas;
+			return metricas;
+		}
+
+		// Indica si las métricas se han compilado (__CON_METRICAS__)
+		static bool activadas() {
+#if defined(__CON_METRICAS__)
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+
+		// Devuelve a través de 'estadisticas' las métricas de 'operacion'
+		void obtener(OperacionMetrica operacion, EstadisticasOperacion &estadisticas) const {
+			estadisticas = EstadisticasOperacion();
+#if defined(__CON_METRICAS__)
+			for (const ContadoresHilo *c = contadores.load(std::memory_order_acquire); c != nullptr; c = c->siguiente) {
+				const ContadoresOperacion &contadores_op = c->operaciones[operacion];
+				estadisticas.llamadas += contadores_op.llamadas.load(std::memory_order_relaxed);
+				for (unsigned r = 0; r < NUM_RESULTADOS_METRICAS; r++) {
+					estadisticas.resultados[r] += contadores_op.resultados[r].load(std::memory_order_relaxed);
+				}
+				estadisticas.muestras += contadores_op.muestras.load(std::memory_order_relaxed);
+				estadisticas.ns_muestras += contadores_op.ns_muestras.load(std::memory_order_relaxed);
+				for (unsigned b = 0; b < NUM_CUBOS_LATENCIA; b++) {
+					estadisticas.latencias[b] += c->latencias[operacion][b].load(std::memory_order_relaxed);
+				}
+			}
+#else
+			(void)operacion;
+#endif
+		}
+
+		// Escribe en 'salida' una línea por cada operación que se ha
+		// llamado alguna vez: llamadas, resultados distintos de cero y
+		// latencia media y percentiles 50, 90 y 99 de las muestras
+		void volcar_texto(std::ostream &salida) const {
+			EstadisticasOperacion estadisticas;
+			for (unsigned op = 0; op < NUM_OPERACIONES_METRICAS; op++) {
+				obtener(OperacionMetrica(op), estadisticas);
+				if (estadisticas.llamadas > 0) {
+					salida << nombre_operacion_metrica(OperacionMetrica(op)) << ": " << estadisticas.llamadas << " llamadas";
+					for (unsigned r = 0; r < NUM_RESULTADOS_METRICAS; r++) {
+						if (estadisticas.resultados[r] > 0) {
+							salida << ", " << NOMBRES_RESULTADOS_METRICAS[r] << " " << estadisticas.resultados[r];
+						}
+					}
+					if (estadisticas.muestras > 0) {
+						salida << "; latencia (" << estadisticas.muestras << " muestras): media "
+							<< estadisticas.ns_muestras / estadisticas.muestras << " ns"
+							<< ", p50 < " << percentil_latencia(estadisticas, 0.5) + 1 << " ns"
+							<< ", p90 < " << percentil_latencia(estadisticas, 0.9) + 1 << " ns"
+							<< ", p99 < " << percentil_latencia(estadisticas, 0.99) + 1 << " ns";
+					}
+					salida << std::endl;
+				}
+			}
+		}
+
+		// Escribe en 'salida' las métricas en formato JSON, con el
+		// histograma completo de cada operación que se ha llamado alguna vez
+		void volcar_json(std::ostream &salida) const {
+			EstadisticasOperacion estadisticas;
+			bool primera = true;
+			salida << "{\"activadas\": " << (activadas() ? "true" : "false") << ", \"muestreo_latencia\": "
+				<< MUESTREO_LATENCIA << ", \"operaciones\": [";
+			for (unsigned op = 0; op < NUM_OPERACIONES_METRICAS; op++) {
+				obtener(OperacionMetrica(op), estadisticas);
+				if (estadisticas.llamadas > 0) {
+					salida << (primera ? "" : ",") << std::endl;
+					salida << "  {\"operacion\": \"" << nombre_operacion_metrica(OperacionMetrica(op)) << "\""
+						<< ", \"llamadas\": " << estadisticas.llamadas << ", \"resultados\": {";
+					for (unsigned r = 0; r < NUM_RESULTADOS_METRICAS; r++) {
+						salida << (r == 0 ? "" : ", ") << "\"" << NOMBRES_RESULTADOS_METRICAS[r] << "\": " << estadisticas.resultados[r];
+					}
+					salida << "}, \"muestras\": " << estadisticas.muestras
+						<< ", \"ns_muestras\": " << estadisticas.ns_muestras << ", \"latencias\": [";
+					for (unsigned b = 0; b < NUM_CUBOS_LATENCIA; b++) {
+						salida << (b == 0 ? "" : ", ") << estadisticas.latencias[b];
+					}
+					salida << "]}";
+					primera = false;
+				}
+			}
+			salida << std::endl << "]}" << std::endl;
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ACTUALIZACIÓN
+
+		// Pone a cero las métricas. Si otros hilos están anotando a la vez,
+		// pueden perderse o conservarse algunas de sus anotaciones.
+		void reiniciar() {
+#if defined(__CON_METRICAS__)
+			for (ContadoresHilo *c = contadores.load(std::memory_order_acquire); c != nullptr; c = c->siguiente) {
+				for (unsigned op = 0; op < NUM_OPERACIONES_METRICAS; op++) {
+					ContadoresOperacion &contadores_op = c->operaciones[op];
+					contadores_op.llamadas.store(0, std::memory_order_relaxed);
+					for (unsigned r = 0; r < NUM_RESULTADOS_METRICAS; r++) {
+						contadores_op.resultados[r].store(0, std::memory_order_relaxed);
+					}
+					contadores_op.muestras.store(0, std::memory_order_relaxed);
+					contadores_op.ns_muestras.store(0, std::memory_order_relaxed);
+					for (unsigned b = 0; b < NUM_CUBOS_LATENCIA; b++) {
+						c->latencias[op][b].store(0, std::memory_order_relaxed);
+					}
+				}
+			}
+#endif
+		}
+
+#if defined(__CON_METRICAS__)
+	private:
+		friend class MedidaOperacion;
+
+		// Contadores de una operación que se actualizan en cada llamada, en
+		// una sola línea de caché
+		struct alignas(64) ContadoresOperacion {
+			std::atomic<std::uint64_t> llamadas;
+			std::atomic<std::uint64_t> resultados[NUM_RESULTADOS_METRICAS];
+			std::atomic<std::uint64_t> muestras;
+			std::atomic<std::uint64_t> ns_muestras;
+		};
+		// Contadores de un hilo. Solo los modifica el hilo propietario, así
+		// que basta con leer y escribir (sin operaciones atómicas de
+		// lectura-modificación-escritura).
+		struct alignas(64) ContadoresHilo {
+			ContadoresHilo() : en_uso(true), siguiente(nullptr), operaciones(), latencias() {}
+			std::atomic<bool> en_uso;
+			ContadoresHilo *siguiente;
+			ContadoresOperacion operaciones[NUM_OPERACIONES_METRICAS];
+			std::atomic<std::uint64_t> latencias[NUM_OPERACIONES_METRICAS][NUM_CUBOS_LATENCIA];
+		};
+		// Contadores reservados por el hilo actual; al terminar el hilo,
+		// quedan libres para otro (que sigue sumando sobre ellos)
+		struct PropiedadContadores {
+			ContadoresHilo *contadores;
+			PropiedadContadores() : contadores(nullptr) {}
+			~PropiedadContadores() {
+				if (contadores != nullptr) {
+					contadores->en_uso.store(false, std::memory_order_release);
+				}
+			}
+		};
+
+		Metricas() : contadores(nullptr) {}
+
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		// Lista (solo crece) de los contadores de los hilos
+		std::atomic<ContadoresHilo *> contadores;
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS
+		//
+		// Suma 'valor' a un contador del hilo actual
+		static void sumar(std::atomic<std::uint64_t> &contador, std::uint64_t valor) {
+			contador.store(contador.load(std::memory_order_relaxed) + valor, std::memory_order_relaxed);
+		}
+
+		// Devuelve los contadores del hilo actual, reservándolos la primera
+		// vez. El puntero de acceso rápido es trivial (no hay que comprobar
+		// en cada llamada si está construido); el objeto que libera los
+		// contadores al terminar el hilo solo se usa al reservarlos.
+		__METRICAS_EN_LINEA__ static ContadoresHilo & contadores_hilo() {
+			ContadoresHilo *&propios = puntero_contadores_hilo();
+			if (propios == nullptr) {
+				propios = reservar_contadores_hilo();
+			}
+			return *propios;
+		}
+
+		static ContadoresHilo *& puntero_contadores_hilo() {
+			static thread_local ContadoresHilo *propios = nullptr;
+			return propios;
+		}
+
+		__METRICAS_FRIO__ static ContadoresHilo * reservar_contadores_hilo() {
+			thread_local PropiedadContadores propiedad;
+			propiedad.contadores = global().reservar_contadores();
+			return propiedad.contadores;
+		}
+
+		// Reutiliza los contadores de un hilo terminado o añade unos nuevos
+		ContadoresHilo * reservar_contadores() {
+			ContadoresHilo *c = contadores.load(std::memory_order_acquire);
+			bool libres = false;
+			while (c != nullptr && !libres) {
+				libres = !c->en_uso.load(std::memory_order_relaxed) && !c->en_uso.exchange(true, std::memory_order_acquire);
+				if (!libres) {
+					c = c->siguiente;
+				}
+			}
+			if (!libres) {
+				c = new ContadoresHilo();
+				c->siguiente = contadores.load(std::memory_order_relaxed);
+				while (!contadores.compare_exchange_weak(c->siguiente, c, std::memory_order_release, std::memory_order_relaxed)) {
+				}
+			}
+			return c;
+		}
+#else
+	private:
+		Metricas() {}
+#endif
+		Metricas(const Metricas &);
+		Metricas & operator=(const Metricas &);
+	};
+
+	// Medida de una llamada: se declara al principio del método y anota la
+	// llamada al destruirse. Si se le pasa el Resultado del método, cuenta
+	// también el valor que tiene al terminar.
+	class MedidaOperacion {
+	public:
+#if defined(__CON_METRICAS__)
+		__METRICAS_EN_LINEA__ explicit MedidaOperacion(OperacionMetrica operacion, const unsigned *resultado = nullptr) :
+			contadores(Metricas::contadores_hilo()), operacion(operacion), resultado(resultado), muestra(false), inicio() {
+			std::atomic<std::uint64_t> &llamadas = contadores.operaciones[operacion].llamadas;
+			std::uint64_t num_llamada = llamadas.load(std::memory_order_relaxed) + 1;
+			llamadas.store(num_llamada, std::memory_order_relaxed);
+			if (num_llamada % MUESTREO_LATENCIA == 0) {
+				muestra = true;
+				inicio = iniciar_muestra();
+			}
+		}
+
+		__METRICAS_EN_LINEA__ ~MedidaOperacion() {
+			if (muestra) {
+				terminar_muestra(contadores, operacion, inicio);
+			}
+			if (resultado != nullptr && *resultado < NUM_RESULTADOS_METRICAS) {
+				Metricas::sumar(contadores.operaciones[operacion].resultados[*resultado], 1);
+			}
+		}
+
+	private:
+		Metricas::ContadoresHilo &contadores;
+		OperacionMetrica operacion;
+		const unsigned *resultado;
+		bool muestra;
+		std::chrono::steady_clock::time_point inicio;
+
+		// Lo que solo se hace en las llamadas cuya latencia se mide va
+		// aparte, para que el resto de llamadas solo ejecute el código de
+		// los contadores. Son funciones de clase (sin 'this') para que el
+		// compilador pueda tener la medida en registros en lugar de en la
+		// pila.
+		__METRICAS_FRIO__ static std::chrono::steady_clock::time_point iniciar_muestra() {
+			return std::chrono::steady_clock::now();
+		}
+
+		__METRICAS_FRIO__ static void terminar_muestra(Metricas::ContadoresHilo &contadores, OperacionMetrica operacion,
+			std::chrono::steady_clock::time_point inicio) {
+			std::uint64_t ns = std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - inicio).count());
+			Metricas::sumar(contadores.operaciones[operacion].muestras, 1);
+			Metricas::sumar(contadores.operaciones[operacion].ns_muestras, ns);
+			Metricas::sumar(contadores.latencias[operacion][cubo_latencia(ns)], 1);
+		}
+#else
+		explicit MedidaOperacion(OperacionMetrica, const unsigned * = nullptr) {}
+	private:
+#endif
+		MedidaOperacion(const MedidaOperacion &);
+		MedidaOperacion & operator=(const MedidaOperacion &);
+	};
+}
+#endif
@@ -0,0 +1,630 @@
+/****************************************************************************
+* Pruebas de regresión de la red social
+*
+* Genera una red sintética (ver generar_red) y comprueba los módulos que
+* trabajan sobre muchos usuarios contra un cálculo directo de lo que
+* deberían devolver:
+*   - RedSocial: seguidores y seguidos (antes y después de compactar el
+*     grafo), menciones, cronologías (con y sin caché), búsqueda de
+*     palabras, recomendaciones (secuenciales, en paralelo e
+*     incrementales), tendencias e instantáneas (que se rechazan si están
+*     corruptas).
+*   - Tendencias: caducidad de las cubetas fuera de la ventana.
+*   - RedPersistente: recuperación desde el diario y tras compactar, y
+*     sincronización por tiempo de espera.
+*   - aplicar_lote: mismos resultados que aplicar las operaciones en orden.
+*   - leer_fichero_tweets: las fechas que no existen se rechazan.
+*   - UsuarioConcurrente: los lectores ven los cambios de modificar()
+*     completos.
+* Escribe cada comprobación que falla y termina con EXIT_FAILURE si
+* alguna ha fallado. Los ficheros temporales se crean en el directorio
+* actual y se borran al terminar.
+*
+* Uso: probar_red_social
+****************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include "red_social.hpp"
+#include "red_persistente.hpp"
+#include "usuario_concurrente.hpp"
+#include "lote_operaciones.hpp"
+#include "instantanea.hpp"
+#include "tendencias.hpp"
+#include "generador_red.hpp"
+
+using namespace std;
+using namespace bblProgII;
+
+namespace {
+	const unsigned NUM_USUARIOS_PRUEBA = 2000; // Usuarios de la red sintética
+	const unsigned SIGUIENDO_MEDIO_PRUEBA = 10; // Usuarios seguidos de media
+	const unsigned TWEETS_MEDIO_PRUEBA = 5; // Tweets por usuario de media
+	const unsigned long long SEMILLA_PRUEBA = 42; // Semilla de la red sintética
+	const unsigned USUARIOS_CONSULTADOS = 50; // Usuarios de los que se comprueban cronologías y recomendaciones
+	const unsigned TAM_CRONOLOGIA_PRUEBA = 40; // Tweets de cada cronología
+	const unsigned TAM_RECOMENDACION_PRUEBA = 10; // Usuarios de cada recomendación
+	const unsigned HILOS_PRUEBA = 3; // Hilos de las reservas de hilos
+	const unsigned SEGUNDOS_TENDENCIAS_PRUEBA = 3600; // Ventana de las tendencias consultadas
+	const char * const CONSULTA_PRUEBA = "algoritmo maquina"; // Búsqueda de palabras
+	const char * const FIC_INSTANTANEA_PRUEBA = "probar_red_social.red"; // Instantánea temporal
+	const char * const FIC_DIARIO_PRUEBA = "probar_red_social.dia"; // Diario temporal
+	const unsigned MS_SINCRONIZACION_PRUEBA = 20; // Tiempo de espera máximo del diario sin sincronizar
+	const char * const FIC_TWEETS_PRUEBA = "probar_red_social.twt"; // Fichero de tweets temporal
+}
+
+// Seguimientos esperados: (seguidor, seguido)
+typedef set < pair <IdUsuario, IdUsuario> > ModeloSeguimientos;
+
+// Número de comprobaciones que han fallado
+unsigned num_fallos = 0;
+
+// Anota y escribe por pantalla el fallo si 'condicion' es falsa
+void comprobar(bool condicion, const string &descripcion);
+
+// Seguidores y seguidos esperados de 'usuario', ordenados
+void esperados(const ModeloSeguimientos &modelo, IdUsuario usuario, ListaUsuarios &seguidores, ListaUsuarios &siguiendo);
+
+// Indica si 'red' tiene los seguimientos de 'modelo' para los usuarios de 'ids'
+bool mismo_grafo(const RedSocial &red, const ModeloSeguimientos &modelo, const vector <IdUsuario> &ids);
+
+// Indica si dos redes tienen los mismos usuarios, seguimientos y tweets
+bool mismas_redes(const RedSocial &a, const RedSocial &b, const vector <IdUsuario> &ids);
+
+// Texto del tweet 'num_tweet' de 'autor' en 'red'
+string texto_tweet(const RedSocial &red, IdUsuario autor, unsigned num_tweet);
+
+// Pruebas de cada módulo
+void probar_grafo(RedSocial &red, RedSintetica &sintetica, ModeloSeguimientos &modelo);
+void probar_menciones(const RedSocial &red, const vector <IdUsuario> &ids);
+void probar_cronologias(RedSocial &red, const ModeloSeguimientos &modelo, const vector <IdUsuario> &ids);
+void probar_busqueda(const RedSocial &red, const RedSintetica &sintetica);
+void probar_recomendaciones(RedSocial &red, const ModeloSeguimientos &modelo, const vector <IdUsuario> &ids);
+void probar_tendencias(const RedSocial &red, const RedSintetica &sintetica);
+void probar_instantanea(const RedSocial &red, const vector <IdUsuario> &ids);
+void probar_persistente(const RedSintetica &sintetica);
+void probar_lote(const RedSintetica &sintetica);
+void probar_fechas_tweets();
+void probar_concurrente();
+
+
+int main() {
+	ParametrosRed parametros;
+	parametros.num_usuarios = NUM_USUARIOS_PRUEBA;
+	parametros.siguiendo_medio = SIGUIENDO_MEDIO_PRUEBA;
+	parametros.tweets_medio = TWEETS_MEDIO_PRUEBA;
+	parametros.semilla = SEMILLA_PRUEBA;
+	RedSintetica sintetica;
+	generar_red(parametros, sintetica);
+
+	RedSocial red;
+	ModeloSeguimientos modelo;
+	red.activar_tendencias(true);
+	probar_grafo(red, sintetica, modelo);
+	probar_menciones(red, sintetica.ids);
+	probar_cronologias(red, modelo, sintetica.ids);
+	probar_busqueda(red, sintetica);
+	probar_recomendaciones(red, modelo, sintetica.ids);
+	probar_tendencias(red, sintetica);
+	probar_instantanea(red, sintetica.ids);
+	probar_persistente(sintetica);
+	probar_lote(sintetica);
+	probar_fechas_tweets();
+	probar_concurrente();
+
+	if (num_fallos == 0) {
+		cout << "Todas las pruebas son correctas" << endl;
+	}
+	else {
+		cout << num_fallos << " pruebas han fallado" << endl;
+	}
+	return (num_fallos == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void comprobar(bool condicion, const string &descripcion) {
+	if (!condicion) {
+		num_fallos++;
+		cout << "FALLO: " << descripcion << endl;
+	}
+}
+
+void esperados(const ModeloSeguimientos &modelo, IdUsuario usuario, ListaUsuarios &seguidores, ListaUsuarios &siguiendo) {
+	seguidores.clear();
+	siguiendo.clear();
+	for (ModeloSeguimientos::const_iterator it = modelo.begin(); it != modelo.end(); ++it) {
+		if (it->second == usuario) {
+			seguidores.push_back(it->first);
+		}
+		if (it->first == usuario) {
+			siguiendo.push_back(it->second);
+		}
+	}
+	sort(seguidores.begin(), seguidores.end());
+	sort(siguiendo.begin(), siguiendo.end());
+}
+
+bool mismo_grafo(const RedSocial &red, const ModeloSeguimientos &modelo, const vector <IdUsuario> &ids) {
+	// Seguidores y seguidos esperados de todos los usuarios en una pasada
+	map < IdUsuario, ListaUsuarios > seguidores, siguiendo;
+	for (ModeloSeguimientos::const_iterator it = modelo.begin(); it != modelo.end(); ++it) {
+		seguidores[it->second].push_back(it->first);
+		siguiendo[it->first].push_back(it->second);
+	}
+	Usuarios lista;
+	bool iguales = true;
+	for (unsigned u = 0; iguales && u < ids.size(); u++) {
+		ListaUsuarios &seg = seguidores[ids[u]], &sig = siguiendo[ids[u]];
+		sort(seg.begin(), seg.end());
+		sort(sig.begin(), sig.end());
+		red.obtener_seguidores(ids[u], lista);
+		iguales = lista.listado == seg && red.num_seguidores(ids[u]) == seg.size();
+		red.obtener_siguiendo(ids[u], lista);
+		iguales = iguales && lista.listado == sig && red.num_siguiendo(ids[u]) == sig.size();
+	}
+	return iguales;
+}
+
+bool mismas_redes(const RedSocial &a, const RedSocial &b, const vector <IdUsuario> &ids) {
+	Usuarios lista_a, lista_b;
+	bool iguales = a.num_usuarios() == b.num_usuarios();
+	for (unsigned u = 0; iguales && u < ids.size(); u++) {
+		iguales = a.existe_usuario(ids[u]) == b.existe_usuario(ids[u]);
+		if (iguales && a.existe_usuario(ids[u])) {
+			a.obtener_seguidores(ids[u], lista_a);
+			b.obtener_seguidores(ids[u], lista_b);
+			iguales = lista_a.listado == lista_b.listado;
+			a.obtener_siguiendo(ids[u], lista_a);
+			b.obtener_siguiendo(ids[u], lista_b);
+			iguales = iguales && lista_a.listado == lista_b.listado && a.num_tweets(ids[u]) == b.num_tweets(ids[u]);
+			for (unsigned t = 0; iguales && t < a.num_tweets(ids[u]); t++) {
+				iguales = texto_tweet(a, ids[u], t) == texto_tweet(b, ids[u], t)
+					&& a.obtener_tweets(ids[u]).registro(t).marca_tiempo == b.obtener_tweets(ids[u]).registro(t).marca_tiempo;
+			}
+		}
+	}
+	return iguales;
+}
+
+string texto_tweet(const RedSocial &red, IdUsuario autor, unsigned num_tweet) {
+	Tweet tweet;
+	red.obtener_tweets(autor).leer(num_tweet, tweet);
+	return tweet.tweet;
+}
+
+void probar_grafo(RedSocial &red, RedSintetica &sintetica, ModeloSeguimientos &modelo) {
+	Resultado res;
+	unsigned correctas = 0;
+	for (unsigned u = 0; u < sintetica.ids.size(); u++) {
+		red.nuevo_usuario(sintetica.ids[u], res);
+		correctas += (res == OK) ? 1 : 0;
+	}
+	red.nuevo_usuario(sintetica.ids[0], res);
+	comprobar(correctas == sintetica.ids.size() && res == YA_EXISTE && red.num_usuarios() == sintetica.ids.size(),
+		"RedSocial: alta de usuarios");
+
+	correctas = 0;
+	for (size_t i = 0; i < sintetica.seguimientos.size(); i++) {
+		IdUsuario seguidor = sintetica.ids[sintetica.seguimientos[i].seguidor];
+		IdUsuario seguido = sintetica.ids[sintetica.seguimientos[i].seguido];
+		red.seguir(seguidor, seguido, res);
+		correctas += (res == OK) ? 1 : 0;
+		modelo.insert(make_pair(seguidor, seguido));
+	}
+	comprobar(correctas == sintetica.seguimientos.size(), "RedSocial: seguir");
+	red.seguir(sintetica.ids[sintetica.seguimientos[0].seguidor], sintetica.ids[sintetica.seguimientos[0].seguido], res);
+	comprobar(res == YA_EXISTE, "RedSocial: seguir dos veces devuelve YA_EXISTE");
+
+	// Un tercio de los seguimientos se deshacen (sin compactar aún todos)
+	correctas = 0;
+	for (size_t i = 0; i < sintetica.seguimientos.size(); i += 3) {
+		IdUsuario seguidor = sintetica.ids[sintetica.seguimientos[i].seguidor];
+		IdUsuario seguido = sintetica.ids[sintetica.seguimientos[i].seguido];
+		red.dejar_de_seguir(seguidor, seguido, res);
+		correctas += (res == OK) ? 1 : 0;
+		modelo.erase(make_pair(seguidor, seguido));
+	}
+	comprobar(correctas == (sintetica.seguimientos.size() + 2) / 3, "RedSocial: dejar_de_seguir");
+	red.dejar_de_seguir(sintetica.ids[sintetica.seguimientos[0].seguidor], sintetica.ids[sintetica.seguimientos[0].seguido], res);
+	comprobar(res == NO_EXISTE, "RedSocial: dejar de seguir a quien no se sigue devuelve NO_EXISTE");
+	comprobar(mismo_grafo(red, modelo, sintetica.ids), "RedSocial: seguidores y seguidos con cambios pendientes");
+	red.compactar();
+	comprobar(mismo_grafo(red, modelo, sintetica.ids), "RedSocial: seguidores y seguidos tras compactar");
+
+	correctas = 0;
+	for (size_t i = 0; i < sintetica.tweets.size(); i++) {
+		red.nuevo_tweet(sintetica.ids[sintetica.tweets[i].autor], sintetica.tweets[i].tweet, res);
+		correctas += (res == OK) ? 1 : 0;
+	}
+	comprobar(correctas == sintetica.tweets.size(), "RedSocial: nuevo_tweet");
+}
+
+void probar_menciones(const RedSocial &red, const vector <IdUsuario> &ids) {
+	Resultado res;
+	UsuarioTwitter usuario;
+	unsigned long long total = 0;
+	bool correctas = true;
+	for (unsigned u = 0; u < ids.size(); u++) {
+		const ListaMenciones &menciones = red.obtener_menciones(ids[u]);
+		string mencion = "@" + TablaSimbolos::global().nombre(ids[u]);
+		for (unsigned i = 0; correctas && i < menciones.size(); i++) {
+			correctas = texto_tweet(red, menciones[i].autor, menciones[i].num_tweet).find(mencion) != string::npos;
+		}
+		total += menciones.size();
+	}
+	comprobar(correctas && total > 0, "RedSocial: cada mención está en el tweet que indica");
+	red.obtener_usuario(TablaSimbolos::global().nombre(ids[0]), usuario, res);
+	comprobar(res == OK && usuario.num_menciones() == red.num_menciones(ids[0])
+		&& usuario.num_tweets() == red.num_tweets(ids[0]) && usuario.num_seguidores() == red.num_seguidores(ids[0]),
+		"RedSocial: obtener_usuario");
+}
+
+void probar_cronologias(RedSocial &red, const ModeloSeguimientos &modelo, const vector <IdUsuario> &ids) {
+	Cronologia refs;
+	ListaUsuarios seguidores, siguiendo;
+	vector < vector <RefTweet> > esperadas(USUARIOS_CONSULTADOS);
+	bool iguales = true;
+	for (unsigned u = 0; u < USUARIOS_CONSULTADOS; u++) {
+		// Todos los tweets de sus seguidos, del más reciente al más
+		// antiguo, con el mismo desempate que RedSocial::cronologia
+		vector < pair < MarcaTiempo, pair <IdUsuario, unsigned> > > todos;
+		esperados(modelo, ids[u], seguidores, siguiendo);
+		for (unsigned s = 0; s < siguiendo.size(); s++) {
+			for (unsigned t = 0; t < red.num_tweets(siguiendo[s]); t++) {
+				todos.push_back(make_pair(red.obtener_tweets(siguiendo[s]).registro(t).marca_tiempo, make_pair(siguiendo[s], t)));
+			}
+		}
+		sort(todos.rbegin(), todos.rend());
+		for (unsigned i = 0; i < todos.size() && i < TAM_CRONOLOGIA_PRUEBA; i++) {
+			RefTweet ref;
+			ref.autor = todos[i].second.first;
+			ref.num_tweet = todos[i].second.second;
+			esperadas[u].push_back(ref);
+		}
+	}
+	for (unsigned pasada = 0; pasada < 2; pasada++) {
+		for (unsigned u = 0; iguales && u < USUARIOS_CONSULTADOS; u++) {
+			red.cronologia(ids[u], TAM_CRONOLOGIA_PRUEBA, refs);
+			iguales = refs.size() == esperadas[u].size();
+			for (unsigned i = 0; iguales && i < refs.size(); i++) {
+				iguales = refs[i].autor == esperadas[u][i].autor && refs[i].num_tweet == esperadas[u][i].num_tweet;
+			}
+		}
+		comprobar(iguales, (pasada == 0) ? "RedSocial: cronologías" : "RedSocial: cronologías con caché");
+		// Segunda pasada: servidas desde la caché de cronologías
+		red.activar_cache_cronologia(NUM_USUARIOS_PRUEBA, TAM_CRONOLOGIA_PRUEBA);
+	}
+	red.activar_cache_cronologia(0, 0);
+}
+
+void probar_busqueda(const RedSocial &red, const RedSintetica &sintetica) {
+	Cronologia refs, esperadas;
+	map <IdUsuario, unsigned> num_tweet;
+	for (size_t i = 0; i < sintetica.tweets.size(); i++) {
+		IdUsuario autor = sintetica.ids[sintetica.tweets[i].autor];
+		string texto = " " + sintetica.tweets[i].tweet.tweet.substr(0, MAX_LONG_TWEET) + " ";
+		if (texto.find(" algoritmo ") != string::npos && texto.find(" maquina ") != string::npos) {
+			RefTweet ref;
+			ref.autor = autor;
+			ref.num_tweet = num_tweet[autor];
+			esperadas.push_back(ref);
+		}
+		num_tweet[autor]++;
+	}
+	red.buscar_tweets(CONSULTA_PRUEBA, refs);
+	bool iguales = refs.size() == esperadas.size() && !refs.empty();
+	for (unsigned i = 0; iguales && i < refs.size(); i++) {
+		iguales = refs[i].autor == esperadas[i].autor && refs[i].num_tweet == esperadas[i].num_tweet;
+	}
+	comprobar(iguales, "RedSocial: buscar_tweets");
+}
+
+void probar_recomendaciones(RedSocial &red, const ModeloSeguimientos &modelo, const vector <IdUsuario> &ids) {
+	ReservaHilos reserva(HILOS_PRUEBA);
+	vector <Recomendacion> secuencial, paralela, incremental;
+	ListaUsuarios seguidores, siguiendo, de_seguido;
+	bool iguales = true;
+	for (unsigned u = 0; u < USUARIOS_CONSULTADOS; u++) {
+		// Amigos de amigos contados directamente sobre el modelo
+		map <IdUsuario, unsigned> cuentas;
+		vector <Recomendacion> esperadas;
+		esperados(modelo, ids[u], seguidores, siguiendo);
+		for (unsigned s = 0; s < siguiendo.size(); s++) {
+			esperados(modelo, siguiendo[s], seguidores, de_seguido);
+			for (unsigned c = 0; c < de_seguido.size(); c++) {
+				if (de_seguido[c] != ids[u] && !binary_search(siguiendo.begin(), siguiendo.end(), de_seguido[c])) {
+					cuentas[de_seguido[c]]++;
+				}
+			}
+		}
+		for (map <IdUsuario, unsigned>::const_iterator it = cuentas.begin(); it != cuentas.end(); ++it) {
+			Recomendacion recomendacion;
+			recomendacion.usuario = it->first;
+			recomendacion.num_comunes = it->second;
+			esperadas.push_back(recomendacion);
+		}
+		stable_sort(esperadas.begin(), esperadas.end(), [](const Recomendacion &a, const Recomendacion &b) {
+			return a.num_comunes > b.num_comunes;
+		});
+		esperadas.resize(min<size_t>(esperadas.size(), TAM_RECOMENDACION_PRUEBA));
+
+		red.recomendar_seguir(ids[u], TAM_RECOMENDACION_PRUEBA, secuencial);
+		red.recomendar_seguir(ids[u], TAM_RECOMENDACION_PRUEBA, reserva, paralela);
+		iguales = iguales && secuencial.size() == esperadas.size() && paralela.size() == esperadas.size();
+		for (unsigned i = 0; iguales && i < esperadas.size(); i++) {
+			iguales = secuencial[i].usuario == esperadas[i].usuario && secuencial[i].num_comunes == esperadas[i].num_comunes
+				&& paralela[i].usuario == esperadas[i].usuario && paralela[i].num_comunes == esperadas[i].num_comunes;
+		}
+	}
+	comprobar(iguales, "RedSocial: recomendar_seguir secuencial y en paralelo");
+
+	// Recomendaciones incrementales: se activan, se cambian seguimientos
+	// que les afectan y se comparan con las calculadas desde cero
+	Resultado res;
+	for (unsigned u = 0; u < USUARIOS_CONSULTADOS; u++) {
+		red.activar_recomendaciones(ids[u], true);
+	}
+	for (unsigned u = 0; u < USUARIOS_CONSULTADOS; u++) {
+		red.seguir(ids[u], ids[NUM_USUARIOS_PRUEBA - 1 - u], res);
+		red.dejar_de_seguir(ids[u + USUARIOS_CONSULTADOS], ids[0], res);
+		red.seguir(ids[u + 2 * USUARIOS_CONSULTADOS], ids[1], res);
+	}
+	iguales = true;
+	for (unsigned u = 0; iguales && u < USUARIOS_CONSULTADOS; u++) {
+		red.recomendar_seguir(ids[u], TAM_RECOMENDACION_PRUEBA, incremental);
+		red.activar_recomendaciones(ids[u], false);
+		red.recomendar_seguir(ids[u], TAM_RECOMENDACION_PRUEBA, secuencial);
+		iguales = incremental.size() == secuencial.size();
+		for (unsigned i = 0; iguales && i < secuencial.size(); i++) {
+			iguales = incremental[i].usuario == secuencial[i].usuario && incremental[i].num_comunes == secuencial[i].num_comunes;
+		}
+	}
+	comprobar(iguales, "RedSocial: recomendaciones incrementales");
+}
+
+void probar_tendencias(const RedSocial &red, const RedSintetica &sintetica) {
+	// Apariciones exactas de cada etiqueta en las cubetas de la ventana
+	ListaTendencias lista;
+	map <string, unsigned long long> exactas;
+	MarcaTiempo ultima = a_marca_tiempo(sintetica.tweets.back().tweet.fecha_hora);
+	MarcaTiempo primer_periodo = ultima / SEGUNDOS_CUBETA_TENDENCIAS
+		- MarcaTiempo(SEGUNDOS_TENDENCIAS_PRUEBA / SEGUNDOS_CUBETA_TENDENCIAS) + 1;
+	for (size_t i = 0; i < sintetica.tweets.size(); i++) {
+		const string &texto = sintetica.tweets[i].tweet.tweet;
+		if (a_marca_tiempo(sintetica.tweets[i].tweet.fecha_hora) / SEGUNDOS_CUBETA_TENDENCIAS >= primer_periodo) {
+			recorrer_etiquetas(texto.data(), min<size_t>(texto.size(), MAX_LONG_TWEET), '@',
+				[&exactas](const char *nombre, size_t longitud) {
+				exactas["@" + string(nombre, longitud)]++;
+			});
+		}
+	}
+	pair <string, unsigned long long> mas_frecuente("", 0);
+	for (map <string, unsigned long long>::const_iterator it = exactas.begin(); it != exactas.end(); ++it) {
+		if (it->second > mas_frecuente.second) {
+			mas_frecuente = *it;
+		}
+	}
+	red.obtener_tendencias(TAM_RECOMENDACION_PRUEBA, SEGUNDOS_TENDENCIAS_PRUEBA, lista);
+	bool correctas = !lista.empty() && lista[0].apariciones >= mas_frecuente.second;
+	bool esta_mas_frecuente = false;
+	for (unsigned i = 0; correctas && i < lista.size(); i++) {
+		// El sketch puede sobrestimar, pero nunca subestimar
+		correctas = lista[i].apariciones >= exactas[lista[i].etiqueta];
+		esta_mas_frecuente = esta_mas_frecuente || lista[i].etiqueta == mas_frecuente.first;
+	}
+	comprobar(correctas && esta_mas_frecuente, "RedSocial: tendencias de la última hora");
+
+	// Las cubetas que salen de la ventana se olvidan
+	Tendencias tendencias(60, 3, 256, 8);
+	tendencias.anotar(0, "#Antigua @ada #antigua");
+	tendencias.anotar(200, "#nueva");
+	tendencias.obtener_tendencias(10, tendencias.ventana_maxima(), lista);
+	comprobar(lista.size() == 1 && lista[0].etiqueta == "#nueva" && lista[0].apariciones == 1,
+		"Tendencias: las cubetas fuera de la ventana no cuentan");
+	tendencias.anotar(190, "#nueva #Otra");
+	tendencias.obtener_tendencias(10, 60, lista);
+	comprobar(lista.size() == 2 && lista[0].etiqueta == "#nueva" && lista[0].apariciones == 2
+		&& lista[1].etiqueta == "#otra", "Tendencias: recuento de una cubeta");
+}
+
+void probar_instantanea(const RedSocial &red, const vector <IdUsuario> &ids) {
+	Resultado res_guardar, res_cargar;
+	RedSocial cargada;
+	red.guardar_instantanea(FIC_INSTANTANEA_PRUEBA, res_guardar);
+	cargada.cargar_instantanea(FIC_INSTANTANEA_PRUEBA, res_cargar);
+	comprobar(res_guardar == OK && res_cargar == OK && mismas_redes(red, cargada, ids),
+		"RedSocial: instantánea guardada y cargada");
+
+	// Instantáneas corruptas: una lista de seguidos desordenada y dos
+	// usuarios con el mismo nombre
+	ifstream entrada(FIC_INSTANTANEA_PRUEBA, ios::binary);
+	vector <char> original((istreambuf_iterator<char>(entrada)), istreambuf_iterator<char>());
+	entrada.close();
+	CabeceraInstantanea cabecera;
+	memcpy(&cabecera, original.data(), sizeof(cabecera));
+	for (unsigned caso = 0; caso < 2; caso++) {
+		vector <char> datos(original);
+		if (caso == 0) {
+			const uint64_t *inicio = reinterpret_cast<const uint64_t *>(datos.data() + cabecera.pos_siguiendo_inicio);
+			uint32_t *siguiendo = reinterpret_cast<uint32_t *>(datos.data() + cabecera.pos_siguiendo);
+			unsigned u = 0;
+			while (inicio[u + 1] - inicio[u] < 2) {
+				u++;
+			}
+			swap(siguiendo[inicio[u]], siguiendo[inicio[u] + 1]);
+		}
+		else {
+			UsuarioInstantanea *usuarios = reinterpret_cast<UsuarioInstantanea *>(datos.data() + cabecera.pos_usuarios);
+			usuarios[1] = usuarios[0];
+		}
+		ofstream salida(FIC_INSTANTANEA_PRUEBA, ios::binary);
+		salida.write(datos.data(), streamsize(datos.size()));
+		salida.close();
+		cargada.cargar_instantanea(FIC_INSTANTANEA_PRUEBA, res_cargar);
+		comprobar(res_cargar == FIC_ERROR, caso == 0 ? "RedSocial: instantánea con una lista desordenada"
+			: "RedSocial: instantánea con nombres repetidos");
+	}
+	remove(FIC_INSTANTANEA_PRUEBA);
+}
+
+void probar_persistente(const RedSintetica &sintetica) {
+	Resultado res;
+	unsigned correctas = 0, operaciones = 0;
+	remove(FIC_INSTANTANEA_PRUEBA);
+	remove(FIC_DIARIO_PRUEBA);
+	RedPersistente persistente(FIC_INSTANTANEA_PRUEBA, FIC_DIARIO_PRUEBA);
+	persistente.recuperar(res);
+	comprobar(res == OK, "RedPersistente: recuperar sin ficheros");
+	persistente.configurar_sincronizacion(64, 0);
+	// La mitad de la red antes de compactar y la otra mitad después
+	for (unsigned mitad = 0; mitad < 2; mitad++) {
+		for (unsigned u = mitad; u < sintetica.ids.size(); u += 2) {
+			persistente.nuevo_usuario(TablaSimbolos::global().nombre(sintetica.ids[u]), res);
+			correctas += (res == OK) ? 1 : 0;
+			operaciones++;
+		}
+		for (size_t i = mitad; i < sintetica.seguimientos.size(); i += 2) {
+			const string &seguidor = TablaSimbolos::global().nombre(sintetica.ids[sintetica.seguimientos[i].seguidor]);
+			const string &seguido = TablaSimbolos::global().nombre(sintetica.ids[sintetica.seguimientos[i].seguido]);
+			persistente.seguir(seguidor, seguido, res);
+			correctas += (res == OK || res == NO_EXISTE) ? 1 : 0;
+			operaciones++;
+		}
+		for (size_t i = mitad; i < sintetica.tweets.size(); i += 2) {
+			persistente.nuevo_tweet(TablaSimbolos::global().nombre(sintetica.ids[sintetica.tweets[i].autor]),
+				sintetica.tweets[i].tweet, res);
+			correctas += (res == OK || res == NO_EXISTE) ? 1 : 0;
+			operaciones++;
+		}
+		persistente.sincronizar(res);
+		comprobar(res == OK && correctas == operaciones, "RedPersistente: operaciones anotadas en el diario");
+
+		RedPersistente recuperada(FIC_INSTANTANEA_PRUEBA, FIC_DIARIO_PRUEBA);
+		recuperada.recuperar(res);
+		comprobar(res == OK && mismas_redes(persistente.red(), recuperada.red(), sintetica.ids),
+			(mitad == 0) ? "RedPersistente: recuperar desde el diario" : "RedPersistente: recuperar tras compactar");
+		if (mitad == 0) {
+			persistente.compactar(res);
+			comprobar(res == OK && persistente.operaciones_pendientes() == 0, "RedPersistente: compactar");
+		}
+	}
+
+	// Límite de tiempo sin operaciones nuevas: se sincroniza al comprobarlo
+	persistente.configurar_sincronizacion(1000, MS_SINCRONIZACION_PRUEBA);
+	persistente.nuevo_usuario("persistente_sin_sincronizar", res);
+	bool pendiente = res == OK && persistente.operaciones_pendientes() == 1;
+	this_thread::sleep_for(chrono::milliseconds(2 * MS_SINCRONIZACION_PRUEBA));
+	persistente.comprobar_sincronizacion(res);
+	comprobar(pendiente && res == OK && persistente.operaciones_pendientes() == 0,
+		"RedPersistente: comprobar_sincronizacion tras el tiempo de espera");
+	remove(FIC_INSTANTANEA_PRUEBA);
+	remove(FIC_DIARIO_PRUEBA);
+}
+
+void probar_lote(const RedSintetica &sintetica) {
+	ReservaHilos reserva(HILOS_PRUEBA);
+	IdUsuario max_id = *max_element(sintetica.ids.begin(), sintetica.ids.end());
+	vector <UsuarioTwitter> en_lote(max_id + 1), en_orden(max_id + 1);
+	vector <OperacionUsuario> operaciones;
+	vector <Resultado> resultados, esperados_lote;
+	OperacionUsuario operacion;
+	for (size_t i = 0; i < sintetica.seguimientos.size(); i++) {
+		operacion.usuario = sintetica.ids[sintetica.seguimientos[i].seguido];
+		operacion.otro = sintetica.ids[sintetica.seguimientos[i].seguidor];
+		operacion.tipo = OPU_NUEVO_SEGUIDOR;
+		operaciones.push_back(operacion);
+		operacion.tipo = (i % 5 == 0) ? OPU_ELIMINAR_SEGUIDOR : OPU_NUEVO_SEGUIDOR;
+		operaciones.push_back(operacion);
+		operacion.usuario = sintetica.ids[sintetica.seguimientos[i].seguidor];
+		operacion.otro = sintetica.ids[sintetica.seguimientos[i].seguido];
+		operacion.tipo = OPU_NUEVO_SIGUIENDO;
+		operaciones.push_back(operacion);
+	}
+	for (size_t i = 0; i < sintetica.tweets.size(); i++) {
+		operacion.tipo = OPU_NUEVO_TWEET;
+		operacion.usuario = sintetica.ids[sintetica.tweets[i].autor];
+		operacion.tweet = sintetica.tweets[i].tweet;
+		operaciones.push_back(operacion);
+	}
+	operacion.tipo = OPU_ELIMINAR_SIGUIENDO;
+	operacion.usuario = max_id + 1;
+	operaciones.push_back(operacion);
+
+	aplicar_lote(reserva, en_lote, operaciones, resultados);
+	for (size_t i = 0; i < operaciones.size(); i++) {
+		esperados_lote.push_back((operaciones[i].usuario < en_orden.size()) ?
+			aplicar_operacion(en_orden[operaciones[i].usuario], operaciones[i]) : NO_EXISTE);
+	}
+	Usuarios lista_lote, lista_orden;
+	bool iguales = resultados == esperados_lote;
+	for (IdUsuario u = 0; iguales && u <= max_id; u++) {
+		en_lote[u].obtener_seguidores(lista_lote);
+		en_orden[u].obtener_seguidores(lista_orden);
+		iguales = lista_lote.listado == lista_orden.listado && en_lote[u].num_tweets() == en_orden[u].num_tweets();
+		en_lote[u].obtener_siguiendo(lista_lote);
+		en_orden[u].obtener_siguiendo(lista_orden);
+		iguales = iguales && lista_lote.listado == lista_orden.listado;
+	}
+	comprobar(iguales, "aplicar_lote: mismos resultados que en orden");
+}
+
+void probar_fechas_tweets() {
+	// Las líneas 1, 4 y 7 son correctas (la 4, un 29 de febrero bisiesto)
+	ofstream fichero(FIC_TWEETS_PRUEBA);
+	fichero << "31 1 2024 23 59 59 ultimo segundo de enero\n"
+		<< "31 2 2024 10 0 0 febrero no tiene 31 dias\n"
+		<< "29 2 2023 10 0 0 2023 no es bisiesto\n"
+		<< "29 2 2024 10 0 0 2024 si es bisiesto\n"
+		<< "1 0 2024 10 0 0 mes cero\n"
+		<< "1 1 2024 99 0 0 hora 99\n"
+		<< "1 1 2024 0 0 0 medianoche\n"
+		<< "1 1 2024 0 60 0 minuto 60\n";
+	fichero.close();
+	UsuarioTwitter usuario("fechas");
+	vector <unsigned> lineas_erroneas;
+	Resultado res;
+	usuario.cargar_tweets(FIC_TWEETS_PRUEBA, lineas_erroneas, res);
+	comprobar(res == FIC_ERROR && usuario.num_tweets() == 3
+		&& lineas_erroneas == vector <unsigned>({ 2, 3, 5, 6, 8 }),
+		"leer_fichero_tweets: las fechas que no existen son líneas erróneas");
+	remove(FIC_TWEETS_PRUEBA);
+}
+
+void probar_concurrente() {
+	UsuarioConcurrente usuario(UsuarioTwitter("concurrente"));
+	atomic<bool> terminado(false);
+	atomic<unsigned> incoherencias(0);
+	thread lector([&usuario, &terminado, &incoherencias]() {
+		while (!terminado.load()) {
+			UsuarioConcurrente::Lectura lectura = usuario.leer();
+			// Los tweets se publican de dos en dos
+			incoherencias += (lectura->num_tweets() % 2 == 0 && lectura->ver_tweets().longitud() == lectura->num_tweets()) ? 0 : 1;
+		}
+	});
+	Tweet tweet;
+	tweet.tweet = "tweet";
+	tweet.fecha_hora = a_fecha_hora(0);
+	for (unsigned i = 0; i < 1000; i++) {
+		usuario.modificar([&tweet](UsuarioTwitter &modificado) {
+			Resultado res;
+			modificado.nuevo_tweet(tweet, res);
+			modificado.nuevo_tweet(tweet, res);
+		});
+	}
+	terminado = true;
+	lector.join();
+	comprobar(incoherencias == 0 && usuario.leer()->num_tweets() == 2000,
+		"UsuarioConcurrente: modificar() publica los cambios completos");
+}
\ No newline at end of file
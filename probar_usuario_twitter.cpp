@@ -0,0 +1,214 @@
+/****************************************************************************
+* Pruebas de la copia y el movimiento del TAD UsuarioTwitter
+*
+* UsuarioTwitter comparte entre copias las listas de usuarios y de
+* menciones (copia en escritura) y los bloques de la lista de tweets (ver
+* ListaTweets). Este programa comprueba que:
+*   - una copia (por constructor o por asignación) es igual al original,
+*   - modificar la copia o el original no cambia al otro, tanto en los
+*     tweets como en los seguidores, los seguidos y las menciones,
+*   - un usuario del que se ha movido el contenido queda vacío.
+* Escribe cada comprobación que falla y termina con EXIT_FAILURE si
+* alguna ha fallado.
+*
+* Uso: probar_usuario_twitter
+****************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdlib>
+#include "usuario_twitter.hpp"
+
+using namespace std;
+using namespace bblProgII;
+
+namespace {
+	const unsigned NUM_USUARIOS_PRUEBA = 50; // Seguidores y seguidos del usuario de prueba
+	const unsigned NUM_TWEETS_PRUEBA = 3 * TAM_BLOQUE_TWEETS + 5; // Tweets (el último bloque, a medias)
+	const unsigned NUM_MENCIONES_PRUEBA = 20; // Menciones recibidas por el usuario de prueba
+}
+
+// Número de comprobaciones que han fallado
+unsigned num_fallos = 0;
+
+// Anota y escribe por pantalla el fallo si 'condicion' es falsa
+void comprobar(bool condicion, const string &descripcion);
+
+// Crea el usuario de prueba
+void crear_usuario(UsuarioTwitter &usuario);
+
+// Devuelve un tweet de prueba con el texto indicado
+Tweet tweet_prueba(const string &texto);
+
+// Indica si dos usuarios tienen el mismo identificador, seguidores,
+// seguidos, tweets y menciones
+bool iguales(const UsuarioTwitter &a, const UsuarioTwitter &b);
+
+// Indica si el usuario no tiene identificador, usuarios, tweets ni menciones
+bool vacio(const UsuarioTwitter &usuario);
+
+// Comprueba que modificar 'copia' no cambia 'original' (que debe ser
+// igual a 'referencia') y viceversa
+void probar_independencia(UsuarioTwitter &original, UsuarioTwitter &copia,
+	const UsuarioTwitter &referencia, const string &como);
+
+
+int main() {
+	UsuarioTwitter referencia;
+	crear_usuario(referencia);
+
+	// Constructor de copia
+	UsuarioTwitter original;
+	crear_usuario(original);
+	UsuarioTwitter copia(original);
+	comprobar(iguales(copia, original), "la copia por constructor es igual al original");
+	probar_independencia(original, copia, referencia, "constructor de copia");
+
+	// Operador de asignación (sobre un usuario con contenido)
+	UsuarioTwitter asignado("otro_usuario");
+	Resultado res;
+	asignado.nuevo_seguidor("seguidor_previo", res);
+	asignado.nuevo_tweet(tweet_prueba("tweet previo"), res);
+	crear_usuario(original);
+	asignado = original;
+	comprobar(iguales(asignado, original), "la copia por asignación es igual al original");
+	probar_independencia(original, asignado, referencia, "operador de asignación");
+
+	// Constructor de movimiento
+	crear_usuario(original);
+	UsuarioTwitter movido(std::move(original));
+	comprobar(iguales(movido, referencia), "el usuario construido por movimiento es igual al original");
+	comprobar(vacio(original), "el usuario movido por constructor queda vacío");
+
+	// Operador de asignación de movimiento
+	crear_usuario(original);
+	UsuarioTwitter destino("otro_usuario");
+	destino.nuevo_seguidor("seguidor_previo", res);
+	destino = std::move(original);
+	comprobar(iguales(destino, referencia), "el usuario asignado por movimiento es igual al original");
+	comprobar(vacio(original), "el usuario movido por asignación queda vacío");
+
+	// Un usuario vacío se puede volver a usar
+	original.establecer_id("ada_lovelace");
+	original.nuevo_tweet(tweet_prueba("de nuevo"), res);
+	comprobar(res == OK && original.num_tweets() == 1 && destino.num_tweets() == NUM_TWEETS_PRUEBA,
+		"el usuario movido se puede volver a usar sin afectar al destino");
+
+	if (num_fallos == 0) {
+		cout << "Todas las pruebas son correctas" << endl;
+	}
+	else {
+		cout << num_fallos << " pruebas han fallado" << endl;
+	}
+	return (num_fallos == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void comprobar(bool condicion, const string &descripcion) {
+	if (!condicion) {
+		num_fallos++;
+		cout << "FALLO: " << descripcion << endl;
+	}
+}
+
+void crear_usuario(UsuarioTwitter &usuario) {
+	Resultado res;
+	usuario = UsuarioTwitter("ada_lovelace");
+	for (unsigned i = 0; i < NUM_USUARIOS_PRUEBA; i++) {
+		usuario.nuevo_seguidor("seguidor_" + to_string(i), res);
+		usuario.nuevo_siguiendo("seguido_" + to_string(i), res);
+	}
+	for (unsigned i = 0; i < NUM_TWEETS_PRUEBA; i++) {
+		usuario.nuevo_tweet(tweet_prueba("tweet " + to_string(i)), res);
+	}
+	for (unsigned i = 0; i < NUM_MENCIONES_PRUEBA; i++) {
+		usuario.nueva_mencion("seguidor_" + to_string(i % 5), i, res);
+	}
+}
+
+Tweet tweet_prueba(const string &texto) {
+	Tweet tweet;
+	tweet.tweet = texto;
+	tweet.fecha_hora.anyo = 2024;
+	tweet.fecha_hora.mes = 1;
+	tweet.fecha_hora.dia = 1;
+	tweet.fecha_hora.hora = 12;
+	tweet.fecha_hora.minuto = 0;
+	tweet.fecha_hora.segundo = unsigned(texto.size() % 60);
+	return tweet;
+}
+
+bool iguales(const UsuarioTwitter &a, const UsuarioTwitter &b) {
+	Usuarios usuarios_a, usuarios_b;
+	Tweets tweets_a, tweets_b;
+	ListaMenciones menciones_a, menciones_b;
+	Tweet tweet_a, tweet_b;
+	bool son_iguales = a.obtener_id() == b.obtener_id();
+	a.obtener_seguidores(usuarios_a);
+	b.obtener_seguidores(usuarios_b);
+	son_iguales = son_iguales && usuarios_a.listado == usuarios_b.listado;
+	a.obtener_siguiendo(usuarios_a);
+	b.obtener_siguiendo(usuarios_b);
+	son_iguales = son_iguales && usuarios_a.listado == usuarios_b.listado;
+	a.obtener_tweets(tweets_a);
+	b.obtener_tweets(tweets_b);
+	son_iguales = son_iguales && tweets_a.num_tweets == tweets_b.num_tweets
+		&& tweets_a.listado.longitud() == tweets_b.listado.longitud();
+	for (unsigned i = 0; son_iguales && i < tweets_a.listado.longitud(); i++) {
+		son_iguales = tweets_a.listado.leer(i, tweet_a) && tweets_b.listado.leer(i, tweet_b)
+			&& tweet_a.tweet == tweet_b.tweet && tweet_a.fecha_hora.segundo == tweet_b.fecha_hora.segundo;
+	}
+	a.obtener_menciones(menciones_a);
+	b.obtener_menciones(menciones_b);
+	son_iguales = son_iguales && menciones_a.size() == menciones_b.size();
+	for (unsigned i = 0; son_iguales && i < menciones_a.size(); i++) {
+		son_iguales = menciones_a[i].autor == menciones_b[i].autor && menciones_a[i].num_tweet == menciones_b[i].num_tweet;
+	}
+	return son_iguales;
+}
+
+bool vacio(const UsuarioTwitter &usuario) {
+	Tweets tweets;
+	usuario.obtener_tweets(tweets);
+	return usuario.obtener_id().empty() && usuario.num_seguidores() == 0 && usuario.num_siguiendo() == 0
+		&& usuario.num_tweets() == 0 && tweets.listado.longitud() == 0 && usuario.num_menciones() == 0;
+}
+
+void probar_independencia(UsuarioTwitter &original, UsuarioTwitter &copia,
+	const UsuarioTwitter &referencia, const string &como) {
+	Resultado res;
+	Tweet tweet;
+	Tweets tweets;
+
+	// Modificar la copia: el original sigue igual que la referencia
+	copia.nuevo_tweet(tweet_prueba("solo en la copia"), res);
+	copia.nuevo_seguidor("seguidor_copia", res);
+	copia.eliminar_seguidor("seguidor_0", res);
+	copia.nuevo_siguiendo("seguido_copia", res);
+	copia.eliminar_siguiendo("seguido_0", res);
+	copia.nueva_mencion("seguidor_copia", 0, res);
+	comprobar(iguales(original, referencia), como + ": modificar la copia no cambia el original");
+	comprobar(copia.num_tweets() == NUM_TWEETS_PRUEBA + 1 && copia.num_seguidores() == NUM_USUARIOS_PRUEBA
+		&& copia.num_siguiendo() == NUM_USUARIOS_PRUEBA && copia.num_menciones() == NUM_MENCIONES_PRUEBA + 1,
+		como + ": la copia tiene sus modificaciones");
+	copia.obtener_tweets(tweets);
+	comprobar(tweets.listado.leer(NUM_TWEETS_PRUEBA, tweet) && tweet.tweet == "solo en la copia",
+		como + ": el tweet nuevo de la copia está en la copia");
+
+	// Modificar el original: la copia no ve los cambios
+	UsuarioTwitter copia_antes(copia);
+	original.nuevo_tweet(tweet_prueba("solo en el original"), res);
+	original.nuevo_seguidor("seguidor_original", res);
+	original.eliminar_seguidor("seguidor_1", res);
+	original.nuevo_siguiendo("seguido_original", res);
+	original.eliminar_siguiendo("seguido_1", res);
+	original.nueva_mencion("seguidor_original", 0, res);
+	comprobar(iguales(copia, copia_antes), como + ": modificar el original no cambia la copia");
+	original.obtener_tweets(tweets);
+	comprobar(tweets.listado.leer(NUM_TWEETS_PRUEBA, tweet) && tweet.tweet == "solo en el original",
+		como + ": el tweet nuevo del original está en el original");
+	comprobar(!original.me_sigue("seguidor_copia") && !copia.me_sigue("seguidor_original")
+		&& original.me_sigue("seguidor_0") && copia.me_sigue("seguidor_1"),
+		como + ": los seguidores de la copia y el original son independientes");
+}
\ No newline at end of file
@@ -0,0 +1,249 @@
+/****************************************************************************
+* Clase RedPersistente
+*
+* Red social guardada en disco como una instantánea (ver InstantaneaRed)
+* más un diario de las operaciones realizadas desde entonces (ver
+* DiarioOperaciones). Cada operación que modifica la red se anota en el
+* diario al realizarse, de modo que guardar un tweet nuevo cuesta lo mismo
+* que escribir ese tweet, no toda la red.
+*
+* Al arrancar, recuperar() carga la instantánea y repite encima las
+* operaciones del diario. compactar() vuelca la red en una instantánea
+* nueva y empieza un diario vacío de la generación siguiente; si el
+* proceso cae entre ambos pasos, el diario antiguo no se repite porque su
+* generación ya está incluida en la instantánea.
+****************************************************************************/
+
+#ifndef __RED__PERSISTENTE__
+#define __RED__PERSISTENTE__
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include "red_social.hpp"
+#include "diario.hpp"
+
+namespace bblProgII {
+	class RedPersistente {
+	public:
+		// Constructor: red vacía guardada en la instantánea y el diario
+		// indicados (no se leen hasta llamar a recuperar())
+		RedPersistente(const std::string &nom_instantanea, const std::string &nom_diario) :
+			red_social(), diario(), fic_instantanea(nom_instantanea), fic_diario(nom_diario),
+			generacion(0), num_recuperadas(0) {}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+
+		// Devuelve la red (para consultarla; las modificaciones se hacen
+		// con los métodos de esta clase, para que queden en el diario)
+		const RedSocial & red() const {
+			return red_social;
+		}
+
+		// Devuelve la generación del diario actual
+		std::uint32_t generacion_diario() const {
+			return generacion;
+		}
+
+		// Devuelve el número de operaciones repetidas por recuperar()
+		unsigned long long operaciones_recuperadas() const {
+			return num_recuperadas;
+		}
+
+		// Devuelve el número de operaciones del diario aún no sincronizadas
+		// con el disco
+		unsigned operaciones_pendientes() const {
+			return diario.operaciones_pendientes();
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE RECUPERACIÓN Y COMPACTACIÓN
+
+		// Reconstruye la red a partir de la instantánea (si existe) y del
+		// diario, descarta un posible registro incompleto al final de éste
+		// y lo deja abierto para anotar nuevas operaciones. Si no existe
+		// el diario, se crea. Se devuelve 'OK' a través de 'res', o
+		// 'FIC_ERROR' si la instantánea o el diario existen pero no son
+		// válidos (en ese caso no se modifica ningún fichero).
+		void recuperar(Resultado &res) {
+			InstantaneaRed instantanea;
+			std::uint32_t generacion_instantanea = 0, generacion_leida = 0;
+			std::uint64_t fin_valido = 0;
+			Resultado res_diario;
+			diario.cerrar();
+			num_recuperadas = 0;
+			instantanea.abrir(fic_instantanea, res);
+			if (res == OK) {
+				red_social.cargar_instantanea(instantanea);
+				generacion_instantanea = instantanea.generacion_diario();
+				instantanea.cerrar();
+			}
+			else if (!existe_fichero(fic_instantanea)) {
+				red_social = RedSocial();
+				res = OK;
+			}
+			if (res == OK) {
+				DiarioOperaciones::leer(fic_diario, generacion_leida, fin_valido, res_diario,
+					[this, &generacion_leida, generacion_instantanea](const OperacionDiario &operacion) {
+					// Un diario ya incluido en la instantánea no se repite
+					if (generacion_leida > generacion_instantanea) {
+						aplicar(operacion);
+						num_recuperadas++;
+					}
+				});
+				if (res_diario == OK && generacion_leida > generacion_instantanea) {
+					generacion = generacion_leida;
+					diario.abrir(fic_diario, fin_valido, res);
+				}
+				else if (res_diario == OK || !existe_fichero(fic_diario)) {
+					generacion = generacion_instantanea + 1;
+					diario.crear(fic_diario, generacion, res);
+				}
+				else {
+					res = FIC_ERROR;
+				}
+			}
+		}
+
+		// Vuelca la red en una instantánea nueva (que sustituye a la
+		// anterior) y empieza un diario vacío. Se devuelve 'OK' a través
+		// de 'res', o 'FIC_ERROR' si no se puede escribir la instantánea
+		// (en ese caso se sigue usando el diario actual, con las
+		// operaciones que no se hayan podido sincronizar aún pendientes) o
+		// el diario nuevo.
+		// PRECONDICIÓN: se ha llamado a recuperar()
+		void compactar(Resultado &res) {
+			// Si el diario no se puede sincronizar, sus operaciones
+			// pendientes quedan igualmente a salvo en la instantánea
+			bool diario_sincronizado = diario.sincronizar();
+			// La instantánea sustituye a la anterior solo si se escribe
+			// entera (ver RedSocial::guardar_instantanea)
+			red_social.guardar_instantanea(fic_instantanea, generacion, res);
+			if (res == OK) {
+				// A partir de aquí la instantánea incluye el diario actual
+				std::string temporal = fic_diario + ".tmp";
+				diario.crear(temporal, generacion + 1, res);
+				if (res == OK && std::rename(temporal.c_str(), fic_diario.c_str()) == 0) {
+					generacion++;
+				}
+				else {
+					// El diario antiguo ya no se repetirá: se abre uno
+					// vacío de la generación siguiente en su lugar
+					generacion++;
+					diario.crear(fic_diario, generacion, res);
+				}
+			}
+			else if (!diario_sincronizado) {
+				// Se vuelve a intentar sincronizar el diario
+				diario.sincronizar();
+			}
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ACTUALIZACIÓN
+		//
+		// Hacen lo mismo que los de RedSocial y, si la operación se
+		// realiza ('OK'), la anotan en el diario. Si se realiza pero el
+		// diario no se puede sincronizar cuando toca (ver
+		// DiarioOperaciones::sincronizar), se devuelve 'FIC_ERROR': la
+		// operación queda hecha en la red y pendiente en el diario, y se
+		// puede perder si el proceso cae antes de otra sincronización
+		// correcta.
+		// PRECONDICIÓN (todos): se ha llamado a recuperar()
+
+		void nuevo_usuario(const std::string &usuario, Resultado &res) {
+			red_social.nuevo_usuario(usuario, res);
+			if (res == OK && !diario.nuevo_usuario(usuario)) {
+				res = FIC_ERROR;
+			}
+		}
+
+		void seguir(const std::string &seguidor, const std::string &seguido, Resultado &res) {
+			red_social.seguir(seguidor, seguido, res);
+			if (res == OK && !diario.seguir(seguidor, seguido)) {
+				res = FIC_ERROR;
+			}
+		}
+
+		void dejar_de_seguir(const std::string &seguidor, const std::string &seguido, Resultado &res) {
+			red_social.dejar_de_seguir(seguidor, seguido, res);
+			if (res == OK && !diario.dejar_de_seguir(seguidor, seguido)) {
+				res = FIC_ERROR;
+			}
+		}
+
+		void nuevo_tweet(const std::string &autor, const Tweet &nuevo, Resultado &res) {
+			red_social.nuevo_tweet(autor, nuevo, res);
+			if (res == OK && !diario.nuevo_tweet(autor, a_marca_tiempo(nuevo.fecha_hora),
+				nuevo.tweet.substr(0, MAX_LONG_TWEET))) {
+				res = FIC_ERROR;
+			}
+		}
+
+		// Configura las escrituras agrupadas del diario (ver
+		// DiarioOperaciones::configurar_sincronizacion)
+		void configurar_sincronizacion(unsigned ops, unsigned ms) {
+			diario.configurar_sincronizacion(ops, ms);
+		}
+
+		// Sincroniza el diario si la operación pendiente más antigua ya ha
+		// esperado el tiempo configurado (ver
+		// DiarioOperaciones::comprobar_sincronizacion); debe llamarse
+		// periódicamente si puede pasar tiempo sin operaciones nuevas. Se
+		// devuelve 'OK' a través de 'res', o 'FIC_ERROR' si tocaba
+		// sincronizar y no se ha podido.
+		void comprobar_sincronizacion(Resultado &res) {
+			res = diario.comprobar_sincronizacion() ? OK : FIC_ERROR;
+		}
+
+		// Escribe y sincroniza con el disco las operaciones pendientes y
+		// devuelve 'OK' a través de 'res', o 'FIC_ERROR' si no se puede
+		// (siguen pendientes)
+		void sincronizar(Resultado &res) {
+			res = diario.sincronizar() ? OK : FIC_ERROR;
+		}
+
+	private:
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		RedSocial red_social;
+		DiarioOperaciones diario;
+		std::string fic_instantanea, fic_diario;
+		// Generación del diario abierto
+		std::uint32_t generacion;
+		unsigned long long num_recuperadas;
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS
+		//
+		// Indica si existe el fichero
+		static bool existe_fichero(const std::string &nom_fic) {
+			return bool(std::ifstream(nom_fic));
+		}
+
+		// Repite en la red una operación del diario
+		void aplicar(const OperacionDiario &operacion) {
+			Resultado res;
+			Tweet tweet;
+			switch (operacion.tipo) {
+			case OP_NUEVO_USUARIO:
+				red_social.nuevo_usuario(operacion.usuario, res);
+				break;
+			case OP_SEGUIR:
+				red_social.seguir(operacion.usuario, operacion.otro, res);
+				break;
+			case OP_DEJAR_DE_SEGUIR:
+				red_social.dejar_de_seguir(operacion.usuario, operacion.otro, res);
+				break;
+			case OP_NUEVO_TWEET:
+				tweet.tweet = operacion.texto;
+				tweet.fecha_hora = a_fecha_hora(operacion.marca_tiempo);
+				red_social.nuevo_tweet(operacion.usuario, tweet, res);
+				break;
+			}
+		}
+	};
+}
+#endif
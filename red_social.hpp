@@ -0,0 +1,1604 @@
+/****************************************************************************
+* Clase RedSocial
+*
+* Esta clase contiene a todos los usuarios de la red social 'Twitter'.
+* Guarda el grafo de seguidores y seguidos de todos los usuarios y la
+* lista de tweets de cada uno, de forma que seguir o dejar de seguir a
+* un usuario actualiza a la vez la lista de usuarios seguidos de uno y la
+* lista de seguidores del otro.
+*
+* Al insertar cada tweet se extraen las menciones (@usuario) que contiene
+* y se añaden a la lista de menciones recibidas de cada usuario mencionado
+* que pertenezca a la red. También se añaden sus palabras a un índice
+* invertido (ver IndiceTexto) para buscar los tweets que las contienen.
+* Opcionalmente, se cuentan sus @usuarios y #temas para saber cuáles son
+* tendencia en los últimos minutos (ver Tendencias).
+*
+* La cronología de un usuario (los tweets más recientes de los usuarios a
+* los que sigue) se obtiene fusionando con un montículo las listas de
+* tweets de sus seguidos. Opcionalmente, los usuarios que siguen a pocos
+* usuarios pueden tener su cronología precalculada: cada tweet nuevo se
+* añade a la cronología de los seguidores de su autor al insertarse.
+*
+* La red completa se puede guardar en una instantánea binaria y cargar
+* desde ella (ver InstantaneaRed), mucho más rápido que leyendo los
+* ficheros de texto de cada usuario. La instantánea se escribe en un
+* fichero temporal que, una vez sincronizado con el disco, sustituye a la
+* anterior: si el proceso cae mientras se guarda, queda la anterior
+* entera.
+*
+* Los usuarios se identifican por su IdUsuario de la tabla de símbolos
+* global (ver TablaSimbolos). Solo existe_usuario, sigue_a, nuevo_usuario,
+* seguir, dejar_de_seguir y nuevo_tweet tienen también una versión que
+* recibe el nombre del usuario (obtener_usuario solo recibe el nombre);
+* para los demás métodos, el nombre se traduce antes con
+* TablaSimbolos::global().buscar().
+****************************************************************************/
+
+#ifndef __RED__SOCIAL__
+#define __RED__SOCIAL__
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdint>
+#include <cstdio>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define __RED_SOCIAL_POSIX__
+#endif
+#include "tabla_simbolos.hpp"
+#include "menciones.hpp"
+#include "indice_texto.hpp"
+#include "tendencias.hpp"
+#include "instantanea.hpp"
+#include "usuario_twitter.hpp"
+#include "reserva_hilos.hpp"
+
+namespace {
+	const unsigned long long MIN_PENDIENTES_COMPACTAR = 4096; // Mínimo de cambios pendientes para compactar
+	const unsigned FRACCION_PENDIENTES_COMPACTAR = 4; // Se compacta si los cambios pendientes superan aristas / FRACCION
+	const unsigned TAREAS_POR_HILO_RECOMENDAR = 4; // Tramos de seguidos por hilo al recomendar en paralelo
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Referencia a un tweet: su autor y su número de tweet dentro de la
+	// lista de tweets del autor
+	struct RefTweet {
+		IdUsuario autor;
+		unsigned num_tweet;
+	};
+	// Cronología: referencias a tweets, del más reciente al más antiguo
+	typedef std::vector <RefTweet> Cronologia;
+	// Usuario recomendado para seguir y número de usuarios seguidos que
+	// lo siguen
+	struct Recomendacion {
+		IdUsuario usuario;
+		unsigned num_comunes;
+	};
+
+	//---------------------------------------------------------------------------
+	// Grafo dirigido guardado en formato CSR (compressed sparse row): las
+	// aristas de todos los usuarios están en un único vector, ordenadas por
+	// usuario de origen y, dentro de cada usuario, por usuario de destino;
+	// 'inicio[u]' es la posición de la primera arista del usuario 'u'.
+	//
+	// Como insertar en el CSR obliga a desplazar el vector completo, los
+	// cambios de cada usuario se acumulan en un buffer de altas y bajas
+	// ordenadas y se incorporan al CSR al compactar. Invariantes: las altas
+	// no están en el CSR y las bajas sí.
+	class GrafoCSR {
+	public:
+		// Constructor por defecto: grafo vacío
+		GrafoCSR() : inicio(1, 0), adyacentes(), pos_cambios(), filas_cambios(), grados(), num_aristas(0), num_pendientes(0) {}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+
+		// Indica si existe la arista 'origen' -> 'destino'
+		bool contiene(IdUsuario origen, IdUsuario destino) const {
+			return contiene(origen, destino, buscar_cambios(origen));
+		}
+
+		// Devuelve el número de aristas que salen de 'origen'
+		unsigned grado(IdUsuario origen) const {
+			return (origen < grados.size()) ? grados[origen] : 0;
+		}
+
+		// Devuelve los destinos de las aristas que salen de 'origen',
+		// ordenados de menor a mayor
+		void vecinos(IdUsuario origen, std::vector<IdUsuario> &destinos) const {
+			destinos.clear();
+			destinos.reserve(grado(origen));
+			fusionar_fila(origen, buscar_cambios(origen), destinos);
+		}
+
+		// Devuelve el número total de aristas
+		unsigned long long aristas() const {
+			return num_aristas;
+		}
+
+		// Devuelve el número de altas y bajas pendientes de compactar
+		unsigned long long pendientes() const {
+			return num_pendientes;
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ACTUALIZACIÓN
+
+		// Inserta la arista 'origen' -> 'destino'. Devuelve false si ya
+		// existía.
+		bool insertar(IdUsuario origen, IdUsuario destino) {
+			CambiosFila &fila = obtener_cambios(origen);
+			bool insertada = !contiene(origen, destino, &fila);
+			if (insertada) {
+				// Si estaba dada de baja, basta con anular la baja
+				if (!quitar(fila.bajas, destino)) {
+					poner(fila.altas, destino);
+				}
+				if (origen >= grados.size()) {
+					grados.resize(std::size_t(origen) + 1, 0);
+				}
+				grados[origen]++;
+				num_aristas++;
+			}
+			return insertada;
+		}
+
+		// Elimina la arista 'origen' -> 'destino'. Devuelve false si no
+		// existía.
+		bool eliminar(IdUsuario origen, IdUsuario destino) {
+			CambiosFila &fila = obtener_cambios(origen);
+			bool eliminada = contiene(origen, destino, &fila);
+			if (eliminada) {
+				// Si era un alta pendiente, basta con anular el alta
+				if (!quitar(fila.altas, destino)) {
+					poner(fila.bajas, destino);
+				}
+				grados[origen]--;
+				num_aristas--;
+			}
+			return eliminada;
+		}
+
+		// Sustituye el grafo por el CSR formado por 'nuevo_inicio' (una
+		// posición por fila más la final) y 'nuevos_adyacentes', cuyas
+		// filas deben estar ordenadas de menor a mayor. Ambos vectores se
+		// quedan vacíos.
+		void construir(std::vector<std::uint64_t> &nuevo_inicio, std::vector<IdUsuario> &nuevos_adyacentes) {
+			inicio.swap(nuevo_inicio);
+			adyacentes.swap(nuevos_adyacentes);
+			std::vector<std::uint64_t>().swap(nuevo_inicio);
+			std::vector<IdUsuario>().swap(nuevos_adyacentes);
+			grados.resize(inicio.size() - 1);
+			for (std::size_t u = 0; u + 1 < inicio.size(); u++) {
+				grados[u] = unsigned(inicio[u + 1] - inicio[u]);
+			}
+			std::vector<unsigned>().swap(pos_cambios);
+			std::vector<CambiosFila>().swap(filas_cambios);
+			num_aristas = adyacentes.size();
+			num_pendientes = 0;
+		}
+
+		// Indica si conviene compactar: hay muchas altas y bajas pendientes
+		// en relación con el tamaño del grafo
+		bool debe_compactar() const {
+			return num_pendientes >= MIN_PENDIENTES_COMPACTAR &&
+				num_pendientes >= num_aristas / FRACCION_PENDIENTES_COMPACTAR;
+		}
+
+		// Incorpora al CSR las altas y bajas pendientes. Coste lineal en el
+		// número de aristas: las filas sin cambios se copian en bloque.
+		void compactar() {
+			if (num_pendientes > 0) {
+				// Usuarios con cambios, en orden
+				std::vector<std::pair<IdUsuario, const CambiosFila *>> con_cambios;
+				con_cambios.reserve(filas_cambios.size());
+				for (std::size_t i = 0; i < filas_cambios.size(); i++) {
+					con_cambios.push_back(std::make_pair(filas_cambios[i].origen, &filas_cambios[i]));
+				}
+				std::sort(con_cambios.begin(), con_cambios.end());
+				IdUsuario num_filas = IdUsuario(std::max(inicio.size() - 1, grados.size()));
+				std::vector<std::uint64_t> nuevo_inicio;
+				std::vector<IdUsuario> nuevos_adyacentes;
+				nuevo_inicio.reserve(std::size_t(num_filas) + 1);
+				nuevos_adyacentes.reserve(num_aristas);
+				nuevo_inicio.push_back(0);
+				IdUsuario u = 0;
+				for (std::size_t i = 0; i <= con_cambios.size(); i++) {
+					IdUsuario siguiente = (i < con_cambios.size()) ? con_cambios[i].first : num_filas;
+					// Filas sin cambios hasta el siguiente usuario con cambios
+					std::uint64_t desplazamiento = std::uint64_t(nuevos_adyacentes.size()) - inicio_fila(u);
+					nuevos_adyacentes.insert(nuevos_adyacentes.end(),
+						adyacentes.begin() + inicio_fila(u), adyacentes.begin() + inicio_fila(siguiente));
+					for (; u < siguiente; u++) {
+						nuevo_inicio.push_back(fin_fila(u) + desplazamiento);
+					}
+					if (i < con_cambios.size()) {
+						fusionar_fila(u, con_cambios[i].second, nuevos_adyacentes);
+						nuevo_inicio.push_back(nuevos_adyacentes.size());
+						u++;
+					}
+				}
+				inicio.swap(nuevo_inicio);
+				adyacentes.swap(nuevos_adyacentes);
+				for (std::size_t i = 0; i < filas_cambios.size(); i++) {
+					pos_cambios[filas_cambios[i].origen] = 0;
+				}
+				std::vector<CambiosFila>().swap(filas_cambios);
+				num_pendientes = 0;
+			}
+		}
+
+	private:
+		// Altas y bajas pendientes de un usuario, ordenadas de menor a mayor
+		struct CambiosFila {
+			IdUsuario origen;
+			std::vector <IdUsuario> altas, bajas;
+		};
+
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		// Posición en 'adyacentes' de la primera arista de cada usuario
+		std::vector <std::uint64_t> inicio;
+		// Destinos de todas las aristas del CSR
+		std::vector <IdUsuario> adyacentes;
+		// Aristas insertadas y eliminadas desde la última compactación: para
+		// cada usuario, 1 + posición de sus cambios en 'filas_cambios' (0 si
+		// no tiene cambios)
+		std::vector <unsigned> pos_cambios;
+		std::vector <CambiosFila> filas_cambios;
+		// Número de aristas que salen de cada usuario
+		std::vector <unsigned> grados;
+		// Número total de aristas y de cambios pendientes
+		unsigned long long num_aristas, num_pendientes;
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS
+		//
+		// Límites de la fila de 'origen' en el CSR (vacía si 'origen' es
+		// posterior a la última compactación)
+		std::uint64_t inicio_fila(IdUsuario origen) const {
+			return (std::size_t(origen) + 1 < inicio.size()) ? inicio[origen] : adyacentes.size();
+		}
+		std::uint64_t fin_fila(IdUsuario origen) const {
+			return (std::size_t(origen) + 1 < inicio.size()) ? inicio[origen + 1] : adyacentes.size();
+		}
+
+		// Cambios pendientes de 'origen' (nullptr si no tiene)
+		const CambiosFila * buscar_cambios(IdUsuario origen) const {
+			bool tiene = (origen < pos_cambios.size()) && (pos_cambios[origen] != 0);
+			return tiene ? &filas_cambios[pos_cambios[origen] - 1] : nullptr;
+		}
+
+		// Cambios pendientes de 'origen', reservando una fila de cambios
+		// (vacía) si no tenía
+		CambiosFila & obtener_cambios(IdUsuario origen) {
+			if (origen >= pos_cambios.size()) {
+				pos_cambios.resize(std::size_t(origen) + 1, 0);
+			}
+			if (pos_cambios[origen] == 0) {
+				filas_cambios.push_back(CambiosFila());
+				filas_cambios.back().origen = origen;
+				pos_cambios[origen] = unsigned(filas_cambios.size());
+			}
+			return filas_cambios[pos_cambios[origen] - 1];
+		}
+
+		// Indica si existe la arista, dados los cambios pendientes de 'origen'
+		bool contiene(IdUsuario origen, IdUsuario destino, const CambiosFila *fila) const {
+			bool existe;
+			if (std::binary_search(adyacentes.begin() + inicio_fila(origen), adyacentes.begin() + fin_fila(origen), destino)) {
+				existe = (fila == nullptr) || !std::binary_search(fila->bajas.begin(), fila->bajas.end(), destino);
+			}
+			else {
+				existe = (fila != nullptr) && std::binary_search(fila->altas.begin(), fila->altas.end(), destino);
+			}
+			return existe;
+		}
+
+		// Inserta o quita un destino de una lista ordenada de cambios
+		void poner(std::vector<IdUsuario> &lista, IdUsuario destino) {
+			lista.insert(std::lower_bound(lista.begin(), lista.end(), destino), destino);
+			num_pendientes++;
+		}
+		bool quitar(std::vector<IdUsuario> &lista, IdUsuario destino) {
+			bool quitado = false;
+			std::vector<IdUsuario>::iterator pos = std::lower_bound(lista.begin(), lista.end(), destino);
+			if (pos != lista.end() && *pos == destino) {
+				lista.erase(pos);
+				num_pendientes--;
+				quitado = true;
+			}
+			return quitado;
+		}
+
+		// Añade al final de 'destinos' la fila de 'origen' del CSR sin las
+		// bajas y fusionada con las altas, en orden creciente
+		void fusionar_fila(IdUsuario origen, const CambiosFila *fila, std::vector<IdUsuario> &destinos) const {
+			std::uint64_t i = inicio_fila(origen), fin = fin_fila(origen);
+			if (fila == nullptr) {
+				destinos.insert(destinos.end(), adyacentes.begin() + i, adyacentes.begin() + fin);
+			}
+			else {
+				std::vector<IdUsuario>::const_iterator a = fila->altas.begin(), b = fila->bajas.begin();
+				for (; i < fin; i++) {
+					IdUsuario destino = adyacentes[i];
+					while (a != fila->altas.end() && *a < destino) {
+						destinos.push_back(*a);
+						++a;
+					}
+					while (b != fila->bajas.end() && *b < destino) {
+						++b;
+					}
+					if (b == fila->bajas.end() || *b != destino) {
+						destinos.push_back(destino);
+					}
+				}
+				destinos.insert(destinos.end(), a, fila->altas.end());
+			}
+		}
+	};
+
+	//---------------------------------------------------------------------------
+	class RedSocial {
+	public:
+		// Constructor por defecto: red sin usuarios
+		RedSocial() : registrado(), num_registrados(0), tweets(), menciones(), indexar_menciones(true),
+			indice_texto(), documentos(), indexar_texto(true), tendencias(), contar_tendencias(false), siguiendo(), seguidores(), caches(),
+			max_siguiendo_cache(0), capacidad_cache(0), recomendaciones() {}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+
+		// Devuelve el número de usuarios de la red
+		unsigned num_usuarios() const {
+			return num_registrados;
+		}
+
+		// Indica si el usuario pertenece a la red
+		bool existe_usuario(const std::string &usuario) const {
+			return existe_usuario(TablaSimbolos::global().buscar(usuario));
+		}
+		bool existe_usuario(IdUsuario usuario) const {
+			return usuario < registrado.size() && registrado[usuario];
+		}
+
+		// Indica si 'seguidor' sigue a 'seguido'
+		bool sigue_a(const std::string &seguidor, const std::string &seguido) const {
+			const TablaSimbolos &tabla = TablaSimbolos::global();
+			return sigue_a(tabla.buscar(seguidor), tabla.buscar(seguido));
+		}
+		bool sigue_a(IdUsuario seguidor, IdUsuario seguido) const {
+			return existe_usuario(seguidor) && siguiendo.contiene(seguidor, seguido);
+		}
+
+		// Devuelve el número de seguidores del usuario
+		// PRECONDICIÓN: existe_usuario(usuario)
+		unsigned num_seguidores(IdUsuario usuario) const {
+			return seguidores.grado(usuario);
+		}
+
+		// Devuelve el número de usuarios a los que sigue el usuario
+		// PRECONDICIÓN: existe_usuario(usuario)
+		unsigned num_siguiendo(IdUsuario usuario) const {
+			return siguiendo.grado(usuario);
+		}
+
+		// Devuelve el número de tweets del usuario
+		// PRECONDICIÓN: existe_usuario(usuario)
+		unsigned num_tweets(IdUsuario usuario) const {
+			return tweets[usuario].longitud();
+		}
+
+		// Devuelve la lista de seguidores del usuario (identificadores
+		// ordenados de menor a mayor)
+		// PRECONDICIÓN: existe_usuario(usuario)
+		void obtener_seguidores(IdUsuario usuario, Usuarios &lista_seg) const {
+			seguidores.vecinos(usuario, lista_seg.listado);
+			lista_seg.num_usuarios = unsigned(lista_seg.listado.size());
+		}
+
+		// Devuelve la lista de usuarios a los que sigue el usuario
+		// (identificadores ordenados de menor a mayor)
+		// PRECONDICIÓN: existe_usuario(usuario)
+		void obtener_siguiendo(IdUsuario usuario, Usuarios &lista_sig) const {
+			siguiendo.vecinos(usuario, lista_sig.listado);
+			lista_sig.num_usuarios = unsigned(lista_sig.listado.size());
+		}
+
+		// Devuelve los seguidores del usuario a los que él también sigue
+		// (identificadores ordenados de menor a mayor)
+		// PRECONDICIÓN: existe_usuario(usuario)
+		void obtener_seguidores_mutuos(IdUsuario usuario, Usuarios &mutuos) const {
+			std::vector <IdUsuario> lista_seg, lista_sig;
+			seguidores.vecinos(usuario, lista_seg);
+			siguiendo.vecinos(usuario, lista_sig);
+			interseccion_usuarios(lista_seg.data(), lista_seg.size(), lista_sig.data(), lista_sig.size(), mutuos.listado);
+			mutuos.num_usuarios = unsigned(mutuos.listado.size());
+		}
+
+		// Devuelve los usuarios que siguen a la vez a 'usuario' y a 'otro'
+		// (identificadores ordenados de menor a mayor)
+		// PRECONDICIÓN: existe_usuario(usuario) y existe_usuario(otro)
+		void obtener_seguidores_comunes(IdUsuario usuario, IdUsuario otro, Usuarios &comunes) const {
+			std::vector <IdUsuario> lista_usuario, lista_otro;
+			seguidores.vecinos(usuario, lista_usuario);
+			seguidores.vecinos(otro, lista_otro);
+			interseccion_usuarios(lista_usuario.data(), lista_usuario.size(), lista_otro.data(), lista_otro.size(),
+				comunes.listado);
+			comunes.num_usuarios = unsigned(comunes.listado.size());
+		}
+
+		// Devuelve los usuarios que siguen a 'usuario' pero no a 'otro'
+		// (identificadores ordenados de menor a mayor)
+		// PRECONDICIÓN: existe_usuario(usuario) y existe_usuario(otro)
+		void obtener_seguidores_excepto(IdUsuario usuario, IdUsuario otro, Usuarios &lista) const {
+			std::vector <IdUsuario> lista_usuario, lista_otro;
+			seguidores.vecinos(usuario, lista_usuario);
+			seguidores.vecinos(otro, lista_otro);
+			diferencia_usuarios(lista_usuario.data(), lista_usuario.size(), lista_otro.data(), lista_otro.size(),
+				lista.listado);
+			lista.num_usuarios = unsigned(lista.listado.size());
+		}
+
+		// Devuelve la lista de tweets del usuario
+		// PRECONDICIÓN: existe_usuario(usuario)
+		const ListaTweets & obtener_tweets(IdUsuario usuario) const {
+			return tweets[usuario];
+		}
+
+		// Devuelve el número de menciones que ha recibido el usuario
+		// PRECONDICIÓN: existe_usuario(usuario)
+		unsigned num_menciones(IdUsuario usuario) const {
+			return unsigned(menciones[usuario].size());
+		}
+
+		// Devuelve la lista de menciones que ha recibido el usuario, en el
+		// orden en que se han producido
+		// PRECONDICIÓN: existe_usuario(usuario)
+		const ListaMenciones & obtener_menciones(IdUsuario usuario) const {
+			return menciones[usuario];
+		}
+
+		// Devuelve la lista de usuarios que han mencionado al usuario
+		// (identificadores ordenados de menor a mayor, sin repetidos)
+		// PRECONDICIÓN: existe_usuario(usuario)
+		void quien_me_menciona(IdUsuario usuario, Usuarios &autores) const {
+			const ListaMenciones &lista = menciones[usuario];
+			autores.listado.clear();
+			for (unsigned i = 0; i < lista.size(); i++) {
+				autores.listado.push_back(lista[i].autor);
+			}
+			std::sort(autores.listado.begin(), autores.listado.end());
+			autores.listado.erase(std::unique(autores.listado.begin(), autores.listado.end()), autores.listado.end());
+			autores.num_usuarios = unsigned(autores.listado.size());
+		}
+
+		// Devuelve los números de tweet (del autor) en los que 'autor' ha
+		// mencionado al usuario, de menor a mayor
+		// PRECONDICIÓN: existe_usuario(usuario)
+		void menciones_de(IdUsuario usuario, IdUsuario autor, std::vector<unsigned> &num_tweets) const {
+			const ListaMenciones &lista = menciones[usuario];
+			num_tweets.clear();
+			for (unsigned i = 0; i < lista.size(); i++) {
+				if (lista[i].autor == autor) {
+					num_tweets.push_back(lista[i].num_tweet);
+				}
+			}
+		}
+
+		// Devuelve referencias a los tweets que contienen todas las
+		// palabras de 'consulta' (sin distinguir mayúsculas de minúsculas),
+		// en el orden en que se insertaron en la red
+		void buscar_tweets(const std::string &consulta, Cronologia &refs) const {
+			ListaDocumentos docs;
+			indice_texto.buscar(consulta, docs);
+			refs.resize(docs.size());
+			for (std::size_t i = 0; i < docs.size(); i++) {
+				refs[i] = documentos[docs[i]];
+			}
+		}
+
+		// Devuelve la memoria ocupada por el índice de palabras, en bytes
+		// (incluida la tabla de documentos)
+		std::size_t memoria_indice_texto() const {
+			return indice_texto.memoria() + documentos.capacity() * sizeof(RefTweet);
+		}
+
+		// Devuelve a través de 'lista' las (como mucho) 'k' etiquetas
+		// ("@usuario" o "#tema") con más apariciones estimadas en los
+		// tweets de los últimos 'segundos' segundos, hasta el tweet más
+		// reciente (ver Tendencias::obtener_tendencias). Si las tendencias
+		// no están activadas, la lista queda vacía.
+		void obtener_tendencias(unsigned k, unsigned long long segundos, ListaTendencias &lista) const {
+			tendencias.obtener_tendencias(k, segundos, lista);
+		}
+
+		// Devuelve la memoria ocupada por el recuento de tendencias, en
+		// bytes
+		std::size_t memoria_tendencias() const {
+			return tendencias.memoria();
+		}
+
+		// Devuelve la cronología del usuario: referencias a los 'n' tweets
+		// más recientes (o a todos, si hay menos) de los usuarios a los
+		// que sigue, del más reciente al más antiguo. A igual marca de
+		// tiempo, va primero el autor con mayor IdUsuario y, del mismo
+		// autor, el tweet con mayor número.
+		// PRECONDICIÓN: existe_usuario(usuario)
+		void cronologia(IdUsuario usuario, unsigned n, Cronologia &refs) const {
+			std::vector <EntradaCronologia> entradas;
+			const CacheCronologia *cache = (usuario < caches.size() && caches[usuario].activa) ? &caches[usuario] : nullptr;
+			if (cache != nullptr && (cache->completa || n <= cache->entradas.size())) {
+				// Las entradas de la caché están de la más antigua a la más reciente
+				std::size_t num = std::min(std::size_t(n), cache->entradas.size());
+				entradas.assign(cache->entradas.rbegin(), cache->entradas.rbegin() + std::ptrdiff_t(num));
+			}
+			else {
+				std::vector <IdUsuario> autores;
+				siguiendo.vecinos(usuario, autores);
+				fusionar_cronologias(autores, n, nullptr, entradas);
+			}
+			refs.resize(entradas.size());
+			for (std::size_t i = 0; i < entradas.size(); i++) {
+				refs[i] = entradas[i].ref;
+			}
+		}
+
+		// Devuelve a través de 'recomendados' hasta 'k' usuarios que
+		// 'usuario' podría seguir: los seguidos de sus seguidos (amigos de
+		// amigos) que no sean él ni ya los siga, de más a menos seguidos
+		// suyos que los siguen (a igualdad, por identificador). Si el
+		// usuario tiene las recomendaciones incrementales activadas (ver
+		// activar_recomendaciones), se sirven de sus cuentas; si no, se
+		// recorren los seguidos de sus seguidos con un contador denso por
+		// hilo (O(aristas recorridas) y sin reservar memoria por consulta).
+		// La segunda versión reparte los seguidos entre los hilos de
+		// 'reserva' (si tiene alguno), cada uno con su contador, y suma al
+		// final los recuentos de cada tramo.
+		// PRECONDICIÓN: existe_usuario(usuario)
+		void recomendar_seguir(IdUsuario usuario, unsigned k, std::vector <Recomendacion> &recomendados) const {
+			std::vector <IdUsuario> seguidos;
+			siguiendo.vecinos(usuario, seguidos);
+			std::unordered_map<IdUsuario, CuentasRecomendacion>::const_iterator cache = recomendaciones.find(usuario);
+			if (cache != recomendaciones.end()) {
+				recomendar_de_cuentas(usuario, seguidos, cache->second, k, recomendados);
+			}
+			else {
+				RecuentoCandidatos &recuento = recuento_hilo();
+				contar_amigos_de_amigos(seguidos, 0, seguidos.size(), recuento);
+				recomendar_de_recuento(usuario, seguidos, recuento, k, recomendados);
+			}
+		}
+		void recomendar_seguir(IdUsuario usuario, unsigned k, ReservaHilos &reserva,
+			std::vector <Recomendacion> &recomendados) const {
+			std::vector <IdUsuario> seguidos;
+			siguiendo.vecinos(usuario, seguidos);
+			std::unordered_map<IdUsuario, CuentasRecomendacion>::const_iterator cache = recomendaciones.find(usuario);
+			if (cache != recomendaciones.end() || reserva.num_hilos() == 0) {
+				// Sin más hilos, repartir solo añadiría la suma de los tramos
+				recomendar_seguir(usuario, k, recomendados);
+			}
+			else {
+				std::size_t num_tareas = std::min(seguidos.size(),
+					std::size_t(reserva.num_hilos() + 1) * TAREAS_POR_HILO_RECOMENDAR);
+				std::vector <std::vector <Recomendacion>> parciales(num_tareas);
+				reserva.ejecutar(unsigned(num_tareas), [this, &seguidos, &parciales, num_tareas](unsigned t) {
+					RecuentoCandidatos &recuento = recuento_hilo();
+					contar_amigos_de_amigos(seguidos, seguidos.size() * t / num_tareas,
+						seguidos.size() * (t + 1) / num_tareas, recuento);
+					extraer_candidatos(recuento, parciales[t]);
+				});
+				RecuentoCandidatos &recuento = recuento_hilo();
+				preparar_recuento(recuento);
+				for (std::size_t t = 0; t < parciales.size(); t++) {
+					for (std::size_t i = 0; i < parciales[t].size(); i++) {
+						contar_candidato(recuento, parciales[t][i].usuario, parciales[t][i].num_comunes);
+					}
+				}
+				recomendar_de_recuento(usuario, seguidos, recuento, k, recomendados);
+			}
+		}
+
+		// Devuelve, a través de 'usuario', un UsuarioTwitter con el
+		// identificador, los seguidores, los seguidos, los tweets y las
+		// menciones recibidas del usuario 'id' y 'OK' a través de 'res'. Si el usuario no existe, se
+		// devuelve 'NO_EXISTE' a través de 'res'.
+		void obtener_usuario(const std::string &id, UsuarioTwitter &usuario, Resultado &res) const {
+			IdUsuario id_usuario = TablaSimbolos::global().buscar(id);
+			res = existe_usuario(id_usuario) ? OK : NO_EXISTE;
+			if (res == OK) {
+				Resultado res_usuario;
+				std::vector<Resultado> res_usuarios;
+				Usuarios lista;
+				usuario = UsuarioTwitter(id);
+				obtener_seguidores(id_usuario, lista);
+				usuario.nuevo_seguidores(lista.listado, res_usuarios);
+				obtener_siguiendo(id_usuario, lista);
+				usuario.nuevo_siguiendos(lista.listado, res_usuarios);
+				for (unsigned i = 0; i < tweets[id_usuario].longitud(); i++) {
+					usuario.nuevo_tweet(tweets[id_usuario][i], res_usuario);
+				}
+				for (unsigned i = 0; i < menciones[id_usuario].size(); i++) {
+					usuario.nueva_mencion(menciones[id_usuario][i].autor, menciones[id_usuario][i].num_tweet, res_usuario);
+				}
+			}
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ACTUALIZACIÓN
+
+		// Da de alta en la red a un usuario sin seguidores, seguidos ni
+		// tweets y se devuelve 'OK' a través de 'res'. Si ya existía, se
+		// devuelve 'YA_EXISTE'.
+		void nuevo_usuario(const std::string &usuario, Resultado &res) {
+			nuevo_usuario(TablaSimbolos::global().registrar(usuario), res);
+		}
+		void nuevo_usuario(IdUsuario usuario, Resultado &res) {
+			res = existe_usuario(usuario) ? YA_EXISTE : OK;
+			if (res == OK) {
+				if (usuario >= registrado.size()) {
+					registrado.resize(std::size_t(usuario) + 1, false);
+					tweets.resize(std::size_t(usuario) + 1);
+					menciones.resize(std::size_t(usuario) + 1);
+				}
+				if (max_siguiendo_cache > 0) {
+					if (usuario >= caches.size()) {
+						caches.resize(registrado.size());
+					}
+					// Sin seguidos: cronología vacía y completa
+					caches[usuario].activa = true;
+					caches[usuario].completa = true;
+				}
+				registrado[usuario] = true;
+				num_registrados++;
+			}
+		}
+
+		// Da de alta en la red al usuario, sus seguidores y seguidos
+		// (los que no existían) y sus tweets (con sus menciones), y se
+		// devuelve 'OK' a través de 'res'. Si el usuario ya existía, no se modifica la red y se
+		// devuelve 'YA_EXISTE'. Si alguno de sus tweets está en un bloque
+		// sellado que no se puede leer (ver AlmacenFrio), solo se insertan
+		// los anteriores y se devuelve 'FIC_ERROR'.
+		void anyadir_usuario(const UsuarioTwitter &usuario, Resultado &res) {
+			IdUsuario id_usuario = TablaSimbolos::global().registrar(usuario.obtener_id());
+			nuevo_usuario(id_usuario, res);
+			if (res == OK) {
+				Resultado res_otro;
+				VistaUsuarios lista = usuario.ver_seguidores();
+				for (unsigned i = 0; i < lista.longitud(); i++) {
+					nuevo_usuario(lista[i], res_otro);
+					seguir(lista[i], id_usuario, res_otro);
+				}
+				lista = usuario.ver_siguiendo();
+				for (unsigned i = 0; i < lista.longitud(); i++) {
+					nuevo_usuario(lista[i], res_otro);
+					seguir(id_usuario, lista[i], res_otro);
+				}
+				VistaTweets lista_tweets = usuario.ver_tweets();
+				VistaTweets::const_iterator it = lista_tweets.begin();
+				for (; it != lista_tweets.end(); ++it) {
+					insertar_tweet(id_usuario, *it);
+				}
+				res = it.error() ? FIC_ERROR : OK;
+			}
+		}
+
+		// El usuario 'seguidor' pasa a seguir a 'seguido': se actualizan a
+		// la vez la lista de seguidos de uno y la de seguidores del otro y
+		// se devuelve 'OK' a través de 'res'. Si ya lo seguía, se devuelve
+		// 'YA_EXISTE'; si alguno de los dos usuarios no existe, 'NO_EXISTE'.
+		void seguir(const std::string &seguidor, const std::string &seguido, Resultado &res) {
+			const TablaSimbolos &tabla = TablaSimbolos::global();
+			seguir(tabla.buscar(seguidor), tabla.buscar(seguido), res);
+		}
+		void seguir(IdUsuario seguidor, IdUsuario seguido, Resultado &res) {
+			if (!existe_usuario(seguidor) || !existe_usuario(seguido)) {
+				res = NO_EXISTE;
+			}
+			else if (!siguiendo.insertar(seguidor, seguido)) {
+				res = YA_EXISTE;
+			}
+			else {
+				seguidores.insertar(seguido, seguidor);
+				compactar_si_necesario();
+				if (max_siguiendo_cache > 0 && caches[seguidor].activa) {
+					if (siguiendo.grado(seguidor) > max_siguiendo_cache) {
+						desactivar_cache(caches[seguidor]);
+					}
+					else {
+						anyadir_a_cache(seguidor, seguido);
+					}
+				}
+				if (!recomendaciones.empty()) {
+					actualizar_recomendaciones(seguidor, seguido, true);
+				}
+				res = OK;
+			}
+		}
+
+		// El usuario 'seguidor' deja de seguir a 'seguido': se actualizan a
+		// la vez las listas de ambos usuarios y se devuelve 'OK' a través de
+		// 'res'. Si no lo seguía (o alguno de los dos no existe), se devuelve
+		// 'NO_EXISTE'.
+		void dejar_de_seguir(const std::string &seguidor, const std::string &seguido, Resultado &res) {
+			const TablaSimbolos &tabla = TablaSimbolos::global();
+			dejar_de_seguir(tabla.buscar(seguidor), tabla.buscar(seguido), res);
+		}
+		void dejar_de_seguir(IdUsuario seguidor, IdUsuario seguido, Resultado &res) {
+			if (sigue_a(seguidor, seguido)) {
+				// Antes de quitar la arista, para restar lo mismo que se sumó
+				if (!recomendaciones.empty()) {
+					actualizar_recomendaciones(seguidor, seguido, false);
+				}
+				siguiendo.eliminar(seguidor, seguido);
+				seguidores.eliminar(seguido, seguidor);
+				compactar_si_necesario();
+				if (max_siguiendo_cache > 0) {
+					if (caches[seguidor].activa) {
+						quitar_de_cache(seguidor, seguido);
+					}
+					else if (siguiendo.grado(seguidor) <= max_siguiendo_cache) {
+						construir_cache(seguidor);
+					}
+				}
+				res = OK;
+			}
+			else {
+				res = NO_EXISTE;
+			}
+		}
+
+		// Inserta un nuevo tweet al final de la lista de tweets del usuario
+		// (truncado a MAX_LONG_TWEET caracteres), anota sus menciones e
+		// indexa sus palabras y se devuelve 'OK' a través de 'res'. Si el
+		// usuario no existe, se devuelve 'NO_EXISTE'.
+		// PRECONDICIÓN: fecha_hora_valida(nuevo.fecha_hora)
+		void nuevo_tweet(const std::string &autor, const Tweet &nuevo, Resultado &res) {
+			nuevo_tweet(TablaSimbolos::global().buscar(autor), nuevo, res);
+		}
+		void nuevo_tweet(IdUsuario autor, const Tweet &nuevo, Resultado &res) {
+			res = existe_usuario(autor) ? OK : NO_EXISTE;
+			if (res == OK) {
+				RegistroTweet registro;
+				registro.marca_tiempo = a_marca_tiempo(nuevo.fecha_hora);
+				registro.tweet = nuevo.tweet;
+				insertar_tweet(autor, registro);
+			}
+		}
+
+		// Añade al final de la lista de tweets del usuario los tweets del
+		// fichero 'nom_fic' (en el formato de UsuarioTwitter::guardar_tweets),
+		// anotando sus menciones e indexando sus palabras. Se devuelve 'OK'
+		// a través de 'res', 'FIC_ERROR' si no se puede abrir el fichero o
+		// tiene líneas mal formadas (que se saltan), o 'NO_EXISTE' si el
+		// usuario no existe.
+		void cargar_tweets(IdUsuario autor, const std::string &nom_fic, Resultado &res) {
+			res = existe_usuario(autor) ? OK : NO_EXISTE;
+			if (res == OK) {
+				std::vector <unsigned> lineas_erroneas;
+				RegistroTweet registro;
+				bool abierto = leer_fichero_tweets(nom_fic, lineas_erroneas, [this, autor, &registro](const LineaTweet &linea) {
+					registro.marca_tiempo = a_marca_tiempo(linea);
+					registro.tweet.assign(linea.texto, linea.longitud);
+					insertar_tweet(autor, registro);
+				});
+				res = (abierto && lineas_erroneas.empty()) ? OK : FIC_ERROR;
+			}
+		}
+
+		// Sustituye la red por la guardada en la instantánea 'nom_fic' (ver
+		// InstantaneaRed) y devuelve 'OK' a través de 'res'. Los tweets se
+		// insertan como con nuevo_tweet, con sus menciones y palabras según
+		// la configuración actual. Si el fichero no se puede abrir o no es
+		// una instantánea válida, no se modifica la red y se devuelve
+		// 'FIC_ERROR'. La segunda versión recibe una instantánea ya abierta.
+		void cargar_instantanea(const std::string &nom_fic, Resultado &res) {
+			InstantaneaRed instantanea;
+			instantanea.abrir(nom_fic, res);
+			if (res == OK) {
+				cargar_instantanea(instantanea);
+			}
+		}
+		void cargar_instantanea(const InstantaneaRed &instantanea) {
+			TablaSimbolos &tabla = TablaSimbolos::global();
+			std::uint32_t n = instantanea.num_usuarios();
+			// Se conserva la configuración
+			unsigned max_siguiendo = max_siguiendo_cache, capacidad = capacidad_cache;
+			bool menciones_activado = indexar_menciones, texto_activado = indexar_texto;
+			bool tendencias_activado = contar_tendencias;
+			Tendencias tendencias_vacia(tendencias);
+			tendencias_vacia.vaciar();
+			*this = RedSocial();
+			indexar_menciones = menciones_activado;
+			indexar_texto = texto_activado;
+			tendencias = tendencias_vacia;
+			contar_tendencias = tendencias_activado;
+
+			Resultado res_usuario;
+			std::vector <IdUsuario> globales(n);
+			for (std::uint32_t u = 0; u < n; u++) {
+				globales[u] = tabla.registrar(std::string(instantanea.nombre(u)));
+				nuevo_usuario(globales[u], res_usuario);
+			}
+			// Si la tabla de símbolos ya tenía alguno de los nombres, los
+			// IdUsuario pueden no seguir el orden de la instantánea
+			bool ordenados = std::is_sorted(globales.begin(), globales.end());
+			std::vector <std::uint32_t> locales(registrado.size(), ID_NULO);
+			for (std::uint32_t u = 0; u < n; u++) {
+				locales[globales[u]] = u;
+			}
+			std::vector <std::uint64_t> inicio;
+			std::vector <IdUsuario> adyacentes;
+			importar_grafo(instantanea, false, globales, locales, ordenados, inicio, adyacentes);
+			siguiendo.construir(inicio, adyacentes);
+			importar_grafo(instantanea, true, globales, locales, ordenados, inicio, adyacentes);
+			seguidores.construir(inicio, adyacentes);
+
+			for (std::uint32_t u = 0; u < n; u++) {
+				RegistroTweet registro;
+				for (unsigned i = 0; i < instantanea.num_tweets(u); i++) {
+					VistaTweet vista = instantanea.tweet(u, i);
+					registro.marca_tiempo = vista.marca_tiempo;
+					registro.tweet.assign(vista.tweet.data(), vista.tweet.size());
+					insertar_tweet(globales[u], registro);
+				}
+			}
+			// Las cronologías precalculadas se calculan al final, con el
+			// grafo y los tweets completos
+			if (max_siguiendo > 0) {
+				activar_cache_cronologia(max_siguiendo, capacidad);
+			}
+		}
+
+		// Guarda la red en la instantánea 'nom_fic' y devuelve 'OK' a
+		// través de 'res', o 'FIC_ERROR' si no se puede escribir (en ese
+		// caso, 'nom_fic' no cambia). Se escribe en 'nom_fic' + ".tmp", se
+		// sincroniza con el disco y se renombra. Se puede indicar la
+		// generación del último diario de operaciones que incluye (ver
+		// DiarioOperaciones).
+		void guardar_instantanea(const std::string &nom_fic, Resultado &res) const {
+			guardar_instantanea(nom_fic, 0, res);
+		}
+		void guardar_instantanea(const std::string &nom_fic, std::uint32_t generacion_diario, Resultado &res) const {
+			const TablaSimbolos &tabla = TablaSimbolos::global();
+			CabeceraInstantanea cabecera = CabeceraInstantanea();
+			std::vector <IdUsuario> globales;
+			std::vector <std::uint32_t> locales(registrado.size(), ID_NULO);
+			for (IdUsuario u = 0; u < registrado.size(); u++) {
+				if (registrado[u]) {
+					locales[u] = std::uint32_t(globales.size());
+					globales.push_back(u);
+				}
+			}
+			std::uint32_t n = std::uint32_t(globales.size());
+			// Nombres, tweets y sus textos
+			std::string cadenas;
+			std::vector <UsuarioInstantanea> usuarios(n);
+			std::vector <std::uint32_t> orden_nombres(n);
+			std::vector <std::uint64_t> tweets_inicio(1, 0);
+			std::vector <TweetInstantanea> lista_tweets;
+			for (std::uint32_t u = 0; u < n; u++) {
+				const std::string &nombre = tabla.nombre(globales[u]);
+				usuarios[u].pos_nombre = cadenas.size();
+				usuarios[u].long_nombre = std::uint32_t(nombre.size());
+				usuarios[u].reservado = 0;
+				cadenas += nombre;
+				orden_nombres[u] = u;
+			}
+			std::sort(orden_nombres.begin(), orden_nombres.end(), [&tabla, &globales](std::uint32_t a, std::uint32_t b) {
+				return tabla.nombre(globales[a]) < tabla.nombre(globales[b]);
+			});
+			for (std::uint32_t u = 0; u < n; u++) {
+				const ListaTweets &lista = tweets[globales[u]];
+				for (unsigned i = 0; i < lista.longitud(); i++) {
+					const RegistroTweet &registro = lista.registro(i);
+					TweetInstantanea t;
+					t.marca_tiempo = registro.marca_tiempo;
+					t.pos_texto = cadenas.size();
+					t.long_texto = std::uint32_t(registro.tweet.size());
+					t.reservado = 0;
+					cadenas += registro.tweet;
+					lista_tweets.push_back(t);
+				}
+				tweets_inicio.push_back(lista_tweets.size());
+			}
+			// Grafos, con los números de usuario de la instantánea
+			std::vector <std::uint64_t> siguiendo_inicio, seguidores_inicio;
+			std::vector <std::uint32_t> siguiendo_ids, seguidores_ids;
+			exportar_grafo(siguiendo, globales, locales, siguiendo_inicio, siguiendo_ids);
+			exportar_grafo(seguidores, globales, locales, seguidores_inicio, seguidores_ids);
+			// Cabecera: cada sección empieza en un múltiplo de 8 bytes
+			std::uint64_t pos = sizeof(CabeceraInstantanea);
+			std::memcpy(cabecera.magia, MAGIA_INSTANTANEA, sizeof(cabecera.magia));
+			cabecera.version = VERSION_INSTANTANEA;
+			cabecera.orden_bytes = MARCA_ORDEN_BYTES;
+			cabecera.num_usuarios = n;
+			cabecera.generacion_diario = generacion_diario;
+			cabecera.num_aristas = siguiendo_ids.size();
+			cabecera.num_tweets = lista_tweets.size();
+			cabecera.pos_usuarios = reservar_seccion(pos, usuarios.size() * sizeof(UsuarioInstantanea));
+			cabecera.pos_orden_nombres = reservar_seccion(pos, orden_nombres.size() * sizeof(std::uint32_t));
+			cabecera.pos_siguiendo_inicio = reservar_seccion(pos, siguiendo_inicio.size() * sizeof(std::uint64_t));
+			cabecera.pos_siguiendo = reservar_seccion(pos, siguiendo_ids.size() * sizeof(std::uint32_t));
+			cabecera.pos_seguidores_inicio = reservar_seccion(pos, seguidores_inicio.size() * sizeof(std::uint64_t));
+			cabecera.pos_seguidores = reservar_seccion(pos, seguidores_ids.size() * sizeof(std::uint32_t));
+			cabecera.pos_tweets_inicio = reservar_seccion(pos, tweets_inicio.size() * sizeof(std::uint64_t));
+			cabecera.pos_tweets = reservar_seccion(pos, lista_tweets.size() * sizeof(TweetInstantanea));
+			cabecera.pos_cadenas = reservar_seccion(pos, cadenas.size());
+			cabecera.tam_cadenas = cadenas.size();
+			cabecera.tam_fichero = pos;
+
+			std::string temporal = nom_fic + ".tmp";
+			std::ofstream fic(temporal, std::ios::binary | std::ios::trunc);
+			if (fic) {
+				fic.write(reinterpret_cast<const char *>(&cabecera), sizeof(cabecera));
+				escribir_seccion(fic, usuarios.data(), usuarios.size() * sizeof(UsuarioInstantanea));
+				escribir_seccion(fic, orden_nombres.data(), orden_nombres.size() * sizeof(std::uint32_t));
+				escribir_seccion(fic, siguiendo_inicio.data(), siguiendo_inicio.size() * sizeof(std::uint64_t));
+				escribir_seccion(fic, siguiendo_ids.data(), siguiendo_ids.size() * sizeof(std::uint32_t));
+				escribir_seccion(fic, seguidores_inicio.data(), seguidores_inicio.size() * sizeof(std::uint64_t));
+				escribir_seccion(fic, seguidores_ids.data(), seguidores_ids.size() * sizeof(std::uint32_t));
+				escribir_seccion(fic, tweets_inicio.data(), tweets_inicio.size() * sizeof(std::uint64_t));
+				escribir_seccion(fic, lista_tweets.data(), lista_tweets.size() * sizeof(TweetInstantanea));
+				escribir_seccion(fic, cadenas.data(), cadenas.size());
+				fic.close();
+			}
+			if (fic && sincronizar_fichero(temporal) && std::rename(temporal.c_str(), nom_fic.c_str()) == 0) {
+				res = OK;
+			}
+			else {
+				std::remove(temporal.c_str());
+				res = FIC_ERROR;
+			}
+		}
+
+		// Activa o desactiva la anotación de menciones al insertar tweets
+		// (activada por defecto). Los tweets insertados mientras está
+		// desactivada no se anotan después.
+		void activar_indice_menciones(bool activar) {
+			indexar_menciones = activar;
+		}
+
+		// Activa o desactiva el índice de palabras al insertar tweets
+		// (activado por defecto). Los tweets insertados mientras está
+		// desactivado no se indexan después.
+		void activar_indice_texto(bool activar) {
+			indexar_texto = activar;
+		}
+
+		// Activa el recuento de tendencias al insertar tweets (desactivado
+		// por defecto) en 'num_cubetas' cubetas de 'segundos_cubeta'
+		// segundos: se pueden consultar ventanas de hasta
+		// num_cubetas * segundos_cubeta segundos. Ocupa como mucho
+		// 'num_cubetas' sketches de FILAS_SKETCH_TENDENCIAS x 'ancho'
+		// contadores, más 'candidatos' etiquetas por cubeta. Al activarlo
+		// o desactivarlo se olvida lo contado.
+		// PRECONDICIÓN: segundos_cubeta > 0, num_cubetas > 0, ancho > 0,
+		//               candidatos > 0
+		void activar_tendencias(bool activar) {
+			activar_tendencias(activar, SEGUNDOS_CUBETA_TENDENCIAS, NUM_CUBETAS_TENDENCIAS,
+				ANCHO_SKETCH_TENDENCIAS, CANDIDATOS_TENDENCIAS);
+		}
+		void activar_tendencias(bool activar, unsigned segundos_cubeta, unsigned num_cubetas, unsigned ancho,
+			unsigned candidatos) {
+			contar_tendencias = activar;
+			tendencias = activar ? Tendencias(segundos_cubeta, num_cubetas, ancho, candidatos) : Tendencias();
+		}
+
+		// Activa la cronología precalculada (fan-out en escritura) para los
+		// usuarios que siguen como mucho a 'max_siguiendo' usuarios: cada
+		// uno guarda hasta 2 * 'capacidad' referencias a los tweets más
+		// recientes de sus seguidos, y las cronologías de como mucho
+		// 'capacidad' tweets se sirven sin fusionar listas. Con
+		// 'max_siguiendo' igual a 0 se desactiva y se libera la memoria.
+		void activar_cache_cronologia(unsigned max_siguiendo, unsigned capacidad) {
+			max_siguiendo_cache = (capacidad > 0) ? max_siguiendo : 0;
+			capacidad_cache = capacidad;
+			std::vector <CacheCronologia>().swap(caches);
+			if (max_siguiendo_cache > 0) {
+				caches.resize(registrado.size());
+				for (IdUsuario u = 0; u < registrado.size(); u++) {
+					if (registrado[u] && siguiendo.grado(u) <= max_siguiendo_cache) {
+						construir_cache(u);
+					}
+				}
+			}
+		}
+
+		// Activa (o desactiva) las recomendaciones incrementales de
+		// 'usuario' (por ejemplo, mientras tiene abierta la sesión): se
+		// cuentan una vez los seguidos de sus seguidos y, a partir de ahí,
+		// cada seguir o dejar_de_seguir que les afecta suma o resta en esas
+		// cuentas en lugar de recalcularlas. Ocupan memoria proporcional
+		// al número de amigos de amigos del usuario. Al cargar una
+		// instantánea se desactivan todas.
+		// PRECONDICIÓN: existe_usuario(usuario)
+		void activar_recomendaciones(IdUsuario usuario, bool activar) {
+			if (!activar) {
+				recomendaciones.erase(usuario);
+			}
+			else if (recomendaciones.find(usuario) == recomendaciones.end()) {
+				std::vector <IdUsuario> seguidos;
+				std::vector <Recomendacion> candidatos;
+				siguiendo.vecinos(usuario, seguidos);
+				RecuentoCandidatos &recuento = recuento_hilo();
+				contar_amigos_de_amigos(seguidos, 0, seguidos.size(), recuento);
+				extraer_candidatos(recuento, candidatos);
+				CuentasRecomendacion &cuentas = recomendaciones[usuario];
+				cuentas.reserve(candidatos.size());
+				for (std::size_t i = 0; i < candidatos.size(); i++) {
+					cuentas.emplace(candidatos[i].usuario, candidatos[i].num_comunes);
+				}
+			}
+		}
+
+		// Incorpora al formato CSR los cambios pendientes de ambos grafos.
+		// Se hace automáticamente cuando los cambios pendientes superan una
+		// fracción del grafo; este método fuerza la compactación (por
+		// ejemplo, tras una carga masiva).
+		void compactar() {
+			siguiendo.compactar();
+			seguidores.compactar();
+		}
+
+	private:
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		// Usuarios de la red, indexados por IdUsuario
+		std::vector <bool> registrado;
+		unsigned num_registrados;
+		// Lista de tweets de cada usuario, indexada por IdUsuario
+		std::vector <ListaTweets> tweets;
+		// Menciones recibidas por cada usuario (lista invertida de pares
+		// autor, número de tweet), indexada por IdUsuario
+		std::vector <ListaMenciones> menciones;
+		bool indexar_menciones;
+		// Índice de palabras de los tweets y tweet que corresponde a cada
+		// documento del índice
+		IndiceTexto indice_texto;
+		std::vector <RefTweet> documentos;
+		bool indexar_texto;
+		// Recuento de las etiquetas de los tweets recientes
+		Tendencias tendencias;
+		bool contar_tendencias;
+		// Aristas seguidor -> seguido y seguido -> seguidor
+		GrafoCSR siguiendo, seguidores;
+
+		// Tweet de una cronología con su marca de tiempo, para ordenar
+		struct EntradaCronologia {
+			MarcaTiempo marca;
+			RefTweet ref;
+		};
+		// Cronología precalculada de un usuario: sus entradas son las más
+		// recientes de sus seguidos, ordenadas de la más antigua a la más
+		// reciente; ningún tweet de sus seguidos que falte es posterior a
+		// la primera. Si 'completa', no falta ninguno.
+		struct CacheCronologia {
+			CacheCronologia() : activa(false), completa(false), entradas() {}
+			bool activa, completa;
+			std::vector <EntradaCronologia> entradas;
+		};
+		// Posición en la lista de tweets de un autor durante la fusión. Si
+		// la lista no está en orden cronológico, se recorre 'orden' (los
+		// números de sus tweets más recientes, del más reciente al más
+		// antiguo) a partir de 'sig_orden'.
+		struct CursorCronologia {
+			EntradaCronologia actual;
+			unsigned restantes;
+			std::size_t sig_orden;
+		};
+		// Cronología precalculada de cada usuario, indexada por IdUsuario
+		// (vacío si está desactivada)
+		std::vector <CacheCronologia> caches;
+		unsigned max_siguiendo_cache, capacidad_cache;
+
+		// Cuentas de las recomendaciones incrementales de un usuario: por
+		// cada seguido de sus seguidos (incluidos él mismo y los que ya
+		// sigue, que se filtran al recomendar), cuántos de sus seguidos lo
+		// siguen
+		typedef std::unordered_map <IdUsuario, unsigned> CuentasRecomendacion;
+		// Usuarios con las recomendaciones incrementales activadas
+		std::unordered_map <IdUsuario, CuentasRecomendacion> recomendaciones;
+		// Contador denso de candidatos de un hilo: 'cuentas' está indexado
+		// por IdUsuario y vale cero salvo para los 'tocados' del recuento
+		// en curso
+		struct RecuentoCandidatos {
+			std::vector <unsigned> cuentas;
+			std::vector <IdUsuario> tocados;
+		};
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS
+		//
+		// Inserta un tweet al final de la lista de tweets de 'autor' y, si
+		// están activados, anota sus menciones, indexa sus palabras y lo
+		// añade a las cronologías precalculadas de sus seguidores
+		void insertar_tweet(IdUsuario autor, const RegistroTweet &registro) {
+			unsigned num_tweet = tweets[autor].longitud();
+			tweets[autor].insertar_final(registro);
+			if (indexar_menciones) {
+				anotar_menciones(autor, num_tweet, registro.tweet);
+			}
+			if (indexar_texto) {
+				RefTweet ref;
+				ref.autor = autor;
+				ref.num_tweet = num_tweet;
+				indice_texto.indexar(IdDocumento(documentos.size()), registro.tweet);
+				documentos.push_back(ref);
+			}
+			if (contar_tendencias) {
+				tendencias.anotar(registro.marca_tiempo, registro.tweet);
+			}
+			if (max_siguiendo_cache > 0) {
+				EntradaCronologia nueva;
+				std::vector <IdUsuario> lectores;
+				nueva.marca = registro.marca_tiempo;
+				nueva.ref.autor = autor;
+				nueva.ref.num_tweet = num_tweet;
+				seguidores.vecinos(autor, lectores);
+				for (std::size_t i = 0; i < lectores.size(); i++) {
+					if (caches[lectores[i]].activa) {
+						insertar_en_cache(caches[lectores[i]], nueva);
+					}
+				}
+			}
+		}
+
+		// Añade la mención (autor, num_tweet) a cada usuario de la red
+		// mencionado en 'texto'. Si un usuario aparece varias veces en el
+		// mismo tweet, se anota una sola mención.
+		void anotar_menciones(IdUsuario autor, unsigned num_tweet, std::string_view texto) {
+			const TablaSimbolos &tabla = TablaSimbolos::global();
+			recorrer_etiquetas(texto.data(), texto.size(), '@',
+				[this, &tabla, autor, num_tweet](const char *nombre, std::size_t longitud) {
+				IdUsuario mencionado = tabla.buscar(nombre, longitud);
+				if (existe_usuario(mencionado)) {
+					ListaMenciones &lista = menciones[mencionado];
+					if (lista.empty() || lista.back().autor != autor || lista.back().num_tweet != num_tweet) {
+						Mencion nueva;
+						nueva.autor = autor;
+						nueva.num_tweet = num_tweet;
+						lista.push_back(nueva);
+					}
+				}
+			});
+		}
+
+		// Orden de las entradas de una cronología: por marca de tiempo, por
+		// autor y por número de tweet
+		static bool mas_antigua(const EntradaCronologia &a, const EntradaCronologia &b) {
+			return a.marca < b.marca
+				|| (a.marca == b.marca && (a.ref.autor < b.ref.autor
+					|| (a.ref.autor == b.ref.autor && a.ref.num_tweet < b.ref.num_tweet)));
+		}
+		static bool mas_reciente(const EntradaCronologia &a, const EntradaCronologia &b) {
+			return mas_antigua(b, a);
+		}
+		static bool cursor_mas_antiguo(const CursorCronologia &a, const CursorCronologia &b) {
+			return mas_antigua(a.actual, b.actual);
+		}
+
+		// Entrada de cronología del tweet 'num_tweet' de 'autor'
+		EntradaCronologia entrada(IdUsuario autor, unsigned num_tweet) const {
+			EntradaCronologia e;
+			e.marca = tweets[autor].registro(num_tweet).marca_tiempo;
+			e.ref.autor = autor;
+			e.ref.num_tweet = num_tweet;
+			return e;
+		}
+
+		// Devuelve a través de 'salida' los 'n' tweets más recientes de los
+		// 'autores' (posteriores a 'limite', si no es nulo), del más
+		// reciente al más antiguo. Fusión de k listas con un montículo:
+		// coste O(k + n log k), más la ordenación parcial de las listas que
+		// no están en orden cronológico.
+		void fusionar_cronologias(const std::vector <IdUsuario> &autores, unsigned n,
+			const EntradaCronologia *limite, std::vector <EntradaCronologia> &salida) const {
+			const std::size_t SIN_ORDEN = std::size_t(-1);
+			std::vector <CursorCronologia> monticulo;
+			std::vector <unsigned> orden;
+			salida.clear();
+			monticulo.reserve(autores.size());
+			for (std::size_t i = 0; i < autores.size(); i++) {
+				const ListaTweets &lista = tweets[autores[i]];
+				CursorCronologia cursor;
+				cursor.restantes = std::min(lista.longitud(), n);
+				if (cursor.restantes > 0) {
+					if (lista.es_cronologica()) {
+						cursor.actual = entrada(autores[i], lista.longitud() - 1);
+						cursor.sig_orden = SIN_ORDEN;
+					}
+					else {
+						// Números de sus 'restantes' tweets más recientes, en orden
+						std::vector <EntradaCronologia> todas(lista.longitud());
+						for (unsigned t = 0; t < lista.longitud(); t++) {
+							todas[t] = entrada(autores[i], t);
+						}
+						std::partial_sort(todas.begin(), todas.begin() + cursor.restantes, todas.end(), mas_reciente);
+						cursor.actual = todas[0];
+						cursor.sig_orden = orden.size() + 1;
+						for (unsigned t = 0; t < cursor.restantes; t++) {
+							orden.push_back(todas[t].ref.num_tweet);
+						}
+					}
+					monticulo.push_back(cursor);
+				}
+			}
+			std::make_heap(monticulo.begin(), monticulo.end(), cursor_mas_antiguo);
+			while (salida.size() < n && !monticulo.empty()
+				&& (limite == nullptr || mas_antigua(*limite, monticulo.front().actual))) {
+				std::pop_heap(monticulo.begin(), monticulo.end(), cursor_mas_antiguo);
+				CursorCronologia &cursor = monticulo.back();
+				salida.push_back(cursor.actual);
+				cursor.restantes--;
+				if (cursor.restantes == 0) {
+					monticulo.pop_back();
+				}
+				else {
+					if (cursor.sig_orden == SIN_ORDEN) {
+						cursor.actual = entrada(cursor.actual.ref.autor, cursor.actual.ref.num_tweet - 1);
+					}
+					else {
+						cursor.actual = entrada(cursor.actual.ref.autor, orden[cursor.sig_orden]);
+						cursor.sig_orden++;
+					}
+					std::push_heap(monticulo.begin(), monticulo.end(), cursor_mas_antiguo);
+				}
+			}
+		}
+
+		// Calcula la cronología precalculada de 'usuario' fusionando las
+		// listas de sus seguidos
+		void construir_cache(IdUsuario usuario) {
+			CacheCronologia &cache = caches[usuario];
+			std::vector <IdUsuario> autores;
+			siguiendo.vecinos(usuario, autores);
+			fusionar_cronologias(autores, capacidad_cache, nullptr, cache.entradas);
+			std::reverse(cache.entradas.begin(), cache.entradas.end());
+			cache.activa = true;
+			cache.completa = cache.entradas.size() < capacidad_cache;
+		}
+
+		// Libera la cronología precalculada de un usuario
+		void desactivar_cache(CacheCronologia &cache) {
+			cache.activa = false;
+			cache.completa = false;
+			std::vector <EntradaCronologia>().swap(cache.entradas);
+		}
+
+		// Inserta un tweet en su posición de la cronología precalculada. Si
+		// no está completa, solo se inserta si es posterior a la primera
+		// entrada (si no, podría faltar algún tweet posterior a él).
+		void insertar_en_cache(CacheCronologia &cache, const EntradaCronologia &nueva) {
+			if (cache.completa || (!cache.entradas.empty() && mas_antigua(cache.entradas.front(), nueva))) {
+				std::vector <EntradaCronologia>::iterator pos = cache.entradas.end();
+				while (pos != cache.entradas.begin() && mas_antigua(nueva, *(pos - 1))) {
+					--pos;
+				}
+				cache.entradas.insert(pos, nueva);
+				recortar_cache(cache);
+			}
+		}
+
+		// Añade a la cronología precalculada de 'usuario' los tweets de un
+		// nuevo seguido
+		void anyadir_a_cache(IdUsuario usuario, IdUsuario seguido) {
+			CacheCronologia &cache = caches[usuario];
+			std::vector <EntradaCronologia> nuevas;
+			std::vector <IdUsuario> autores(1, seguido);
+			std::size_t num_antiguas = cache.entradas.size();
+			if (!cache.completa && cache.entradas.empty()) {
+				// Ninguna entrada sirve de límite
+				construir_cache(usuario);
+			}
+			else {
+				fusionar_cronologias(autores, capacidad_cache, cache.completa ? nullptr : &cache.entradas.front(), nuevas);
+				if (nuevas.size() == capacidad_cache && capacidad_cache < tweets[seguido].longitud()) {
+					// Pueden faltar tweets del nuevo seguido anteriores al
+					// último copiado: se quitan las entradas más antiguas
+					// que él
+					std::vector <EntradaCronologia>::iterator corte =
+						std::lower_bound(cache.entradas.begin(), cache.entradas.end(), nuevas.back(), mas_antigua);
+					num_antiguas -= std::size_t(corte - cache.entradas.begin());
+					cache.entradas.erase(cache.entradas.begin(), corte);
+					cache.completa = false;
+				}
+				cache.entradas.insert(cache.entradas.end(), nuevas.rbegin(), nuevas.rend());
+				std::inplace_merge(cache.entradas.begin(), cache.entradas.begin() + std::ptrdiff_t(num_antiguas),
+					cache.entradas.end(), mas_antigua);
+				recortar_cache(cache);
+			}
+		}
+
+		// Quita de la cronología precalculada de 'usuario' los tweets de un
+		// seguido. Si quedan menos de la mitad de las entradas, se
+		// reconstruye.
+		void quitar_de_cache(IdUsuario usuario, IdUsuario seguido) {
+			CacheCronologia &cache = caches[usuario];
+			std::vector <EntradaCronologia>::iterator fin = std::remove_if(cache.entradas.begin(), cache.entradas.end(),
+				[seguido](const EntradaCronologia &e) { return e.ref.autor == seguido; });
+			cache.entradas.erase(fin, cache.entradas.end());
+			if (!cache.completa && cache.entradas.size() < capacidad_cache / 2) {
+				construir_cache(usuario);
+			}
+		}
+
+		// Si la cronología precalculada supera el doble de su capacidad, se
+		// quitan las entradas más antiguas hasta dejarla en la capacidad
+		// (así el coste de quitarlas es constante por tweet insertado)
+		void recortar_cache(CacheCronologia &cache) {
+			if (cache.entradas.size() > 2 * std::size_t(capacidad_cache)) {
+				cache.entradas.erase(cache.entradas.begin(), cache.entradas.end() - std::ptrdiff_t(capacidad_cache));
+				cache.completa = false;
+			}
+		}
+
+		// Devuelve el contador de candidatos del hilo que llama (se reutiliza
+		// de una recomendación a otra)
+		static RecuentoCandidatos & recuento_hilo() {
+			static thread_local RecuentoCandidatos recuento;
+			return recuento;
+		}
+
+		// Deja sitio en el contador para todos los usuarios de la red
+		void preparar_recuento(RecuentoCandidatos &recuento) const {
+			if (recuento.cuentas.size() < registrado.size()) {
+				recuento.cuentas.resize(registrado.size(), 0);
+			}
+		}
+
+		// Suma 'veces' a la cuenta de 'candidato'
+		static void contar_candidato(RecuentoCandidatos &recuento, IdUsuario candidato, unsigned veces) {
+			if (recuento.cuentas[candidato] == 0) {
+				recuento.tocados.push_back(candidato);
+			}
+			recuento.cuentas[candidato] += veces;
+		}
+
+		// Cuenta en 'recuento' los seguidos de seguidos[desde, hasta)
+		void contar_amigos_de_amigos(const std::vector <IdUsuario> &seguidos, std::size_t desde, std::size_t hasta,
+			RecuentoCandidatos &recuento) const {
+			std::vector <IdUsuario> segundos;
+			preparar_recuento(recuento);
+			for (std::size_t i = desde; i < hasta; i++) {
+				siguiendo.vecinos(seguidos[i], segundos);
+				for (std::size_t j = 0; j < segundos.size(); j++) {
+					contar_candidato(recuento, segundos[j], 1);
+				}
+			}
+		}
+
+		// Pasa los candidatos con cuenta distinta de cero de 'recuento' a
+		// 'candidatos' y deja el recuento a cero
+		static void extraer_candidatos(RecuentoCandidatos &recuento, std::vector <Recomendacion> &candidatos) {
+			candidatos.clear();
+			candidatos.reserve(recuento.tocados.size());
+			for (std::size_t i = 0; i < recuento.tocados.size(); i++) {
+				IdUsuario candidato = recuento.tocados[i];
+				if (recuento.cuentas[candidato] > 0) {
+					Recomendacion recomendacion;
+					recomendacion.usuario = candidato;
+					recomendacion.num_comunes = recuento.cuentas[candidato];
+					candidatos.push_back(recomendacion);
+					recuento.cuentas[candidato] = 0;
+				}
+			}
+			recuento.tocados.clear();
+		}
+
+		// Recomendaciones a partir de un recuento recién hecho: se anulan las
+		// cuentas del usuario y de sus seguidos, se eligen las 'k' mayores
+		// y se deja el recuento a cero
+		void recomendar_de_recuento(IdUsuario usuario, const std::vector <IdUsuario> &seguidos,
+			RecuentoCandidatos &recuento, unsigned k, std::vector <Recomendacion> &recomendados) const {
+			recuento.cuentas[usuario] = 0;
+			for (std::size_t i = 0; i < seguidos.size(); i++) {
+				recuento.cuentas[seguidos[i]] = 0;
+			}
+			recomendados.clear();
+			for (std::size_t i = 0; i < recuento.tocados.size(); i++) {
+				IdUsuario candidato = recuento.tocados[i];
+				if (recuento.cuentas[candidato] > 0) {
+					Recomendacion recomendacion;
+					recomendacion.usuario = candidato;
+					recomendacion.num_comunes = recuento.cuentas[candidato];
+					if (entra_en_recomendados(recomendados, k, recomendacion)) {
+						anyadir_a_recomendados(recomendados, k, recomendacion);
+					}
+					recuento.cuentas[candidato] = 0;
+				}
+			}
+			recuento.tocados.clear();
+			std::sort_heap(recomendados.begin(), recomendados.end(), mejor_recomendacion);
+		}
+
+		// Recomendaciones a partir de las cuentas incrementales de
+		// 'usuario'. Solo se comprueba si ya sigue a un candidato cuando
+		// este entraría entre los 'k' mejores hasta el momento.
+		static void recomendar_de_cuentas(IdUsuario usuario, const std::vector <IdUsuario> &seguidos,
+			const CuentasRecomendacion &cuentas, unsigned k, std::vector <Recomendacion> &recomendados) {
+			recomendados.clear();
+			for (CuentasRecomendacion::const_iterator it = cuentas.begin(); it != cuentas.end(); ++it) {
+				Recomendacion recomendacion;
+				recomendacion.usuario = it->first;
+				recomendacion.num_comunes = it->second;
+				if (entra_en_recomendados(recomendados, k, recomendacion) && it->first != usuario
+					&& !std::binary_search(seguidos.begin(), seguidos.end(), it->first)) {
+					anyadir_a_recomendados(recomendados, k, recomendacion);
+				}
+			}
+			std::sort_heap(recomendados.begin(), recomendados.end(), mejor_recomendacion);
+		}
+
+		// Orden de las recomendaciones: más cuentas primero y, a igualdad,
+		// menor identificador
+		static bool mejor_recomendacion(const Recomendacion &a, const Recomendacion &b) {
+			return a.num_comunes > b.num_comunes || (a.num_comunes == b.num_comunes && a.usuario < b.usuario);
+		}
+
+		// Los 'k' mejores candidatos hasta el momento se guardan en un
+		// montículo con el peor en la cima. Indica si 'candidato' entraría.
+		static bool entra_en_recomendados(const std::vector <Recomendacion> &monticulo, unsigned k,
+			const Recomendacion &candidato) {
+			return monticulo.size() < k || (k > 0 && mejor_recomendacion(candidato, monticulo.front()));
+		}
+
+		// Añade 'candidato' al montículo y, si pasa de 'k', quita el peor
+		// PRECONDICIÓN: entra_en_recomendados(monticulo, k, candidato)
+		static void anyadir_a_recomendados(std::vector <Recomendacion> &monticulo, unsigned k,
+			const Recomendacion &candidato) {
+			monticulo.push_back(candidato);
+			std::push_heap(monticulo.begin(), monticulo.end(), mejor_recomendacion);
+			if (monticulo.size() > k) {
+				std::pop_heap(monticulo.begin(), monticulo.end(), mejor_recomendacion);
+				monticulo.pop_back();
+			}
+		}
+
+		// Suma (o, si no 'alta', resta) en las cuentas incrementales la
+		// arista 'seguidor' -> 'seguido', que se acaba de insertar o se va
+		// a eliminar:
+		//  - si 'seguidor' las tiene activadas, cada seguido de 'seguido'
+		//    tiene un seguido más (o menos) de 'seguidor' que lo sigue
+		//  - para cada usuario con ellas activadas que sigue a 'seguidor',
+		//    'seguido' tiene un seguido más (o menos) que lo sigue
+		// Si 'seguidor' se sigue a sí mismo con esta arista, el segundo
+		// caso ya está contado en el primero.
+		void actualizar_recomendaciones(IdUsuario seguidor, IdUsuario seguido, bool alta) {
+			std::unordered_map<IdUsuario, CuentasRecomendacion>::iterator propia = recomendaciones.find(seguidor);
+			if (propia != recomendaciones.end()) {
+				std::vector <IdUsuario> segundos;
+				siguiendo.vecinos(seguido, segundos);
+				for (std::size_t i = 0; i < segundos.size(); i++) {
+					sumar_cuenta(propia->second, segundos[i], alta);
+				}
+			}
+			// Se recorre lo más corto: los usuarios con recomendaciones o los
+			// seguidores de 'seguidor'
+			if (recomendaciones.size() <= seguidores.grado(seguidor)) {
+				for (std::unordered_map<IdUsuario, CuentasRecomendacion>::iterator it = recomendaciones.begin();
+					it != recomendaciones.end(); ++it) {
+					if ((it->first != seguidor || seguidor != seguido) && siguiendo.contiene(it->first, seguidor)) {
+						sumar_cuenta(it->second, seguido, alta);
+					}
+				}
+			}
+			else {
+				std::vector <IdUsuario> lectores;
+				seguidores.vecinos(seguidor, lectores);
+				for (std::size_t i = 0; i < lectores.size(); i++) {
+					std::unordered_map<IdUsuario, CuentasRecomendacion>::iterator it = recomendaciones.find(lectores[i]);
+					if (it != recomendaciones.end() && (it->first != seguidor || seguidor != seguido)) {
+						sumar_cuenta(it->second, seguido, alta);
+					}
+				}
+			}
+		}
+
+		// Suma (o resta) uno a la cuenta de 'candidato'; las cuentas que
+		// llegan a cero se quitan
+		static void sumar_cuenta(CuentasRecomendacion &cuentas, IdUsuario candidato, bool sumar) {
+			if (sumar) {
+				cuentas[candidato]++;
+			}
+			else {
+				CuentasRecomendacion::iterator it = cuentas.find(candidato);
+				if (it != cuentas.end() && --it->second == 0) {
+					cuentas.erase(it);
+				}
+			}
+		}
+
+		// Devuelve el CSR de un grafo con los números de usuario locales de
+		// una instantánea
+		static void exportar_grafo(const GrafoCSR &grafo, const std::vector <IdUsuario> &globales,
+			const std::vector <std::uint32_t> &locales, std::vector <std::uint64_t> &inicio, std::vector <std::uint32_t> &ids) {
+			std::vector <IdUsuario> vecinos;
+			inicio.assign(1, 0);
+			ids.clear();
+			ids.reserve(grafo.aristas());
+			for (std::size_t u = 0; u < globales.size(); u++) {
+				grafo.vecinos(globales[u], vecinos);
+				for (std::size_t i = 0; i < vecinos.size(); i++) {
+					ids.push_back(locales[vecinos[i]]);
+				}
+				inicio.push_back(ids.size());
+			}
+		}
+
+		// Devuelve el CSR, por IdUsuario, de los seguidos (o, si
+		// 'de_seguidores', de los seguidores) de una instantánea
+		void importar_grafo(const InstantaneaRed &instantanea, bool de_seguidores, const std::vector <IdUsuario> &globales,
+			const std::vector <std::uint32_t> &locales, bool ordenados,
+			std::vector <std::uint64_t> &inicio, std::vector <IdUsuario> &adyacentes) const {
+			inicio.assign(1, 0);
+			adyacentes.clear();
+			adyacentes.reserve(instantanea.num_aristas());
+			for (IdUsuario u = 0; u < registrado.size(); u++) {
+				if (locales[u] != ID_NULO) {
+					TramoUsuarios lista = de_seguidores ? instantanea.seguidores(locales[u]) : instantanea.siguiendo(locales[u]);
+					std::size_t principio = adyacentes.size();
+					for (std::size_t i = 0; i < lista.num; i++) {
+						adyacentes.push_back(globales[lista.ids[i]]);
+					}
+					if (!ordenados) {
+						std::sort(adyacentes.begin() + std::ptrdiff_t(principio), adyacentes.end());
+					}
+				}
+				inicio.push_back(adyacentes.size());
+			}
+		}
+
+		// Devuelve la posición de una sección de 'tam' bytes que empieza en
+		// 'pos' (redondeada a un múltiplo de 8) y avanza 'pos' hasta su final
+		static std::uint64_t reservar_seccion(std::uint64_t &pos, std::size_t tam) {
+			std::uint64_t principio = (pos + 7) / 8 * 8;
+			pos = principio + tam;
+			return principio;
+		}
+
+		// Escribe una sección precedida del relleno necesario para que
+		// empiece en un múltiplo de 8 bytes
+		static void escribir_seccion(std::ofstream &fic, const void *datos, std::size_t tam) {
+			static const char relleno[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+			std::streamoff pos = fic.tellp();
+			fic.write(relleno, (8 - pos % 8) % 8);
+			fic.write(static_cast<const char *>(datos), std::streamsize(tam));
+		}
+
+		// Sincroniza con el disco el contenido del fichero 'nom_fic'.
+		// Devuelve false si no se puede.
+		static bool sincronizar_fichero(const std::string &nom_fic) {
+#if defined(__RED_SOCIAL_POSIX__)
+			int descriptor = ::open(nom_fic.c_str(), O_RDONLY);
+			bool correcto = descriptor >= 0 && ::fsync(descriptor) == 0;
+			if (descriptor >= 0) {
+				::close(descriptor);
+			}
+			return correcto;
+#else
+			return bool(std::ifstream(nom_fic));
+#endif
+		}
+
+		// Compacta cada grafo cuando acumula demasiados cambios pendientes
+		void compactar_si_necesario() {
+			if (siguiendo.debe_compactar()) {
+				siguiendo.compactar();
+			}
+			if (seguidores.debe_compactar()) {
+				seguidores.compactar();
+			}
+		}
+	};
+}
+#endif
@@ -0,0 +1,170 @@
+/****************************************************************************
+* Clase ReservaHilos
+*
+* Grupo fijo de hilos que ejecutan tareas numeradas con robo de trabajo
+* (work stealing): cada hilo tiene su propia cola de tareas, de la que
+* toma las más recientes, y cuando se le acaba roba las más antiguas de
+* las colas de los demás. Así, si unas tareas tardan más que otras, los
+* hilos que terminan antes ayudan a los demás sin un reparto central.
+*
+* ejecutar(num, funcion) reparte las tareas 0..num-1 entre las colas,
+* espera a que terminen todas y vuelve; el hilo que llama también
+* ejecuta tareas mientras espera.
+****************************************************************************/
+
+#ifndef __RESERVA__HILOS__
+#define __RESERVA__HILOS__
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace bblProgII {
+	class ReservaHilos {
+	public:
+		// Constructor: 'num_hilos' hilos además del que llama a ejecutar()
+		// (0 para ejecutar todas las tareas en el hilo que llama)
+		explicit ReservaHilos(unsigned num_hilos) :
+			colas(), hilos(), mutex_ejecutar(), mutex_estado(), hay_trabajo(), terminado(),
+			trabajo(nullptr), pendientes(0), generacion(0), fin(false) {
+			for (unsigned i = 0; i <= num_hilos; i++) {
+				colas.push_back(std::unique_ptr<Cola>(new Cola()));
+			}
+			for (unsigned i = 0; i < num_hilos; i++) {
+				hilos.push_back(std::thread(&ReservaHilos::bucle_hilo, this, i + 1));
+			}
+		}
+
+		// Destructor: termina los hilos
+		~ReservaHilos() {
+			{
+				std::lock_guard<std::mutex> cerrojo(mutex_estado);
+				fin = true;
+			}
+			hay_trabajo.notify_all();
+			for (std::size_t i = 0; i < hilos.size(); i++) {
+				hilos[i].join();
+			}
+		}
+
+		// Devuelve el número de hilos (sin contar el que llama a ejecutar())
+		unsigned num_hilos() const {
+			return unsigned(hilos.size());
+		}
+
+		// Ejecuta 'funcion(t)' para cada tarea 't' de 0 a 'num_tareas' - 1,
+		// repartidas entre los hilos, y vuelve cuando han terminado todas.
+		// Si se llama desde varios hilos a la vez, las llamadas se ejecutan
+		// de una en una.
+		// PRECONDICIÓN: no se llama desde dentro de una tarea
+		void ejecutar(unsigned num_tareas, const std::function<void(unsigned)> &funcion) {
+			std::lock_guard<std::mutex> cerrojo_ejecutar(mutex_ejecutar);
+			if (num_tareas > 0) {
+				trabajo = &funcion;
+				pendientes.store(num_tareas, std::memory_order_relaxed);
+				// Reparto inicial por turnos; el robo equilibra después
+				for (unsigned t = 0; t < num_tareas; t++) {
+					Cola &cola = *colas[t % colas.size()];
+					std::lock_guard<std::mutex> cerrojo(cola.mutex);
+					cola.tareas.push_back(t);
+				}
+				{
+					std::lock_guard<std::mutex> cerrojo(mutex_estado);
+					generacion++;
+				}
+				hay_trabajo.notify_all();
+				trabajar(0);
+				std::unique_lock<std::mutex> cerrojo(mutex_estado);
+				terminado.wait(cerrojo, [this] { return pendientes.load(std::memory_order_acquire) == 0; });
+				trabajo = nullptr;
+			}
+		}
+
+	private:
+		// Cola de tareas de un hilo: el dueño toma por el final y los
+		// demás roban por el principio
+		struct Cola {
+			std::mutex mutex;
+			std::deque <unsigned> tareas;
+		};
+
+		ReservaHilos(const ReservaHilos &);
+		ReservaHilos & operator=(const ReservaHilos &);
+
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		// Una cola por hilo; la 0 es la del hilo que llama a ejecutar()
+		std::vector <std::unique_ptr<Cola>> colas;
+		std::vector <std::thread> hilos;
+		std::mutex mutex_ejecutar, mutex_estado;
+		std::condition_variable hay_trabajo, terminado;
+		// Función de la llamada a ejecutar() en curso
+		const std::function<void(unsigned)> *trabajo;
+		// Tareas de la llamada en curso que aún no han terminado
+		std::atomic<unsigned> pendientes;
+		// Número de llamadas a ejecutar(), para despertar a los hilos
+		unsigned long long generacion;
+		bool fin;
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS
+		//
+		// Bucle de cada hilo: espera a que haya trabajo nuevo y lo ejecuta
+		void bucle_hilo(unsigned num_cola) {
+			unsigned long long vista = 0;
+			bool salir = false;
+			while (!salir) {
+				{
+					std::unique_lock<std::mutex> cerrojo(mutex_estado);
+					hay_trabajo.wait(cerrojo, [this, vista] { return fin || generacion != vista; });
+					salir = fin;
+					vista = generacion;
+				}
+				if (!salir) {
+					trabajar(num_cola);
+				}
+			}
+		}
+
+		// Ejecuta tareas de la cola propia y, cuando se vacía, de las de
+		// los demás, hasta que no queda ninguna
+		void trabajar(unsigned num_cola) {
+			unsigned tarea;
+			while (tomar_tarea(num_cola, tarea)) {
+				(*trabajo)(tarea);
+				if (pendientes.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					std::lock_guard<std::mutex> cerrojo(mutex_estado);
+					terminado.notify_all();
+				}
+			}
+		}
+
+		// Toma una tarea de la cola propia (la última) o roba una de otra
+		// cola (la primera). Devuelve false si todas están vacías.
+		bool tomar_tarea(unsigned num_cola, unsigned &tarea) {
+			bool encontrada = false;
+			for (std::size_t i = 0; i < colas.size() && !encontrada; i++) {
+				Cola &cola = *colas[(num_cola + i) % colas.size()];
+				std::lock_guard<std::mutex> cerrojo(cola.mutex);
+				if (!cola.tareas.empty()) {
+					if (i == 0) {
+						tarea = cola.tareas.back();
+						cola.tareas.pop_back();
+					}
+					else {
+						tarea = cola.tareas.front();
+						cola.tareas.pop_front();
+					}
+					encontrada = true;
+				}
+			}
+			return encontrada;
+		}
+	};
+}
+#endif
@@ -0,0 +1,94 @@
+/****************************************************************************
+* Clase TablaSimbolos
+*
+* Tabla de símbolos única para todo el proceso que asigna a cada nombre de
+* usuario (handle) un identificador entero denso: 0, 1, 2... en el orden
+* en que se registran. Así, las listas de usuarios guardan enteros de
+* 32 bits en lugar de una copia del nombre, y comparar dos usuarios es
+* comparar dos enteros.
+*
+* Los identificadores no se reutilizan ni se liberan mientras dura el
+* proceso.
+****************************************************************************/
+
+#ifndef __TABLA__SIMBOLOS__
+#define __TABLA__SIMBOLOS__
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <cstdint>
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Identificador de usuario
+	typedef std::uint32_t IdUsuario;
+	// Identificador que no corresponde a ningún usuario
+	const IdUsuario ID_NULO = 0xFFFFFFFF;
+
+	class TablaSimbolos {
+	public:
+		// Devuelve la tabla de símbolos del proceso
+		static TablaSimbolos & global() {
+			static TablaSimbolos tabla;
+			return tabla;
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+
+		// Devuelve el identificador de 'nombre', o ID_NULO si no está
+		// registrado
+		IdUsuario buscar(const std::string &nombre) const {
+			return buscar(nombre.data(), nombre.size());
+		}
+		IdUsuario buscar(const char *nombre, std::size_t longitud) const {
+			std::unordered_map<std::string_view, IdUsuario>::const_iterator it = ids.find(std::string_view(nombre, longitud));
+			return (it != ids.end()) ? it->second : ID_NULO;
+		}
+
+		// Devuelve el nombre del usuario con identificador 'id'
+		// PRECONDICIÓN: id < num_simbolos()
+		const std::string & nombre(IdUsuario id) const {
+			return nombres[id];
+		}
+
+		// Devuelve el número de nombres registrados
+		unsigned num_simbolos() const {
+			return unsigned(nombres.size());
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ACTUALIZACIÓN
+
+		// Devuelve el identificador de 'nombre', registrándolo si no
+		// existía
+		IdUsuario registrar(const std::string &nombre) {
+			IdUsuario id = buscar(nombre);
+			if (id == ID_NULO) {
+				id = IdUsuario(nombres.size());
+				nombres.push_back(nombre);
+				// La clave apunta al nombre guardado en 'nombres', que no cambia
+				// de dirección al añadir nombres nuevos
+				ids.emplace(std::string_view(nombres.back()), id);
+			}
+			return id;
+		}
+
+	private:
+		TablaSimbolos() : nombres(), ids() {}
+		TablaSimbolos(const TablaSimbolos &);
+		TablaSimbolos & operator=(const TablaSimbolos &);
+
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		// Nombres registrados, indexados por identificador
+		std::deque <std::string> nombres;
+		// Identificador de cada nombre registrado
+		std::unordered_map <std::string_view, IdUsuario> ids;
+	};
+}
+#endif
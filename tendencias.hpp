@@ -0,0 +1,325 @@
+/****************************************************************************
+* Clase Tendencias
+*
+* Cuenta en tiempo real las etiquetas (@usuario y #tema) de los tweets que
+* se insertan para saber cuáles son tendencia en los últimos minutos. La
+* memoria está acotada y no depende del número de etiquetas distintas.
+*
+* El tiempo se divide en cubetas de 'segundos_cubeta' segundos según la
+* fecha y hora de cada tweet, y se guardan las 'num_cubetas' más
+* recientes en un anillo (la cubeta de un tweet se reutiliza cuando llega
+* uno de una cubeta posterior). Cada cubeta tiene:
+*
+*  - Un sketch Count-Min: 'filas' filas de 'ancho' contadores; cada
+*    etiqueta suma uno en un contador de cada fila, elegido con una
+*    función hash distinta por fila. La estimación de una etiqueta es el
+*    mínimo de sus contadores: nunca es menor que el número real de
+*    apariciones y solo es mayor si otras etiquetas comparten todos sus
+*    contadores.
+*
+*  - Los 'candidatos' etiquetas con la estimación más alta en la cubeta
+*    (si llega una etiqueta nueva con la lista llena, sustituye a la de
+*    estimación más baja si la supera).
+*
+* Las apariciones de una etiqueta en una ventana de varias cubetas se
+* estiman sumando fila a fila los contadores de las cubetas y tomando el
+* mínimo. Las tendencias de la ventana son las etiquetas candidatas en
+* alguna de sus cubetas con más apariciones estimadas; una etiqueta
+* repartida por igual entre muchas cubetas sin destacar en ninguna puede
+* quedar fuera.
+*
+* Las menciones distinguen mayúsculas y minúsculas, como los nombres de
+* usuario; los temas no (#Ada y #ada son el mismo).
+****************************************************************************/
+
+#ifndef __TENDENCIAS__
+#define __TENDENCIAS__
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include "menciones.hpp"
+#include "usuario_twitter.hpp"
+
+namespace {
+	const unsigned SEGUNDOS_CUBETA_TENDENCIAS = 60; // Duración por defecto de cada cubeta
+	const unsigned NUM_CUBETAS_TENDENCIAS = 60; // Cubetas por defecto (ventana máxima de una hora)
+	const unsigned FILAS_SKETCH_TENDENCIAS = 4; // Funciones hash del sketch Count-Min
+	const unsigned ANCHO_SKETCH_TENDENCIAS = 1024; // Contadores por fila del sketch
+	const unsigned CANDIDATOS_TENDENCIAS = 32; // Etiquetas candidatas por cubeta
+}
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Etiqueta en tendencia ("@usuario" o "#tema") y sus apariciones
+	// estimadas en la ventana consultada
+	struct Tendencia {
+		std::string etiqueta;
+		unsigned long long apariciones;
+	};
+	// Tendencias, de más a menos apariciones
+	typedef std::vector <Tendencia> ListaTendencias;
+
+	//---------------------------------------------------------------------------
+	class Tendencias {
+	public:
+		// Constructor por defecto: ventana de NUM_CUBETAS_TENDENCIAS cubetas
+		// de SEGUNDOS_CUBETA_TENDENCIAS segundos
+		Tendencias() : Tendencias(SEGUNDOS_CUBETA_TENDENCIAS, NUM_CUBETAS_TENDENCIAS,
+			ANCHO_SKETCH_TENDENCIAS, CANDIDATOS_TENDENCIAS) {}
+
+		// Constructor: 'num_cubetas' cubetas de 'segundos_cubeta' segundos,
+		// con sketches de 'ancho' contadores por fila (se redondea a una
+		// potencia de 2) y 'candidatos' etiquetas candidatas por cubeta
+		// PRECONDICIÓN: segundos_cubeta > 0, num_cubetas > 0, ancho > 0,
+		//               candidatos > 0
+		Tendencias(unsigned segundos_cubeta, unsigned num_cubetas, unsigned ancho, unsigned candidatos)
+			: segundos(segundos_cubeta), ancho_sketch(1), max_candidatos(candidatos), cubetas(num_cubetas),
+			ultimo_periodo(0), hay_tweets(false), clave() {
+			while (ancho_sketch < ancho) {
+				ancho_sketch *= 2;
+			}
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+
+		// Devuelve la duración de una cubeta, en segundos
+		unsigned segundos_cubeta() const {
+			return segundos;
+		}
+
+		// Devuelve la ventana más larga que se puede consultar, en segundos
+		unsigned long long ventana_maxima() const {
+			return (unsigned long long)(segundos) * cubetas.size();
+		}
+
+		// Devuelve una estimación de la memoria ocupada, en bytes. No
+		// depende del número de etiquetas distintas: como mucho
+		// 'num_cubetas' sketches y 'candidatos' etiquetas por cubeta.
+		std::size_t memoria() const {
+			std::size_t bytes = cubetas.capacity() * sizeof(Cubeta);
+			for (std::size_t c = 0; c < cubetas.size(); c++) {
+				bytes += cubetas[c].contadores.capacity() * sizeof(std::uint32_t)
+					+ cubetas[c].candidatos.capacity() * sizeof(Candidata);
+				for (std::size_t i = 0; i < cubetas[c].candidatos.size(); i++) {
+					if (cubetas[c].candidatos[i].etiqueta.capacity() > sizeof(std::string)) {
+						bytes += cubetas[c].candidatos[i].etiqueta.capacity() + 1;
+					}
+				}
+			}
+			return bytes;
+		}
+
+		// Devuelve a través de 'lista' las (como mucho) 'k' etiquetas con
+		// más apariciones en los últimos 'segundos_ventana' segundos, hasta
+		// la cubeta del tweet más reciente (se redondea a cubetas enteras
+		// y como mucho a ventana_maxima()). A igualdad de apariciones, por
+		// orden alfabético.
+		void obtener_tendencias(unsigned k, unsigned long long segundos_ventana, ListaTendencias &lista) const {
+			lista.clear();
+			std::vector <const Cubeta *> ventana;
+			if (hay_tweets) {
+				unsigned long long num = std::min<unsigned long long>((segundos_ventana + segundos - 1) / segundos,
+					cubetas.size());
+				for (std::size_t c = 0; c < cubetas.size(); c++) {
+					if (!cubetas[c].contadores.empty() && cubetas[c].periodo <= ultimo_periodo &&
+						(unsigned long long)(ultimo_periodo - cubetas[c].periodo) < num) {
+						ventana.push_back(&cubetas[c]);
+					}
+				}
+			}
+			// Candidatas de todas las cubetas de la ventana, sin repetir
+			std::vector <const Candidata *> todas;
+			for (std::size_t c = 0; c < ventana.size(); c++) {
+				for (std::size_t i = 0; i < ventana[c]->candidatos.size(); i++) {
+					todas.push_back(&ventana[c]->candidatos[i]);
+				}
+			}
+			std::sort(todas.begin(), todas.end(), [](const Candidata *a, const Candidata *b) {
+				return a->hash < b->hash || (a->hash == b->hash && a->etiqueta < b->etiqueta);
+			});
+			for (std::size_t i = 0; i < todas.size(); i++) {
+				if (i == 0 || todas[i]->hash != todas[i - 1]->hash || todas[i]->etiqueta != todas[i - 1]->etiqueta) {
+					Tendencia tendencia;
+					tendencia.etiqueta = todas[i]->etiqueta;
+					tendencia.apariciones = estimar(ventana, todas[i]->hash);
+					lista.push_back(tendencia);
+				}
+			}
+			std::size_t num_lista = std::min<std::size_t>(k, lista.size());
+			std::partial_sort(lista.begin(), lista.begin() + std::ptrdiff_t(num_lista), lista.end(),
+				[](const Tendencia &a, const Tendencia &b) {
+				return a.apariciones > b.apariciones || (a.apariciones == b.apariciones && a.etiqueta < b.etiqueta);
+			});
+			lista.resize(num_lista);
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ACTUALIZACIÓN
+
+		// Cuenta las etiquetas de un tweet publicado en 'marca_tiempo'. Una
+		// etiqueta repetida en el mismo tweet cuenta cada vez. Los tweets
+		// más antiguos que la ventana máxima (respecto al más reciente) se
+		// descartan.
+		void anotar(MarcaTiempo marca_tiempo, std::string_view texto) {
+			std::int64_t periodo = marca_tiempo / std::int64_t(segundos);
+			if (marca_tiempo % std::int64_t(segundos) < 0) {
+				periodo--;
+			}
+			if (!hay_tweets || periodo > ultimo_periodo) {
+				ultimo_periodo = periodo;
+				hay_tweets = true;
+			}
+			if ((unsigned long long)(ultimo_periodo - periodo) < cubetas.size()) {
+				std::int64_t num_cubetas = std::int64_t(cubetas.size());
+				Cubeta &cubeta = cubetas[std::size_t(((periodo % num_cubetas) + num_cubetas) % num_cubetas)];
+				if (cubeta.contadores.empty() || cubeta.periodo != periodo) {
+					vaciar(cubeta, periodo);
+				}
+				recorrer_etiquetas(texto.data(), texto.size(), '@', [this, &cubeta](const char *nombre, std::size_t longitud) {
+					clave.assign(1, '@');
+					clave.append(nombre, longitud);
+					contar(cubeta);
+				});
+				recorrer_etiquetas(texto.data(), texto.size(), '#', [this, &cubeta](const char *tema, std::size_t longitud) {
+					clave.assign(1, '#');
+					for (std::size_t i = 0; i < longitud; i++) {
+						clave.push_back((tema[i] >= 'A' && tema[i] <= 'Z') ? char(tema[i] - 'A' + 'a') : tema[i]);
+					}
+					contar(cubeta);
+				});
+			}
+		}
+
+		// Olvida todas las etiquetas contadas y libera la memoria de las
+		// cubetas
+		void vaciar() {
+			for (std::size_t c = 0; c < cubetas.size(); c++) {
+				std::vector <std::uint32_t>().swap(cubetas[c].contadores);
+				std::vector <Candidata>().swap(cubetas[c].candidatos);
+			}
+			ultimo_periodo = 0;
+			hay_tweets = false;
+		}
+
+	private:
+		// Etiqueta candidata de una cubeta: su hash, su texto y su
+		// estimación en la cubeta
+		struct Candidata {
+			std::uint64_t hash;
+			std::string etiqueta;
+			std::uint32_t estimacion;
+		};
+		// Cubeta de tiempo: periodo (marca de tiempo / segundos) al que
+		// corresponde, sketch (fila a fila; vacío si la cubeta no se ha
+		// usado nunca) y candidatas
+		struct Cubeta {
+			Cubeta() : periodo(0), contadores(), candidatos() {}
+			std::int64_t periodo;
+			std::vector <std::uint32_t> contadores;
+			std::vector <Candidata> candidatos;
+		};
+
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		unsigned segundos;
+		unsigned ancho_sketch;
+		unsigned max_candidatos;
+		std::vector <Cubeta> cubetas;
+		// Periodo del tweet más reciente
+		std::int64_t ultimo_periodo;
+		bool hay_tweets;
+		// Etiqueta que se está contando (se reutiliza entre etiquetas)
+		std::string clave;
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS
+		//
+		// Hash de 64 bits de una etiqueta (FNV-1a con una mezcla final)
+		static std::uint64_t hash_etiqueta(const std::string &etiqueta) {
+			std::uint64_t h = 14695981039346656037ULL;
+			for (std::size_t i = 0; i < etiqueta.size(); i++) {
+				h = (h ^ static_cast<unsigned char>(etiqueta[i])) * 1099511628211ULL;
+			}
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdULL;
+			h ^= h >> 33;
+			return h;
+		}
+
+		// Posición en 'contadores' del contador de la fila 'fila' que
+		// corresponde a 'hash': las funciones de cada fila se obtienen
+		// combinando las dos mitades del hash
+		std::size_t posicion(std::uint64_t hash, unsigned fila) const {
+			std::uint32_t h1 = std::uint32_t(hash), h2 = std::uint32_t(hash >> 32) | 1;
+			return std::size_t(fila) * ancho_sketch + ((h1 + fila * h2) & (ancho_sketch - 1));
+		}
+
+		// Deja 'cubeta' vacía para el periodo 'periodo'
+		void vaciar(Cubeta &cubeta, std::int64_t periodo) {
+			cubeta.periodo = periodo;
+			cubeta.contadores.assign(std::size_t(FILAS_SKETCH_TENDENCIAS) * ancho_sketch, 0);
+			cubeta.candidatos.clear();
+		}
+
+		// Suma una aparición de 'clave' en 'cubeta' y actualiza sus
+		// candidatas
+		void contar(Cubeta &cubeta) {
+			std::uint64_t hash = hash_etiqueta(clave);
+			std::uint32_t estimacion = UINT32_MAX;
+			for (unsigned fila = 0; fila < FILAS_SKETCH_TENDENCIAS; fila++) {
+				std::uint32_t &contador = cubeta.contadores[posicion(hash, fila)];
+				contador++;
+				estimacion = std::min(estimacion, contador);
+			}
+			// Se busca la etiqueta y, a la vez, la candidata más baja
+			std::vector <Candidata> &candidatos = cubeta.candidatos;
+			std::size_t encontrada = candidatos.size(), minima = 0;
+			for (std::size_t i = 0; i < candidatos.size() && encontrada == candidatos.size(); i++) {
+				if (candidatos[i].hash == hash && candidatos[i].etiqueta == clave) {
+					encontrada = i;
+				}
+				else if (candidatos[i].estimacion < candidatos[minima].estimacion) {
+					minima = i;
+				}
+			}
+			if (encontrada < candidatos.size()) {
+				candidatos[encontrada].estimacion = estimacion;
+			}
+			else if (candidatos.size() < max_candidatos) {
+				Candidata nueva;
+				nueva.hash = hash;
+				nueva.etiqueta = clave;
+				nueva.estimacion = estimacion;
+				candidatos.push_back(nueva);
+			}
+			else if (estimacion > candidatos[minima].estimacion) {
+				candidatos[minima].hash = hash;
+				candidatos[minima].etiqueta = clave;
+				candidatos[minima].estimacion = estimacion;
+			}
+		}
+
+		// Estimación de las apariciones de la etiqueta de hash 'hash' en
+		// las cubetas de 'ventana'
+		unsigned long long estimar(const std::vector<const Cubeta *> &ventana, std::uint64_t hash) const {
+			unsigned long long estimacion = 0;
+			for (unsigned fila = 0; fila < FILAS_SKETCH_TENDENCIAS; fila++) {
+				std::size_t pos = posicion(hash, fila);
+				unsigned long long suma = 0;
+				for (std::size_t c = 0; c < ventana.size(); c++) {
+					suma += ventana[c]->contadores[pos];
+				}
+				estimacion = (fila == 0) ? suma : std::min(estimacion, suma);
+			}
+			return estimacion;
+		}
+	};
+}
+#endif
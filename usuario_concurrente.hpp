@@ -0,0 +1,136 @@
+/****************************************************************************
+* Clase UsuarioConcurrente
+*
+* UsuarioTwitter que se puede leer desde muchos hilos a la vez mientras un
+* único hilo escritor lo modifica. Los lectores no usan cerrojos: leer()
+* devuelve la versión publicada en ese momento, que no cambia mientras se
+* lee (aislamiento por instantánea).
+*
+* El escritor nunca modifica la versión publicada: copia la versión
+* actual (gracias a la copia en escritura de UsuarioTwitter solo se copian
+* los punteros a los bloques de tweets y, al insertar, el último bloque),
+* aplica los cambios sobre la copia y la publica con una escritura
+* atómica con semántica release. La versión anterior se libera a través
+* del gestor de épocas (ver GestorEpocas) cuando ya no la lee nadie.
+* modificar() permite aplicar varios cambios y publicarlos de una vez.
+*
+* Los métodos de UsuarioTwitter que reciben o muestran nombres de usuario
+* consultan la tabla de símbolos global, que no admite lecturas mientras
+* otro hilo registra nombres nuevos: desde los lectores concurrentes se
+* deben usar los métodos que reciben un IdUsuario y las vistas.
+****************************************************************************/
+
+#ifndef __USUARIO__CONCURRENTE__
+#define __USUARIO__CONCURRENTE__
+#include <atomic>
+#include "epocas.hpp"
+#include "usuario_twitter.hpp"
+
+namespace bblProgII {
+	class UsuarioConcurrente {
+	public:
+		// Lectura de una versión del usuario. Mientras existe, la versión
+		// no se modifica ni se libera (ni las vistas obtenidas de ella
+		// dejan de ser válidas). No debe pasarse a otro hilo.
+		class Lectura {
+		public:
+			explicit Lectura(const std::atomic<const UsuarioTwitter *> &publicada) : lectura(),
+				version(publicada.load(std::memory_order_acquire)) {}
+
+			const UsuarioTwitter & operator*() const {
+				return *version;
+			}
+			const UsuarioTwitter * operator->() const {
+				return version;
+			}
+
+		private:
+			LecturaEpoca lectura;
+			const UsuarioTwitter *version;
+		};
+
+		// Constructor: publica una copia de 'inicial'
+		explicit UsuarioConcurrente(const UsuarioTwitter &inicial) :
+			publicada(new UsuarioTwitter(inicial)) {}
+
+		// Destructor: espera a que terminen las lecturas en curso
+		// PRECONDICIÓN: ningún hilo va a empezar a leer este usuario
+		~UsuarioConcurrente() {
+			GestorEpocas::global().sincronizar();
+			delete publicada.load(std::memory_order_relaxed);
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA (cualquier hilo)
+
+		// Devuelve la versión publicada actualmente
+		Lectura leer() const {
+			return Lectura(publicada);
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ACTUALIZACIÓN (solo el hilo escritor)
+		//
+		// Hacen lo mismo que los de UsuarioTwitter y publican la versión
+		// resultante.
+
+		void nuevo_tweet(const Tweet &nuevo, Resultado &res) {
+			modificar([&nuevo, &res](UsuarioTwitter &usuario) {
+				usuario.nuevo_tweet(nuevo, res);
+			});
+		}
+
+		void nuevo_seguidor(IdUsuario nuevo, Resultado &res) {
+			modificar([nuevo, &res](UsuarioTwitter &usuario) {
+				usuario.nuevo_seguidor(nuevo, res);
+			});
+		}
+
+		void nuevo_siguiendo(IdUsuario nuevo, Resultado &res) {
+			modificar([nuevo, &res](UsuarioTwitter &usuario) {
+				usuario.nuevo_siguiendo(nuevo, res);
+			});
+		}
+
+		void eliminar_seguidor(IdUsuario usuario_eliminado, Resultado &res) {
+			modificar([usuario_eliminado, &res](UsuarioTwitter &usuario) {
+				usuario.eliminar_seguidor(usuario_eliminado, res);
+			});
+		}
+
+		void eliminar_siguiendo(IdUsuario usuario_eliminado, Resultado &res) {
+			modificar([usuario_eliminado, &res](UsuarioTwitter &usuario) {
+				usuario.eliminar_siguiendo(usuario_eliminado, res);
+			});
+		}
+
+		void nueva_mencion(IdUsuario autor, unsigned num_tweet, Resultado &res) {
+			modificar([autor, num_tweet, &res](UsuarioTwitter &usuario) {
+				usuario.nueva_mencion(autor, num_tweet, res);
+			});
+		}
+
+		// Llama a 'funcion(usuario)' sobre una copia de la versión actual
+		// y publica el resultado: los lectores ven todos los cambios de
+		// 'funcion' o ninguno.
+		template <typename Funcion>
+		void modificar(Funcion funcion) {
+			const UsuarioTwitter *anterior = publicada.load(std::memory_order_relaxed);
+			UsuarioTwitter *nueva = new UsuarioTwitter(*anterior);
+			funcion(*nueva);
+			publicada.store(nueva, std::memory_order_release);
+			GestorEpocas::global().retirar(anterior);
+		}
+
+	private:
+		UsuarioConcurrente(const UsuarioConcurrente &);
+		UsuarioConcurrente & operator=(const UsuarioConcurrente &);
+
+		//------------------------------------------------------------------
+		// ATRIBUTOS
+		//
+		// Versión que ven los lectores
+		std::atomic<const UsuarioTwitter *> publicada;
+	};
+}
+#endif
@@ -1,685 +1,1922 @@
-/****************************************************************************
-* Clase UsuarioTwitter
-*
-* Esta clase implementa toda la operativa relativa a un usuario de la red
-* social 'Twitter', permitiendo la gestin de la lista de tweets,
-* usuarios seguidos (following) y usuarios seguidores (followers).
-*
-* Autor: Jose Antonio Ziga Garca
-* Fecha: Fri Mar 10 12:14:11 2017
-****************************************************************************/
-
-#ifndef __USUARIO__TWITTER__
-#define __USUARIO__TWITTER__
-#include <string>
-#include <array>
-#include <fstream>
-
-namespace {
-	const unsigned MAX_USUARIOS = 100; // Mximo nmero de seguidores o siguiendo
-	const unsigned MAX_TWEETS = 10000; // Mximo nmero de tweets del usuario
-}
-
-
-namespace bblProgII {
-	//---------------------------------------------------------------------------
-	// TIPOS PBLICOS
-	//
-	// Lista de usuarios
-	typedef std::array <std::string, MAX_USUARIOS> ListaUsuarios;
-	struct Usuarios {
-		unsigned num_usuarios;
-		ListaUsuarios listado;
-	};
-	//---------------------------------------------------------------------------
-	// Lista de tweets
-	struct FechaHora {
-		unsigned anyo, mes, dia, hora, minuto, segundo;
-	};
-	struct Tweet {
-		std::string tweet;
-		FechaHora fecha_hora;
-	};
-	typedef std::array <Tweet, MAX_TWEETS> ListaTweets;
-	struct Tweets {
-		unsigned num_tweets;
-		ListaTweets listado;
-	};
-	//---------------------------------------------------------------------------
-	// Resulstado de las operaciones:
-	//  - OK: la operacin se ha realizado con xito
-	//  - LISTA_LLENA: la operacin no ha sido posible: lista llena
-	//  - YA_EXISTE: la operacin no ha sido posible: el elemento ya existe
-	//  - NO_EXISTE: el elemento no existe
-	//  - FIC_ERROR: error en el fichero
-	typedef unsigned Resultado;
-	const Resultado OK = 0,
-		LISTA_LLENA = 1,
-		YA_EXISTE = 2,
-		NO_EXISTE = 3,
-		FIC_ERROR = 4;
-
-	/* O, alternativamente,
-	enum Resultado {
-	OK,
-	LISTA_LLENA,
-	YA_EXISTE,
-	NO_EXISTE,
-	FIC_ERROR
-	};
-	*/
-
-
-	class UsuarioTwitter {
-	public:
-		// Constructor por defecto
-		// Inicializar todos los datos vacos.
-		UsuarioTwitter() : id_usuario(""), tweets(), siguiendo(), seguidores() {
-			tweets.num_tweets = 0;
-			siguiendo.num_usuarios = 0;
-			seguidores.num_usuarios = 0;
-		}
-
-		// Constructor extendido.
-		// Inicializa el idenfificador de usuario con el 'id' que se pasa
-		// como parmetro. Las listas de usuarios y tweets estn
-		// vacas.
-		UsuarioTwitter(const std::string &id) {
-			id_usuario = id;
-			tweets.num_tweets = 0;
-			siguiendo.num_usuarios = 0;
-			seguidores.num_usuarios = 0;
-		}
-
-		// Constructor de copia
-		UsuarioTwitter(const UsuarioTwitter &otro_usuario) {
-			id_usuario = otro_usuario.id_usuario;
-			tweets.num_tweets = otro_usuario.tweets.num_tweets;
-			siguiendo.num_usuarios = otro_usuario.siguiendo.num_usuarios;
-			seguidores.num_usuarios = otro_usuario.seguidores.num_usuarios;
-		}
-
-		// Operador de asignacin (OPCIONAL!!!)
-		UsuarioTwitter & operator=(const UsuarioTwitter &otro_usuario) {
-			
-			if (this != &otro_usuario) {
-				
-				id_usuario = otro_usuario.id_usuario;
-
-				tweets.num_tweets = otro_usuario.tweets.num_tweets;
-				for (unsigned i = 0; i < tweets.num_tweets; i++) {
-					tweets.listado[i] = otro_usuario.tweets.listado[i];
-				}
-
-				siguiendo.num_usuarios = otro_usuario.siguiendo.num_usuarios;
-				for (unsigned i = 0; i < siguiendo.num_usuarios; i++) {
-					siguiendo.listado[i] = otro_usuario.siguiendo.listado[i];
-				}
-
-				seguidores.num_usuarios = otro_usuario.seguidores.num_usuarios;
-				for (unsigned i = 0; i < seguidores.num_usuarios; i++) {
-					seguidores.listado[i] = otro_usuario.seguidores.listado[i];
-				}
-			}
-		}
-
-		// Destructor de la clase
-		~UsuarioTwitter() {};
-
-		//------------------------------------------------------------------
-		// MTODOS DE CONSULTA
-
-		// Devuelve el idenficador del usuario
-		std::string obtener_id() const {
-			return id_usuario;
-		}
-
-		// Devuelve la lista de seguidores
-		void obtener_seguidores(Usuarios &lista_seg) const {
-			lista_seg = seguidores;
-		}
-
-		// Devuelve la lista de usuarios a los que se sigue
-		void obtener_siguiendo(Usuarios &lista_sig) const {
-			lista_sig = siguiendo;
-		}
-
-		// Devuelve la lista de tweets del usuario
-		void obtener_tweets(Tweets &lista_tweets) const {
-			lista_tweets = tweets;
-		}
-
-		// Indica si un determinado usuario es seguidor de este usuario
-		bool me_sigue(const std::string &otro_usuario) const {
-			bool mismo_usuario;
-			// Primero busco la posicin donde debera estar
-			unsigned pos = buscar_usuario(seguidores, otro_usuario);
-			// Si es el mismo usuario devuelve true, si no, false
-			if (seguidores.listado[pos] == otro_usuario) {
-				mismo_usuario = true;
-			}
-			else {
-				mismo_usuario = false;
-			}
-			return mismo_usuario;
-		}
-
-		// Indica si este usuario est siguiendo a otro
-		bool estoy_siguiendo(const std::string &otro_usuario) const {
-			bool mismo_usuario;
-			// Primero busco la posicin donde debera estar
-			unsigned pos = buscar_usuario(siguiendo, otro_usuario);
-			// Si es el mismo usuario devuelve true, si no, false
-			if (siguiendo.listado[pos] == otro_usuario) {
-				mismo_usuario = true;
-			}
-			else {
-				mismo_usuario = false;
-			}
-			return mismo_usuario;
-		}
-
-		// Devuelve el nmero de seguidores
-		unsigned num_seguidores() const {
-			return seguidores.num_usuarios;
-		}
-
-		// Devuelve el nmero de usuarios a los que se sigue
-		unsigned num_siguiendo() const {
-			return siguiendo.num_usuarios;
-		}
-
-		// Devuelve el nmero de tweets del usuario
-		unsigned num_tweets() const {
-			return tweets.num_tweets;
-		}
-
-		// Imprime por pantalla la lista de seguidores
-		// Si num_imprime == 0, imprime todos los seguidores. Si no,
-		// se imprime el nmero de seguidores que se indica.
-		// PRECONDICIN: num_imprime <= num_seguidores
-		void imprimir_seguidores(unsigned num_imprime) const {
-			// PRECONDICIN: num_imprime <= num_seguidores
-			bool ok = (num_imprime <= seguidores.num_usuarios) ? true : false;
-			// Si num_imprime == 0, imprime todos los seguidores
-			if (ok && (num_imprime == 0)) {
-				for (unsigned i = 0; i < seguidores.num_usuarios; i++) {
-					std::cout << i << ": " << seguidores.listado[i] << std::endl;
-				}
-			}
-			// Si num_imprime != 0, imprime "num_imprime" seguidores
-			else if (ok && (num_imprime != 0)) {
-				for (unsigned i = 0; i < num_imprime; i++) {
-					std::cout << i << ": " << seguidores.listado[i] << std::endl;
-				}
-			}
-			// Si no cumple la condicin deuvelve error por pantalla
-			else {
-				std::cerr << "Error: El nmero de seguidores es menor que " << num_imprime << std::endl;
-			}
-		}
-
-		// Imprime por pantalla la lista de usuarios a los que sigue
-		// Si num_imprime == 0, imprime todos los usuarios a los que sigue.
-		// Si no, imprime el nmero de usuarios que se indica.
-		// PRECONDICIN: num_imprime <= num_siguiendo
-		void imprimir_siguiendo(unsigned num_imprime) const {
-			// PRECONDICIN: num_imprime <= num_siguiendo
-			bool ok = (num_imprime <= siguiendo.num_usuarios) ? true : false;
-			// Si num_imprime == 0, imprime todos los seguidos
-			if (ok && (num_imprime == 0)) {
-				for (unsigned i = 0; i < siguiendo.num_usuarios; i++) {
-					std::cout << i << ": " << siguiendo.listado[i] << std::endl;
-				}
-			}
-			// Si num_imprime != 0, imprime "num_imprime" seguidores
-			else if (ok && (num_imprime != 0)) {
-				for (unsigned i = 0; i < num_imprime; i++) {
-					std::cout << i << ": " << siguiendo.listado[i] << std::endl;
-				}
-			}
-			// Si no cumple la condicin deuvelve error por pantalla
-			else {
-				std::cerr << "Error: El nmero de usuarios seguidos es menor que " << num_imprime << std::endl;
-			}
-		}
-
-		// Imprime por pantalla la lista de tweets
-		// Si num_imprime == 0, imprime todos los tweets del usuario.
-		// Si no, imprime el nmero de tweets que se indica.
-		// PRECONDICIN: num_imprime <= num_tweets
-		void imprimir_tweets(unsigned num_imprime) const {
-			// PRECONDICIN: num_imprime <= num_tweets
-			bool ok = (num_imprime <= tweets.num_tweets) ? true : false;
-			// Si num_imprime == 0, imprime todos los tweets del usuario.
-			if (ok && (num_imprime == 0)) {
-				for (unsigned i = 0; i < tweets.num_tweets; i++) {
-					std::cout <<
-						tweets.listado[i].fecha_hora.dia << " " <<
-						tweets.listado[i].fecha_hora.mes << " " <<
-						tweets.listado[i].fecha_hora.anyo << " " <<
-						tweets.listado[i].fecha_hora.hora << " " <<
-						tweets.listado[i].fecha_hora.minuto << " " <<
-						tweets.listado[i].fecha_hora.segundo << " " <<
-						tweets.listado[i].tweet << std::endl;
-				}
-			}
-			// Si no, imprime el nmero de tweets que se indica.
-			else if (ok && (num_imprime > 0)) {
-				for (unsigned i = (tweets.num_tweets) - num_imprime; i < tweets.num_tweets; i++) {
-					std::cout <<
-						tweets.listado[i].fecha_hora.dia << " " <<
-						tweets.listado[i].fecha_hora.mes << " " <<
-						tweets.listado[i].fecha_hora.anyo << " " <<
-						tweets.listado[i].fecha_hora.hora << " " <<
-						tweets.listado[i].fecha_hora.minuto << " " <<
-						tweets.listado[i].fecha_hora.segundo << " " <<
-						tweets.listado[i].tweet << std::endl;
-				}
-			}
-			// Si no cumple la condicin deuvelve error por pantalla
-			else {
-				std::cerr << "Error: El nmero de tweets es menor que " << num_imprime << std::endl;
-			}
-
-		}
-
-		// Guarda en fichero la lista de seguidores
-		void guardar_seguidores(const std::string &nom_fic, Resultado &res) const {
-			// Variables
-			std::ofstream fichero;
-			// Abrimos
-			fichero.open(nom_fic.c_str());
-			// Comprobacin
-			if (!fichero.fail()) {
-				unsigned n = 0;
-				while (!fichero.fail() && n < seguidores.num_usuarios)
-				{
-					fichero << seguidores.listado[n] << std::endl;
-					n++;
-				}
-			}
-			res = (!fichero.fail()) ? OK : FIC_ERROR;
-			// Cerrar
-			fichero.close();
-		}
-
-		// Guarda en fichero la lista de usuarios a los que sigue
-		void guardar_seguiendo(const std::string &nom_fic, Resultado &res) const {
-			// Variables
-			std::ofstream fichero;
-			// Abrimos
-			fichero.open(nom_fic.c_str());
-			// Comprobacin
-			if (!fichero.fail()) {
-				unsigned n = 0;
-				while (!fichero.fail() && n < siguiendo.num_usuarios)
-				{
-					fichero << siguiendo.listado[n] << std::endl;
-					n++;
-				}
-			} 
-			res = (!fichero.fail()) ? OK : FIC_ERROR;
-			// Cerrar
-			fichero.close();
-		}
-
-		// Guarda en fichero los tweets del usuario
-		void guardar_tweets(const std::string &nom_fic, Resultado &res) const {
-			// Variables
-			std::ofstream fichero;
-			// Abrimos
-			fichero.open(nom_fic.c_str());
-			// Comprobacin
-			if (!fichero.fail()) {
-				unsigned n = 0;
-				while (!fichero.fail() && n < tweets.num_tweets)
-				{
-					fichero <<
-						tweets.listado[n].fecha_hora.dia << " " <<
-						tweets.listado[n].fecha_hora.mes << " " <<
-						tweets.listado[n].fecha_hora.anyo << " " <<
-						tweets.listado[n].fecha_hora.hora << " " <<
-						tweets.listado[n].fecha_hora.minuto << " " <<
-						tweets.listado[n].fecha_hora.segundo << " " <<
-						tweets.listado[n].tweet << std::endl;
-					n++;
-				}
-			}
-			res = (!fichero.fail()) ? OK : FIC_ERROR;
-			// Cerrar
-			fichero.close();
-		}
-
-		// Guarda en fichero las listas de usuarios  y tweets
-		void guardar_todo(const std::string &nom_fic_seguidores,
-			const std::string &nom_fic_siguiendo,
-			const std::string &nom_fic_tweets,
-			Resultado &res_seguidores,
-			Resultado &res_siguiendo,
-			Resultado &res_tweets) const
-		{
-			// Usamos las funciones de guardado de cada uno
-			guardar_seguidores(nom_fic_seguidores, res_seguidores);
-			guardar_seguiendo(nom_fic_siguiendo, res_siguiendo);
-			guardar_tweets(nom_fic_tweets, res_tweets);
-		}
-
-		//------------------------------------------------------------------
-		// MTODOS DE ACTUALIZACIN
-
-		// Modifica el identificador del usuario
-		void establecer_id(const std::string &nuevo_id) {
-			id_usuario = nuevo_id;
-		}
-
-		// Inserta un seguidor en la lista de seguidores.
-		// Si el nuevo seguidor no existe, se inserta de manera ordenada
-		// (orden lexicogrfico creciente) y se devuelve 'OK' a travs de
-		// 'res'. Si ya existe el seguidor, no se inserta y se devuelve
-		// 'YA_EXISTE' a travs de 'res'. Si no, si la lista de seguidores est
-		// llena, se devuelve 'LISTA_LLENA' a travs de 'res'.
-		void nuevo_seguidor(const std::string &nuevo, Resultado &res) {
-			// Posicin en la que debera de estar "nuevo"
-			unsigned pos = buscar_usuario(seguidores, nuevo);
-			// Comprobacin de que no existe
-			bool existe = (seguidores.listado[pos] == nuevo) ? true : false;
-			// Comprobacin de lista llena
-			bool llena = (seguidores.num_usuarios == MAX_USUARIOS) ? true : false;
-			// Asignacin de valor a res
-			if (existe) {
-				res = YA_EXISTE;
-			}
-			else if (llena) {
-				res = LISTA_LLENA;
-			}
-			else {
-				insertar_usuario_pos(seguidores, pos, nuevo);
-				res = OK;
-			}
-		}
-
-		// Inserta un usuario en la lista de usuarios a los que sigue.
-		// Si el nuevo usuario no existe, se inserta de manera ordenada
-		// (orden lexicogrfico creciente) y se devuelve 'OK' a travs de
-		// 'res'. Si ya existe el usuario, no se inserta y se devuelve
-		// 'YA_EXISTE' a travs de 'res'. Si no, si la lista de seguidores est
-		// llena, se devuelve 'LISTA_LLENA' a travs de 'res'.
-		void nuevo_siguiendo(const std::string &nuevo, Resultado &res) {
-			// Posicin en la que debera de estar "nuevo"
-			unsigned pos = buscar_usuario(siguiendo, nuevo);
-			// Comprobacin de que no existe
-			bool existe = (siguiendo.listado[pos] == nuevo) ? true : false;
-			// Comprobacin de lista llena
-			bool llena = (siguiendo.num_usuarios == MAX_USUARIOS) ? true : false;
-			// Asignacin de valor a res
-			if (existe) {
-				res = YA_EXISTE;
-			}
-			else if (llena) {
-				res = LISTA_LLENA;
-			}
-			else {
-				insertar_usuario_pos(siguiendo, pos, nuevo);
-				res = OK;
-			}
-		}
-
-		// Inserta un nuevo tweet al final de la lista de tweets. Si la lista de
-		// tweets est llena, se devuelve 'LISTA_LLENA' a travs de 'res'. Si no,
-		// se devuelve 'OK'. La longitud mxima del tweet es 140 caracteres, por
-		// lo que si el texto del tweet tiene ms de 140 caracteres, los
-		// caracteres sobrantes por el final se eliminarn.
-		void nuevo_tweet(const Tweet &nuevo, Resultado &res) {
-			// Constante, mxima longitud de tweet
-			const unsigned MAX_LONG_TWEET = 140;
-			// Comprobacin de lista llena
-			bool llena = (tweets.num_tweets == MAX_TWEETS) ? true : false;
-			// Asignacin de valor a res
-			res = (llena) ? LISTA_LLENA : OK;
-			// Si todo va bien, inserta nuevo tweet (140 caracteres)
-			if (res == OK) {
-				Tweet formateado = nuevo;
-				tweets.num_tweets++;
-				if (formateado.tweet.length() > MAX_LONG_TWEET) {
-					formateado.tweet.resize(MAX_LONG_TWEET);
-				}
-				tweets.listado[tweets.num_tweets - 1] = formateado;
-			}
-		}
-
-		// Elimina a un usuario de la lista de seguidores
-		// Si el usuario existe, se elimina y se devuelve 'OK' a travs de
-		// 'res'. Si no existe el usuario, se devuelve 'NO_EXISTE' a travs
-		// de 'res'.
-		void eliminar_seguidor(const std::string &usuario, Resultado &res) {
-			unsigned pos;
-			// Posicion donde debera de estar el usuario
-			pos = buscar_usuario(seguidores, usuario);
-			res = (seguidores.listado[pos] == usuario) ? OK : NO_EXISTE;
-			// Si el usuario existe eliminarlo y reordenar
-			if (res == OK) {
-				for (unsigned i = pos; i < seguidores.num_usuarios - 1; i++) {
-					seguidores.listado[i] = seguidores.listado[i + 1];
-				}
-				seguidores.num_usuarios--;
-			}
-		}
-
-		// Elimina a un usuario de la lista de usuarios a los que sigue
-		// Si el usuario existe, se elimina y se devuelve 'OK' a travs de
-		// 'res'. Si no existe el usuario, se devuelve 'NO_EXISTE' a travs
-		// de 'res'.
-		void eliminar_siguiendo(const std::string &usuario, Resultado &res) {
-			unsigned pos;
-			// Posicion donde debera de estar el usuario
-			pos = buscar_usuario(siguiendo, usuario);
-			res = (siguiendo.listado[pos] == usuario) ? OK : NO_EXISTE;
-			// Si el usuario existe eliminarlo y reordenar
-			if (res == OK) {
-				for (unsigned i = pos; i < siguiendo.num_usuarios - 1; i++) {
-					siguiendo.listado[i] = siguiendo.listado[i + 1];
-				}
-				siguiendo.num_usuarios--;
-			}
-		}
-
-		// Carga desde fichero la lista de seguidores,
-		// eliminando los seguidores actuales. Si el fichero se ha ledo
-		// correctamente y los usuarios caben en la lista, se devuelve
-		// 'OK' a travs de 'res'. En caso contrario, se devuelve
-		// 'FIC_ERROR' o 'LISTA_LLENA', respectivamente (aunque se insertan
-		// solo los usuarios que caben en la lista).
-		void cargar_seguidores(const std::string &nom_fic, Resultado &res) {
-			// Variables
-			std::ifstream fichero;
-			// Abrir fichero
-			fichero.open(nom_fic.c_str());
-			// Si no falla, leer los usuarios
-			if (!fichero.fail()) {
-				unsigned n = 0;
-				while (!fichero.fail() && n < MAX_USUARIOS) {
-					getline(fichero, seguidores.listado[n]);
-					seguidores.num_usuarios = n;
-					n++;
-				}
-			}
-			// Si el fichero ha llegado al fina, todo correcto
-			res = (fichero.eof()) ? OK : FIC_ERROR;
-			// Cerramos
-			fichero.close();
-		}
-
-		// Carga desde fichero la lista de usuarios a los que se sigue,
-		// eliminando los usuarios seguidos actuales. Si el fichero se ha ledo
-		// correctamente y los usuarios caben en la lista, se devuelve
-		// 'OK' a travs de 'res'. En caso contrario, se devuelve
-		// 'FIC_ERROR' o 'LISTA_LLENA', respectivamente (aunque se insertan
-		// solo los usuarios que caben en la lista).
-		void cargar_seguiendo(const std::string &nom_fic, Resultado &res) {
-			// Variables
-			std::ifstream fichero;
-			// Abrir fichero
-			fichero.open(nom_fic.c_str());
-			// Si no falla, leer los usuarios
-			if (!fichero.fail()) {
-				unsigned n = 0;
-				while (!fichero.fail() && n < MAX_USUARIOS) {
-					getline(fichero, siguiendo.listado[n]);
-					siguiendo.num_usuarios = n;
-					n++;
-				}
-			}
-			// Si el fichero ha llegado al fina, todo correcto
-			res = (fichero.eof()) ? OK : FIC_ERROR;
-			// Cerramos
-			fichero.close();
-		}
-
-		// Carga desde fichero la lista de tweets del usuario,
-		// eliminando los tweets actuales. Si el fichero se ha ledo
-		// correctamente y los tweets caben en la lista, se devuelve
-		// 'OK' a travs de 'res'. En caso contrario, se devuelve
-		// 'FIC_ERROR' o 'LISTA_LLENA', respectivamente (aunque se insertan
-		// solo los tweets que caben en la lista).
-		void cargar_tweets(const std::string &nom_fic, Resultado &res) {
-			// Variables
-			std::ifstream fichero;
-			// Abrir fichero
-			fichero.open(nom_fic.c_str());
-			// Si no falla, leer los usuarios
-			if (!fichero.fail()) {
-				unsigned n = 0;
-				while (!fichero.fail() && n < MAX_USUARIOS) {
-					fichero >> std::ws;
-					fichero >>
-						tweets.listado[n].fecha_hora.dia >>
-						tweets.listado[n].fecha_hora.mes >>
-						tweets.listado[n].fecha_hora.anyo >>
-						tweets.listado[n].fecha_hora.hora >>
-						tweets.listado[n].fecha_hora.minuto >>
-						tweets.listado[n].fecha_hora.segundo;
-					getline(fichero, tweets.listado[n].tweet);
-					tweets.num_tweets = n;
-					n++;
-				}
-			}
-			// Si el fichero ha llegado al fina, todo correcto
-			res = (fichero.eof()) ? OK : FIC_ERROR;
-			// Cerramos
-			fichero.close();
-		}
-
-		// Carga desde fichero las listas de usuarios y tweets. Si cada fichero se ha ledo
-		// correctamente y los usuarios/tweets caben en la lista correspondiente, se devuelve
-		// 'OK' a travs del parmetro 'res_*' correspondiente. En caso contrario, se devuelve
-		// 'FIC_ERROR' o 'LISTA_LLENA', respectivamente (aunque se insertan
-		// solo los usuarios/tweets que caben en la lista correspondiente).
-		void cargar_todo(const std::string &nom_fic_seguidores,
-			const std::string &nom_fic_siguiendo,
-			const std::string &nom_fic_tweets,
-			Resultado & res_seguidores,
-			Resultado & res_siguiendo,
-			Resultado & res_tweets)
-		{
-			cargar_seguidores(nom_fic_seguidores, res_seguidores);
-			cargar_seguiendo(nom_fic_siguiendo, res_siguiendo);
-			cargar_tweets(nom_fic_tweets, res_tweets);
-		}
-
-	private:
-		//------------------------------------------------------------------
-		// ATRIBUTOS: A DEFINIR POR EL ALUMNO
-		//
-		// Identificador del usuario
-		// ... id_usuario;
-		std::string id_usuario;
-		// Lista de tweets
-		// ... tweets;
-		Tweets tweets;
-		// Lista de usuarios a los que se estoy siguiendo
-		// ... siguiendo;
-		Usuarios siguiendo;
-		// Lista de usuarios que me siguen
-		// ... seguidores;
-		Usuarios seguidores;
-		//------------------------------------------------------------------
-
-		//------------------------------------------------------------------
-		// MTODOS PRIVADOS:
-		//
-		// Busca a un usuario en la lista ordenada de usuarios. Si lo
-		// encuentra, devuelve la posicin de la lista donde est. Si no,
-		// devuelve la posicin donde debera estar segn el orden de la
-		// lista.
-		unsigned buscar_usuario(const Usuarios &usuarios, const std::string &user) const {
-			// Variables
-			unsigned pos = 0;
-			unsigned numcaracter = 0;
-			bool fin = false;
-			// Bucle hasta encontrar la posicin
-			while (fin == false && pos <= usuarios.num_usuarios) {
-				// Si estamos en la ultima posicin finaliza bucle
-				if (pos == usuarios.num_usuarios) {
-					fin = true;
-				}
-				// Si la 'numcaracter' letra del usuario es menor, sigue iterando
-				if ((fin == false) && (usuarios.listado[pos][numcaracter] < user[numcaracter])) {
-					pos++;
-					numcaracter = 0;
-				}
-				// Si la 'numcaracter' letra del usuario es mayor, posicin encontrada
-				else if ((fin == false) && (usuarios.listado[pos][numcaracter] > user[numcaracter])) {
-					fin = true;
-				}
-				else if ((fin == false) && (usuarios.listado[pos][numcaracter] == user[numcaracter])) {
-					if ((numcaracter < usuarios.listado[pos].length() - 1) && (numcaracter < user.length() - 1)) {
-						numcaracter++;
-					} 
-					else if ((numcaracter == usuarios.listado[pos].length() - 1) || (numcaracter == user.length() - 1)){
-						fin = true;
-					}
-				}
-			}
-			return pos;
-		}
-
-		// Inserta un usuario en la lista en la posicin indicada
-		// PRECONDICIN: el usuario cabe en la lista
-		// PRECONDICIN: la posicin es correcta
-		void insertar_usuario_pos(Usuarios &usuarios, unsigned pos, const std::string &usuario) {
-			// PRECONDICIN: el usuario cabe en la lista
-			bool cabe = (usuarios.num_usuarios < MAX_USUARIOS) ? true : false;
-			// PRECONDICIN: la posicin es correcta
-			bool posicion_correcta = (pos == buscar_usuario(usuarios, usuario)) ? true : false;
-			// Si cumple, inserta un usuario en la lista en la posicin indicada
-			if (cabe && posicion_correcta) {
-				// Aade 1 a la lista
-				usuarios.num_usuarios++;
-				// Bucle de reordenacin desde el ultimo hasta llegar a pos
-				for (unsigned i = usuarios.num_usuarios; i > pos; i--) {
-					usuarios.listado[i] = usuarios.listado[i - 1];
-				}
-				// Y para finalizar, aadimos en la posicin el usuario
-				usuarios.listado[pos] = usuario;
-			}
-		}
-
-		// Elimina un usuario de una posisicin
-		// PRECONDICIN: la posicin es correcta
-		void eliminar_usuario_pos(Usuarios &usuarios, unsigned pos) {
-			// PRECONDICIN: la posicin es correcta
-			bool posicion_correcta = (pos >= 0 && pos < usuarios.num_usuarios) ? true : false;
-			// Si todo va bien, eliminar usuario
-			if (posicion_correcta) {
-				// Elimino el usuario pisandolo con el siguiente
-				for (unsigned i = pos; i < usuarios.num_usuarios - 1; i++) {
-					usuarios.listado[i] = usuarios.listado[i + 1];
-				}
-				// Quito 1 de la cuenta de la lista
-				usuarios.num_usuarios--;
-			}
-		}
-	};
-}
+/****************************************************************************
+* Clase UsuarioTwitter
+*
+* Esta clase implementa toda la operativa relativa a un usuario de la red
+* social 'Twitter', permitiendo la gestión de la lista de tweets,
+* usuarios seguidos (following) y usuarios seguidores (followers).
+*
+* Autor: Jose Antonio Zúñiga García
+* Fecha: Fri Mar 10 12:14:11 2017
+****************************************************************************/
+
+#ifndef __USUARIO__TWITTER__
+#define __USUARIO__TWITTER__
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <cstring>
+#include <chrono>
+#include "tabla_simbolos.hpp"
+#include "menciones.hpp"
+#include "lector_tweets.hpp"
+#include "metricas.hpp"
+#include "escritor_salida.hpp"
+#include "almacen_frio.hpp"
+#include "compresion_lz.hpp"
+#include "conjuntos_usuarios.hpp"
+
+namespace {
+	const unsigned TAM_BLOQUE_TWEETS = 128; // Número de tweets por bloque de la lista de tweets
+	const unsigned MAX_LONG_TWEET = 140; // Máxima longitud del texto de un tweet
+	const unsigned BLOQUES_POR_SELLADO = 8; // Bloques de tweets que se sellan juntos en el almacén frío
+	const std::size_t TAM_DICCIONARIO_TWEETS = 2048; // Bytes del diccionario de compresión de cada lista de tweets
+	const char FORMATO_BLOQUE_CRUDO = 0; // Bloque sellado sin comprimir
+	const char FORMATO_BLOQUE_LZ = 1; // Bloque sellado comprimido
+}
+
+
+namespace bblProgII {
+	//---------------------------------------------------------------------------
+	// TIPOS PÚBLICOS
+	//
+	// Lista de usuarios, representados por su identificador en la tabla de
+	// símbolos global (ver TablaSimbolos). Está ordenada por identificador y
+	// no tiene límite de tamaño; al estar ordenada, las búsquedas son
+	// binarias (O(log n)) y cada comparación es una comparación de enteros.
+	typedef std::vector <IdUsuario> ListaUsuarios;
+	struct Usuarios {
+		unsigned num_usuarios;
+		ListaUsuarios listado;
+	};
+
+	// Vista de solo lectura de una lista de usuarios (o de un tramo
+	// contiguo de ella) que no copia los identificadores: apunta a la
+	// lista original. Deja de ser válida en cuanto se modifica esa lista
+	// (alta o baja de un usuario, carga desde fichero, asignación) o se
+	// destruye el objeto al que pertenece.
+	class VistaUsuarios {
+	public:
+		typedef const IdUsuario * const_iterator;
+
+		// Constructor por defecto: vista vacía
+		VistaUsuarios() : inicio(nullptr), num(0) {}
+
+		// Constructor extendido: los 'num' usuarios que empiezan en 'inicio'
+		VistaUsuarios(const IdUsuario *inicio, unsigned num) : inicio(inicio), num(num) {}
+
+		const_iterator begin() const {
+			return inicio;
+		}
+		const_iterator end() const {
+			return inicio + num;
+		}
+
+		// Devuelve el usuario 'i' de la vista
+		// PRECONDICIÓN: i < longitud()
+		IdUsuario operator[](unsigned i) const {
+			return inicio[i];
+		}
+
+		// Devuelve el número de usuarios de la vista
+		unsigned longitud() const {
+			return num;
+		}
+
+		// Indica si la vista no tiene usuarios
+		bool vacia() const {
+			return num == 0;
+		}
+
+		// Devuelve el tramo de como mucho 'cuantos' usuarios que empieza en
+		// la posición 'desde' (vacío si 'desde' >= longitud())
+		VistaUsuarios subvista(unsigned desde, unsigned cuantos) const {
+			desde = std::min(desde, num);
+			return VistaUsuarios(inicio + desde, std::min(cuantos, num - desde));
+		}
+
+		// Devuelve el tramo de usuarios con identificador entre 'desde' y
+		// 'hasta' (ambos incluidos). Búsqueda binaria.
+		// PRECONDICIÓN: la vista está ordenada de menor a mayor
+		VistaUsuarios entre(IdUsuario desde, IdUsuario hasta) const {
+			const IdUsuario *ini = std::lower_bound(begin(), end(), desde);
+			const IdUsuario *fin = std::max(ini, std::upper_bound(ini, end(), hasta));
+			return VistaUsuarios(ini, unsigned(fin - ini));
+		}
+
+	private:
+		const IdUsuario *inicio;
+		unsigned num;
+	};
+	//---------------------------------------------------------------------------
+	// Lista de tweets
+	struct FechaHora {
+		unsigned anyo, mes, dia, hora, minuto, segundo;
+	};
+	struct Tweet {
+		std::string tweet;
+		FechaHora fecha_hora;
+	};
+	// Marca de tiempo empaquetada: segundos transcurridos desde el
+	// 1/1/1970 0:00:00. Ocupa 8 bytes frente a los 24 de 'FechaHora' y
+	// conserva el orden cronológico, por lo que dos marcas se comparan con
+	// una única comparación de enteros.
+	typedef std::int64_t MarcaTiempo;
+
+	// Indica si la fecha y hora existen (ver fecha_hora_valida en
+	// lector_tweets.hpp)
+	inline bool fecha_hora_valida(const FechaHora &fecha_hora) {
+		return fecha_hora_valida(fecha_hora.dia, fecha_hora.mes, fecha_hora.anyo,
+			fecha_hora.hora, fecha_hora.minuto, fecha_hora.segundo);
+	}
+
+	// Convierte una fecha y hora en su marca de tiempo. No comprueba los
+	// campos: uno fuera de rango se suma sin más (p. ej., el 31 de febrero
+	// da la marca del 2 o 3 de marzo), y con el mes 0 el resultado no tiene
+	// sentido.
+	// PRECONDICIÓN: fecha_hora_valida(fecha_hora)
+	inline MarcaTiempo a_marca_tiempo(const FechaHora &fecha_hora) {
+		// Los meses se cuentan desde marzo para que febrero quede al final
+		std::int64_t anyo = std::int64_t(fecha_hora.anyo) + (std::int64_t(fecha_hora.mes) + 9) / 12 - 1;
+		std::int64_t mes = (std::int64_t(fecha_hora.mes) + 9) % 12;
+		std::int64_t era = (anyo >= 0 ? anyo : anyo - 399) / 400;
+		std::int64_t anyo_era = anyo - era * 400;
+		std::int64_t dia_anyo = (153 * mes + 2) / 5 + std::int64_t(fecha_hora.dia) - 1;
+		std::int64_t dia_era = anyo_era * 365 + anyo_era / 4 - anyo_era / 100 + dia_anyo;
+		std::int64_t dias = era * 146097 + dia_era - 719468;
+		return dias * 86400 + std::int64_t(fecha_hora.hora) * 3600 +
+			std::int64_t(fecha_hora.minuto) * 60 + std::int64_t(fecha_hora.segundo);
+	}
+
+	// Convierte la fecha y hora de una línea de un fichero de tweets en su
+	// marca de tiempo (leer_fichero_tweets solo entrega líneas con fechas
+	// válidas)
+	inline MarcaTiempo a_marca_tiempo(const LineaTweet &linea) {
+		FechaHora fecha_hora;
+		fecha_hora.dia = linea.dia;
+		fecha_hora.mes = linea.mes;
+		fecha_hora.anyo = linea.anyo;
+		fecha_hora.hora = linea.hora;
+		fecha_hora.minuto = linea.minuto;
+		fecha_hora.segundo = linea.segundo;
+		return a_marca_tiempo(fecha_hora);
+	}
+
+	// Convierte una marca de tiempo en fecha y hora
+	inline FechaHora a_fecha_hora(MarcaTiempo marca) {
+		FechaHora fecha_hora;
+		std::int64_t dias = (marca >= 0 ? marca : marca - 86399) / 86400;
+		std::int64_t segundos = marca - dias * 86400;
+		fecha_hora.hora = unsigned(segundos / 3600);
+		fecha_hora.minuto = unsigned(segundos % 3600 / 60);
+		fecha_hora.segundo = unsigned(segundos % 60);
+		dias += 719468;
+		std::int64_t era = (dias >= 0 ? dias : dias - 146096) / 146097;
+		std::int64_t dia_era = dias - era * 146097;
+		std::int64_t anyo_era = (dia_era - dia_era / 1460 + dia_era / 36524 - dia_era / 146096) / 365;
+		std::int64_t dia_anyo = dia_era - (365 * anyo_era + anyo_era / 4 - anyo_era / 100);
+		std::int64_t mes = (5 * dia_anyo + 2) / 153;
+		fecha_hora.dia = unsigned(dia_anyo - (153 * mes + 2) / 5 + 1);
+		fecha_hora.mes = unsigned(mes < 10 ? mes + 3 : mes - 9);
+		fecha_hora.anyo = unsigned(anyo_era + era * 400 + (fecha_hora.mes <= 2 ? 1 : 0));
+		return fecha_hora;
+	}
+
+	// Texto de un tweet guardado dentro del propio registro. Como nunca
+	// pasa de MAX_LONG_TWEET caracteres, cabe en un hueco fijo de
+	// MAX_LONG_TWEET + 1 bytes (la longitud y los caracteres, sin '\0')
+	// y no necesita memoria dinámica. Al asignarle un texto más largo se
+	// trunca. Se convierte a std::string_view para leerlo.
+	class TextoTweet {
+	public:
+		// Constructor por defecto: texto vacío
+		TextoTweet() : longitud(0) {}
+
+		// Copia los 'num' caracteres de 'texto' (como mucho MAX_LONG_TWEET)
+		void assign(const char *texto, std::size_t num) {
+			longitud = static_cast<unsigned char>(std::min(num, std::size_t(MAX_LONG_TWEET)));
+			std::copy(texto, texto + longitud, caracteres);
+		}
+		TextoTweet & operator=(std::string_view texto) {
+			assign(texto.data(), texto.size());
+			return *this;
+		}
+
+		const char * data() const {
+			return caracteres;
+		}
+		std::size_t size() const {
+			return longitud;
+		}
+		bool empty() const {
+			return longitud == 0;
+		}
+		operator std::string_view() const {
+			return std::string_view(caracteres, longitud);
+		}
+
+	private:
+		unsigned char longitud;
+		char caracteres[MAX_LONG_TWEET];
+	};
+
+	inline bool operator==(const TextoTweet &a, const TextoTweet &b) {
+		return std::string_view(a) == std::string_view(b);
+	}
+	inline bool operator==(const TextoTweet &a, std::string_view b) {
+		return std::string_view(a) == b;
+	}
+	inline bool operator==(std::string_view a, const TextoTweet &b) {
+		return a == std::string_view(b);
+	}
+	inline bool operator!=(const TextoTweet &a, const TextoTweet &b) {
+		return !(a == b);
+	}
+	inline bool operator!=(const TextoTweet &a, std::string_view b) {
+		return !(a == b);
+	}
+	inline bool operator!=(std::string_view a, const TextoTweet &b) {
+		return !(a == b);
+	}
+	inline std::ostream & operator<<(std::ostream &salida, const TextoTweet &texto) {
+		return salida << std::string_view(texto);
+	}
+
+	// Tweet tal y como se guarda en la lista de tweets: el texto y la
+	// marca de tiempo empaquetada.
+	struct RegistroTweet {
+		MarcaTiempo marca_tiempo;
+		TextoTweet tweet;
+	};
+
+	// Registro de tweets de solo inserción al final. Los tweets se guardan en
+	// bloques de TAM_BLOQUE_TWEETS registros que se reservan a medida que
+	// llegan tweets nuevos, de forma que un usuario sin tweets no ocupa
+	// memoria para ellos y no hay un máximo de tweets por usuario. El
+	// primer bloque crece de forma gradual (duplicando su capacidad), para
+	// que un usuario con pocos tweets no reserve un bloque entero; los
+	// siguientes se reservan completos. Los registros de los bloques llenos
+	// no cambian de dirección al insertar tweets nuevos; los del último
+	// bloque pueden hacerlo.
+	//
+	// Como un tweet insertado no se modifica nunca, las copias de una lista
+	// comparten sus bloques: solo se copia el vector de punteros a bloques.
+	// El único bloque en el que se escribe es el último, que se duplica
+	// antes de insertar en él si está compartido (copia en escritura).
+	//
+	// Almacenamiento escalonado: con el almacén frío activo (ver
+	// AlmacenFrio), sellar_antiguos() escribe en disco los bloques llenos
+	// más antiguos y los libera, dejando en memoria solo los más
+	// recientes. Los bloques sellados (fríos) son siempre los primeros;
+	// de cada uno se guarda en memoria dónde está y la marca de tiempo de
+	// su primer tweet. Los bloques fríos se leen (a través de la caché del
+	// almacén) al acceder a ellos con fijar_bloque(), que devuelve el
+	// bloque en memoria, o con las vistas; leer un tweet suelto solo lee
+	// (y descomprime) su bloque. Si un bloque sellado no se puede leer o
+	// sus datos no son válidos, los métodos que lo necesitan lo indican
+	// (fijar_bloque devuelve un puntero nulo, leer y primero_desde
+	// devuelven false) en lugar de inventar sus tweets.
+	//
+	// En disco, un bloque empieza por su formato. Sin comprimir
+	// (FORMATO_BLOQUE_CRUDO), cada tweet ocupa su marca de tiempo, la
+	// longitud del texto (1 byte) y el texto. Comprimido
+	// (FORMATO_BLOQUE_LZ, con la compresión del almacén activada), los
+	// datos se reordenan por columnas (las diferencias entre marcas de
+	// tiempo consecutivas en base 128, las longitudes y los textos
+	// seguidos), que se comprimen con compresion_lz.hpp usando un
+	// diccionario propio de la lista, entrenado con los tweets de su
+	// primer sellado y compartido con sus copias. Delante van el tamaño
+	// de las columnas y su suma de control, para detectar al leerlo un
+	// bloque dañado o descomprimido con otro diccionario.
+	class ListaTweets {
+	public:
+		// Bloque de como mucho TAM_BLOQUE_TWEETS registros
+		typedef std::vector <RegistroTweet> Bloque;
+
+		// Constructor por defecto: lista vacía, sin bloques reservados
+		ListaTweets() : num_elementos(0), cronologica(true), frios(), bloques(), diccionario() {}
+
+		// Constructor de copia y operador de asignación: comparten los
+		// bloques de 'otra', O(longitud() / TAM_BLOQUE_TWEETS)
+		ListaTweets(const ListaTweets &otra) = default;
+		ListaTweets & operator=(const ListaTweets &otra) = default;
+
+		// Constructor y operador de asignación de movimiento: se traspasan
+		// los bloques sin copiar los tweets y 'otra' queda vacía
+		ListaTweets(ListaTweets &&otra) noexcept :
+			num_elementos(otra.num_elementos), cronologica(otra.cronologica), frios(std::move(otra.frios)),
+			bloques(std::move(otra.bloques)), diccionario(std::move(otra.diccionario)) {
+			otra.vaciar();
+		}
+		ListaTweets & operator=(ListaTweets &&otra) noexcept {
+			if (this != &otra) {
+				num_elementos = otra.num_elementos;
+				cronologica = otra.cronologica;
+				frios = std::move(otra.frios);
+				bloques = std::move(otra.bloques);
+				diccionario = std::move(otra.diccionario);
+				otra.vaciar();
+			}
+			return *this;
+		}
+
+		// Devuelve una copia del tweet 'i' con su fecha y hora
+		// PRECONDICIÓN: i < longitud() y, si está sellado, su bloque se
+		// puede leer (ver leer)
+		Tweet operator[](unsigned i) const {
+			Tweet tweet = Tweet();
+			leer(i, tweet);
+			return tweet;
+		}
+
+		// Devuelve a través de 'tweet' una copia del tweet 'i' con su fecha
+		// y hora. Devuelve false, sin modificar 'tweet', si está en un
+		// bloque sellado que no se puede leer.
+		// PRECONDICIÓN: i < longitud()
+		bool leer(unsigned i, Tweet &tweet) const {
+			std::shared_ptr<const Bloque> bloque = fijar_bloque(i / TAM_BLOQUE_TWEETS);
+			if (bloque != nullptr) {
+				const RegistroTweet &leido = (*bloque)[i % TAM_BLOQUE_TWEETS];
+				tweet.tweet = leido.tweet;
+				tweet.fecha_hora = a_fecha_hora(leido.marca_tiempo);
+			}
+			return bloque != nullptr;
+		}
+
+		// Acceso al registro del tweet 'i', sin copias
+		// PRECONDICIÓN: primero_en_memoria() <= i < longitud()
+		const RegistroTweet & registro(unsigned i) const {
+			return (*bloques[i / TAM_BLOQUE_TWEETS - frios.size()])[i % TAM_BLOQUE_TWEETS];
+		}
+
+		// Devuelve el bloque 'num_bloque' (el de los tweets
+		// [num_bloque * TAM_BLOQUE_TWEETS, (num_bloque + 1) * TAM_BLOQUE_TWEETS)).
+		// Si está sellado, se lee del almacén frío; si no se puede leer o
+		// sus datos no son válidos (por ejemplo, no se pueden
+		// descomprimir), se devuelve un puntero nulo. El bloque devuelto
+		// no cambia mientras se tenga (al insertar en la lista, el último
+		// bloque se duplica si está compartido).
+		// PRECONDICIÓN: num_bloque * TAM_BLOQUE_TWEETS < longitud()
+		std::shared_ptr<const Bloque> fijar_bloque(unsigned num_bloque) const {
+			std::shared_ptr<const Bloque> bloque;
+			if (num_bloque >= frios.size()) {
+				bloque = bloques[num_bloque - frios.size()];
+			}
+			else {
+				std::shared_ptr<Bloque> leido = std::make_shared<Bloque>();
+				std::shared_ptr<const AlmacenFrio::Bytes> bytes = AlmacenFrio::global().leer(frios[num_bloque].ref);
+				if (bytes != nullptr && decodificar_bloque(*bytes, diccionario.get(), *leido)) {
+					bloque = leido;
+				}
+				else if (bytes != nullptr) {
+					AlmacenFrio::global().anotar_bloque_invalido();
+				}
+			}
+			return bloque;
+		}
+
+		// Devuelve el número de tweets de la lista
+		unsigned longitud() const {
+			return num_elementos;
+		}
+
+		// Devuelve el número del primer tweet que está en memoria (los
+		// anteriores están sellados en disco)
+		unsigned primero_en_memoria() const {
+			return unsigned(frios.size()) * TAM_BLOQUE_TWEETS;
+		}
+
+		// Indica si los tweets se han insertado en orden cronológico (cada
+		// tweet con marca de tiempo mayor o igual que la del anterior)
+		bool es_cronologica() const {
+			return cronologica;
+		}
+
+		// Devuelve a través de 'pos' la posición del primer tweet con marca
+		// de tiempo mayor o igual que 'marca' (longitud() si no hay
+		// ninguno). Búsqueda binaria entre los primeros tweets de los
+		// bloques y después dentro de un solo bloque, que es el único que
+		// se lee si está sellado. Devuelve false si ese bloque no se puede
+		// leer.
+		// PRECONDICIÓN: es_cronologica()
+		bool primero_desde(MarcaTiempo marca, unsigned &pos) const {
+			// Primer bloque que empieza en 'marca' o después: el tweet
+			// buscado es su primero o está en el bloque anterior
+			unsigned ini = 0, fin = unsigned(frios.size() + bloques.size());
+			while (ini < fin) {
+				unsigned mitad = ini + (fin - ini) / 2;
+				if (primera_marca(mitad) < marca) {
+					ini = mitad + 1;
+				}
+				else {
+					fin = mitad;
+				}
+			}
+			bool correcto = true;
+			pos = std::min(ini * TAM_BLOQUE_TWEETS, num_elementos);
+			if (ini > 0) {
+				std::shared_ptr<const Bloque> bloque = fijar_bloque(ini - 1);
+				correcto = (bloque != nullptr);
+				if (correcto) {
+					Bloque::const_iterator primero = std::lower_bound(bloque->begin(), bloque->end(), marca,
+						[](const RegistroTweet &registro, MarcaTiempo buscada) {
+							return registro.marca_tiempo < buscada;
+						});
+					pos = (ini - 1) * TAM_BLOQUE_TWEETS + unsigned(primero - bloque->begin());
+				}
+			}
+			return correcto;
+		}
+
+		// Inserta un tweet al final de la lista, reservando un bloque
+		// nuevo si el último está lleno. El texto se copia directamente
+		// en su registro, truncado a MAX_LONG_TWEET caracteres.
+		void insertar_final(const Tweet &nuevo) {
+			reservar_final(a_marca_tiempo(nuevo.fecha_hora)).tweet = nuevo.tweet;
+		}
+		void insertar_final(const RegistroTweet &nuevo) {
+			reservar_final(nuevo.marca_tiempo).tweet = nuevo.tweet;
+		}
+		void insertar_final(MarcaTiempo marca_tiempo, const char *texto, std::size_t longitud) {
+			reservar_final(marca_tiempo).tweet.assign(texto, longitud);
+		}
+
+		// Si el almacén frío está activo, sella en disco los bloques llenos
+		// que no contienen ninguno de los AlmacenFrio::tweets_en_memoria()
+		// últimos tweets, en cuanto hay BLOQUES_POR_SELLADO, y los libera.
+		// Los bloques que no se pueden escribir se quedan en memoria.
+		// Devuelve false si ha fallado alguna escritura.
+		bool sellar_antiguos() {
+			bool correcto = true;
+			AlmacenFrio &almacen = AlmacenFrio::global();
+			if (almacen.activo()) {
+				unsigned en_memoria = std::min(almacen.tweets_en_memoria(), num_elementos);
+				unsigned fin_sellables = (num_elementos - en_memoria) / TAM_BLOQUE_TWEETS;
+				if (fin_sellables >= frios.size() + BLOQUES_POR_SELLADO) {
+					correcto = sellar_bloques(fin_sellables - unsigned(frios.size()));
+				}
+			}
+			return correcto;
+		}
+
+		// Elimina todos los tweets y libera los bloques
+		void vaciar() {
+			frios.clear();
+			bloques.clear();
+			diccionario.reset();
+			num_elementos = 0;
+			cronologica = true;
+		}
+
+	private:
+		// Bloque sellado en el almacén frío y marca de tiempo de su primer
+		// tweet
+		struct BloqueFrio {
+			RefBloqueFrio ref;
+			MarcaTiempo primera_marca;
+		};
+
+		unsigned num_elementos;
+		bool cronologica;
+		// Bloques sellados (los primeros) y bloques en memoria (los
+		// siguientes), estos posiblemente compartidos con copias de la
+		// lista
+		std::vector <BloqueFrio> frios;
+		std::vector <std::shared_ptr<Bloque>> bloques;
+		// Diccionario de compresión de los bloques sellados (nulo hasta el
+		// primer sellado comprimido)
+		std::shared_ptr<const std::string> diccionario;
+
+		// Marca de tiempo del primer tweet del bloque 'num_bloque'
+		MarcaTiempo primera_marca(unsigned num_bloque) const {
+			return (num_bloque < frios.size()) ? frios[num_bloque].primera_marca
+				: (*bloques[num_bloque - frios.size()])[0].marca_tiempo;
+		}
+
+		// Añade al final un registro con la marca de tiempo dada (y el
+		// texto vacío) y lo devuelve
+		RegistroTweet & reservar_final(MarcaTiempo marca_tiempo) {
+			if (num_elementos == (frios.size() + bloques.size()) * TAM_BLOQUE_TWEETS) {
+				bloques.push_back(std::make_shared<Bloque>());
+				bloques.back()->reserve(num_elementos == 0 ? 1 : TAM_BLOQUE_TWEETS);
+			}
+			else if (bloques.back().use_count() > 1) {
+				// Otra copia de la lista comparte el último bloque: se
+				// escribe en un duplicado
+				std::shared_ptr<Bloque> duplicado = std::make_shared<Bloque>();
+				duplicado->reserve(bloques.back()->capacity());
+				duplicado->assign(bloques.back()->begin(), bloques.back()->end());
+				bloques.back() = duplicado;
+			}
+			// El último tweet siempre está en memoria (ver sellar_antiguos)
+			if (num_elementos > 0 && marca_tiempo < registro(num_elementos - 1).marca_tiempo) {
+				cronologica = false;
+			}
+			bloques.back()->emplace_back();
+			RegistroTweet &nuevo = bloques.back()->back();
+			nuevo.marca_tiempo = marca_tiempo;
+			num_elementos++;
+			return nuevo;
+		}
+
+		// Sella los 'num' primeros bloques en memoria con una sola
+		// escritura en el almacén frío y los libera
+		// PRECONDICIÓN: están llenos
+		bool sellar_bloques(unsigned num) {
+			AlmacenFrio &almacen = AlmacenFrio::global();
+			const std::string *dic = nullptr;
+			if (almacen.compresion_activa()) {
+				if (diccionario == nullptr) {
+					entrenar(num);
+				}
+				dic = diccionario.get();
+			}
+			AlmacenFrio::Bytes bytes;
+			std::size_t sin_comprimir = 0;
+			std::vector <std::uint32_t> finales(num);
+			for (unsigned b = 0; b < num; b++) {
+				sin_comprimir += codificar_bloque(*bloques[b], dic, bytes);
+				finales[b] = std::uint32_t(bytes.size());
+			}
+			RefBloqueFrio tramo;
+			bool correcto = almacen.sellar(bytes.data(), bytes.size(), sin_comprimir, tramo);
+			if (correcto) {
+				for (unsigned b = 0; b < num; b++) {
+					BloqueFrio frio;
+					frio.ref.fichero = tramo.fichero;
+					frio.ref.posicion = tramo.posicion + (b == 0 ? 0 : finales[b - 1]);
+					frio.ref.bytes = finales[b] - (b == 0 ? 0 : finales[b - 1]);
+					frio.primera_marca = (*bloques[b])[0].marca_tiempo;
+					frios.push_back(frio);
+				}
+				bloques.erase(bloques.begin(), bloques.begin() + num);
+			}
+			return correcto;
+		}
+
+		// Entrena el diccionario de compresión con los textos de los 'num'
+		// primeros bloques en memoria
+		void entrenar(unsigned num) {
+			std::vector <std::string_view> muestras;
+			for (unsigned b = 0; b < num; b++) {
+				for (std::size_t i = 0; i < bloques[b]->size(); i++) {
+					muestras.push_back((*bloques[b])[i].tweet);
+				}
+			}
+			std::shared_ptr<std::string> nuevo = std::make_shared<std::string>();
+			entrenar_diccionario(muestras, TAM_DICCIONARIO_TWEETS, *nuevo);
+			diccionario = nuevo;
+		}
+
+		// Añade al final de 'bytes' el bloque codificado: sin comprimir si
+		// 'dic' es nulo y, si no, comprimido con ese diccionario. Devuelve
+		// los bytes que ocupa sin comprimir.
+		static std::size_t codificar_bloque(const Bloque &bloque, const std::string *dic, AlmacenFrio::Bytes &bytes) {
+			std::size_t inicio = bytes.size(), sin_comprimir = 1;
+			if (dic == nullptr) {
+				bytes.push_back(FORMATO_BLOQUE_CRUDO);
+				for (std::size_t i = 0; i < bloque.size(); i++) {
+					const RegistroTweet &registro = bloque[i];
+					std::size_t pos = bytes.size();
+					bytes.resize(pos + sizeof(MarcaTiempo) + 1 + registro.tweet.size());
+					std::memcpy(bytes.data() + pos, &registro.marca_tiempo, sizeof(MarcaTiempo));
+					bytes[pos + sizeof(MarcaTiempo)] = char(registro.tweet.size());
+					std::memcpy(bytes.data() + pos + sizeof(MarcaTiempo) + 1, registro.tweet.data(), registro.tweet.size());
+				}
+				sin_comprimir = bytes.size() - inicio;
+			}
+			else {
+				// Por columnas: diferencias de marcas de tiempo (en zigzag,
+				// para que las negativas también sean pequeñas), longitudes y
+				// textos
+				AlmacenFrio::Bytes columnas;
+				MarcaTiempo anterior = 0;
+				for (std::size_t i = 0; i < bloque.size(); i++) {
+					std::uint64_t diferencia = std::uint64_t(bloque[i].marca_tiempo) - std::uint64_t(anterior);
+					std::uint64_t zigzag = (diferencia << 1) ^ (0 - (diferencia >> 63));
+					while (zigzag >= 0x80) {
+						columnas.push_back(char((zigzag & 0x7F) | 0x80));
+						zigzag >>= 7;
+					}
+					columnas.push_back(char(zigzag));
+					anterior = bloque[i].marca_tiempo;
+					sin_comprimir += sizeof(MarcaTiempo) + 1 + bloque[i].tweet.size();
+				}
+				for (std::size_t i = 0; i < bloque.size(); i++) {
+					columnas.push_back(char(bloque[i].tweet.size()));
+				}
+				for (std::size_t i = 0; i < bloque.size(); i++) {
+					columnas.insert(columnas.end(), bloque[i].tweet.data(), bloque[i].tweet.data() + bloque[i].tweet.size());
+				}
+				std::uint32_t cabecera[2] = { std::uint32_t(columnas.size()), suma_control_lz(columnas.data(), columnas.size()) };
+				bytes.push_back(FORMATO_BLOQUE_LZ);
+				bytes.resize(bytes.size() + sizeof(cabecera));
+				std::memcpy(bytes.data() + bytes.size() - sizeof(cabecera), cabecera, sizeof(cabecera));
+				comprimir_lz(columnas.data(), columnas.size(), *dic, bytes);
+			}
+			return sin_comprimir;
+		}
+
+		// Reconstruye en 'bloque' los tweets codificados en 'bytes' (con el
+		// diccionario 'dic' si está comprimido). Devuelve false si los
+		// bytes no son un bloque lleno válido.
+		static bool decodificar_bloque(const AlmacenFrio::Bytes &bytes, const std::string *dic, Bloque &bloque) {
+			bloque.clear();
+			bloque.reserve(TAM_BLOQUE_TWEETS);
+			bool correcto = !bytes.empty();
+			if (correcto && bytes[0] == FORMATO_BLOQUE_CRUDO) {
+				std::size_t pos = 1;
+				while (pos < bytes.size() && correcto) {
+					correcto = bytes.size() - pos >= sizeof(MarcaTiempo) + 1;
+					if (correcto) {
+						std::size_t longitud = static_cast<unsigned char>(bytes[pos + sizeof(MarcaTiempo)]);
+						correcto = bytes.size() - pos - sizeof(MarcaTiempo) - 1 >= longitud && bloque.size() < TAM_BLOQUE_TWEETS;
+						if (correcto) {
+							bloque.emplace_back();
+							std::memcpy(&bloque.back().marca_tiempo, bytes.data() + pos, sizeof(MarcaTiempo));
+							bloque.back().tweet.assign(bytes.data() + pos + sizeof(MarcaTiempo) + 1, longitud);
+							pos += sizeof(MarcaTiempo) + 1 + longitud;
+						}
+					}
+				}
+			}
+			else if (correcto) {
+				// Cabecera: tamaño de las columnas y su suma de control
+				std::uint32_t cabecera[2] = { 0, 0 };
+				correcto = bytes[0] == FORMATO_BLOQUE_LZ && dic != nullptr && bytes.size() >= 1 + sizeof(cabecera);
+				if (correcto) {
+					std::memcpy(cabecera, bytes.data() + 1, sizeof(cabecera));
+					correcto = cabecera[0] <= TAM_BLOQUE_TWEETS * (10 + 1 + MAX_LONG_TWEET);
+				}
+				AlmacenFrio::Bytes columnas(correcto ? cabecera[0] : 0);
+				if (correcto) {
+					std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+					correcto = descomprimir_lz(bytes.data() + 1 + sizeof(cabecera), bytes.size() - 1 - sizeof(cabecera),
+						*dic, columnas.data(), columnas.size());
+					AlmacenFrio::global().anotar_descompresion(columnas.size(), (unsigned long long)
+						std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - inicio).count());
+				}
+				correcto = correcto && suma_control_lz(columnas.data(), columnas.size()) == cabecera[1] &&
+					decodificar_columnas(columnas, bloque);
+			}
+			return correcto && bloque.size() == TAM_BLOQUE_TWEETS;
+		}
+
+		// Reconstruye en 'bloque' los TAM_BLOQUE_TWEETS tweets de un bloque
+		// comprimido, ya descomprimido en 'columnas'
+		static bool decodificar_columnas(const AlmacenFrio::Bytes &columnas, Bloque &bloque) {
+			bloque.resize(TAM_BLOQUE_TWEETS);
+			std::size_t pos = 0;
+			MarcaTiempo anterior = 0;
+			bool correcto = true;
+			for (unsigned i = 0; i < TAM_BLOQUE_TWEETS && correcto; i++) {
+				std::uint64_t zigzag = 0;
+				unsigned desplazamiento = 0;
+				bool sigue = true;
+				while (sigue && correcto) {
+					correcto = pos < columnas.size() && desplazamiento < 64;
+					if (correcto) {
+						zigzag |= std::uint64_t(columnas[pos] & 0x7F) << desplazamiento;
+						sigue = (columnas[pos] & 0x80) != 0;
+						desplazamiento += 7;
+						pos++;
+					}
+				}
+				std::uint64_t diferencia = (zigzag >> 1) ^ (0 - (zigzag & 1));
+				anterior = MarcaTiempo(std::uint64_t(anterior) + diferencia);
+				bloque[i].marca_tiempo = anterior;
+			}
+			std::size_t pos_textos = pos + TAM_BLOQUE_TWEETS;
+			correcto = correcto && pos_textos <= columnas.size();
+			for (unsigned i = 0; i < TAM_BLOQUE_TWEETS && correcto; i++) {
+				std::size_t longitud = static_cast<unsigned char>(columnas[pos + i]);
+				correcto = columnas.size() - pos_textos >= longitud;
+				if (correcto) {
+					bloque[i].tweet.assign(columnas.data() + pos_textos, longitud);
+					pos_textos += longitud;
+				}
+			}
+			return correcto && pos_textos == columnas.size();
+		}
+	};
+	struct Tweets {
+		unsigned num_tweets;
+		ListaTweets listado;
+	};
+
+	// Vista de solo lectura de los tweets de una lista entre dos
+	// posiciones, sin copiarlos: al recorrerla se obtienen referencias a
+	// los registros de la propia lista. Opcionalmente, solo incluye los
+	// tweets con marca de tiempo en un rango (los demás se saltan al
+	// recorrerla).
+	//
+	// Como la vista accede a los tweets a través de la lista, sigue siendo
+	// válida al insertar tweets nuevos al final (que no aparecen en ella) y
+	// al sellar bloques. Deja de serlo si la lista se vacía, se asigna, se
+	// carga desde fichero, se mueve o se destruye. Cada iterador tiene
+	// fijado el bloque del tweet al que apunta (ver
+	// ListaTweets::fijar_bloque), así que recorrer una vista lee cada
+	// bloque sellado una sola vez y la referencia a un tweet sigue siendo
+	// válida mientras el iterador no avance a otro bloque. Si llega a un
+	// bloque sellado que no se puede leer, el iterador pasa al final de
+	// la vista y su método error() lo indica.
+	class VistaTweets {
+	public:
+		class const_iterator {
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef RegistroTweet value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const RegistroTweet * pointer;
+			typedef const RegistroTweet & reference;
+
+			const_iterator() : lista(nullptr), pos(0), fin(0), filtrada(false), desde(0), hasta(0), bloque(),
+				num_bloque(0), fallido(false) {}
+			const_iterator(const VistaTweets &vista, unsigned pos) :
+				lista(vista.lista), pos(pos), fin(vista.fin), filtrada(vista.filtrada), desde(vista.desde), hasta(vista.hasta),
+				bloque(), num_bloque(0), fallido(false) {
+				fijar();
+				saltar_filtrados();
+			}
+
+			const RegistroTweet & operator*() const {
+				return (*bloque)[pos % TAM_BLOQUE_TWEETS];
+			}
+			const RegistroTweet * operator->() const {
+				return &(*bloque)[pos % TAM_BLOQUE_TWEETS];
+			}
+			const_iterator & operator++() {
+				pos++;
+				fijar();
+				saltar_filtrados();
+				return *this;
+			}
+			const_iterator operator++(int) {
+				const_iterator anterior = *this;
+				++*this;
+				return anterior;
+			}
+			bool operator==(const const_iterator &otro) const {
+				return pos == otro.pos;
+			}
+			bool operator!=(const const_iterator &otro) const {
+				return pos != otro.pos;
+			}
+
+			// Devuelve la posición del tweet en la lista (su número de
+			// tweet)
+			unsigned posicion() const {
+				return pos;
+			}
+
+			// Indica si el recorrido ha terminado antes de tiempo porque
+			// un bloque sellado no se ha podido leer
+			bool error() const {
+				return fallido;
+			}
+
+		private:
+			const ListaTweets *lista;
+			unsigned pos, fin;
+			bool filtrada;
+			MarcaTiempo desde, hasta;
+			// Bloque fijado y su número (nulo si no se ha fijado ninguno)
+			std::shared_ptr<const ListaTweets::Bloque> bloque;
+			unsigned num_bloque;
+			bool fallido;
+
+			// Fija el bloque del tweet 'pos' si no es el que ya estaba
+			// fijado. Si no se puede leer, pasa al final.
+			void fijar() {
+				if (pos < fin && (bloque == nullptr || pos / TAM_BLOQUE_TWEETS != num_bloque)) {
+					num_bloque = pos / TAM_BLOQUE_TWEETS;
+					bloque = lista->fijar_bloque(num_bloque);
+					if (bloque == nullptr) {
+						fallido = true;
+						pos = fin;
+					}
+				}
+			}
+
+			// Avanza hasta el siguiente tweet que está en el rango de
+			// marcas de tiempo de la vista (o hasta el final)
+			void saltar_filtrados() {
+				if (filtrada) {
+					while (pos < fin && ((**this).marca_tiempo < desde || (**this).marca_tiempo > hasta)) {
+						pos++;
+						fijar();
+					}
+				}
+			}
+		};
+
+		// Constructor por defecto: vista vacía
+		VistaTweets() : lista(nullptr), ini(0), fin(0), filtrada(false), desde(0), hasta(0) {}
+
+		// Constructor extendido: tweets de 'lista' en las posiciones
+		// [ini, fin)
+		// PRECONDICIÓN: ini <= fin <= lista.longitud()
+		VistaTweets(const ListaTweets &lista, unsigned ini, unsigned fin) :
+			lista(&lista), ini(ini), fin(fin), filtrada(false), desde(0), hasta(0) {}
+
+		// Igual, pero solo con los tweets con marca de tiempo entre 'desde'
+		// y 'hasta' (ambas incluidas)
+		VistaTweets(const ListaTweets &lista, unsigned ini, unsigned fin, MarcaTiempo desde, MarcaTiempo hasta) :
+			lista(&lista), ini(ini), fin(fin), filtrada(true), desde(desde), hasta(hasta) {}
+
+		const_iterator begin() const {
+			return const_iterator(*this, ini);
+		}
+		const_iterator end() const {
+			return const_iterator(*this, fin);
+		}
+
+		// Indica si la vista no tiene tweets
+		bool vacia() const {
+			return begin() == end();
+		}
+
+		// Devuelve el número de tweets de la vista. Si está filtrada por
+		// marca de tiempo, hay que recorrerla: O(fin - ini).
+		// PRECONDICIÓN: si está filtrada, sus bloques sellados se pueden
+		// leer (ver contar)
+		unsigned longitud() const {
+			unsigned num = 0;
+			contar(num);
+			return num;
+		}
+
+		// Devuelve a través de 'num' el número de tweets de la vista, como
+		// longitud(). Devuelve false si la vista está filtrada y alguno de
+		// sus bloques sellados no se puede leer (en 'num' quedan los
+		// tweets anteriores a él).
+		bool contar(unsigned &num) const {
+			bool correcto = true;
+			num = fin - ini;
+			if (filtrada) {
+				const_iterator it = begin();
+				num = 0;
+				for (; it != end(); ++it) {
+					num++;
+				}
+				correcto = !it.error();
+			}
+			return correcto;
+		}
+
+	private:
+		const ListaTweets *lista;
+		unsigned ini, fin;
+		bool filtrada;
+		MarcaTiempo desde, hasta;
+	};
+	//---------------------------------------------------------------------------
+	// Resulstado de las operaciones:
+	//  - OK: la operación se ha realizado con éxito
+	//  - LISTA_LLENA: la operación no ha sido posible: lista llena
+	//  - YA_EXISTE: la operación no ha sido posible: el elemento ya existe
+	//  - NO_EXISTE: el elemento no existe
+	//  - FIC_ERROR: error en el fichero
+	typedef unsigned Resultado;
+	const Resultado OK = 0,
+		LISTA_LLENA = 1,
+		YA_EXISTE = 2,
+		NO_EXISTE = 3,
+		FIC_ERROR = 4;
+
+	// Modo de carga de las listas de usuarios desde fichero:
+	//  - SUSTITUIR_LISTA: la lista leída sustituye a la actual
+	//  - FUSIONAR_LISTA: los usuarios leídos se añaden a la lista actual
+	enum ModoCarga {
+		SUSTITUIR_LISTA,
+		FUSIONAR_LISTA
+	};
+
+	/* O, alternativamente,
+	enum Resultado {
+	OK,
+	LISTA_LLENA,
+	YA_EXISTE,
+	NO_EXISTE,
+	FIC_ERROR
+	};
+	*/
+
+
+	class UsuarioTwitter {
+	public:
+		// Constructor por defecto
+		// Inicializar todos los datos vacíos.
+		UsuarioTwitter() : id_usuario(""), tweets(), siguiendo(usuarios_vacia()), seguidores(usuarios_vacia()),
+			menciones(menciones_vacia()) {
+			tweets.num_tweets = 0;
+		}
+
+		// Constructor extendido.
+		// Inicializa el idenfificador de usuario con el 'id' que se pasa
+		// como parámetro. Las listas de usuarios y tweets están
+		// vacías.
+		UsuarioTwitter(const std::string &id) : id_usuario(id), tweets(), siguiendo(usuarios_vacia()),
+			seguidores(usuarios_vacia()), menciones(menciones_vacia()) {
+			tweets.num_tweets = 0;
+		}
+
+		// Constructor de copia. Las listas de usuarios y de menciones se
+		// comparten con 'otro_usuario' hasta que uno de los dos las
+		// modifica (copia en escritura); de la lista de tweets se
+		// comparten los bloques (ver ListaTweets). Copiar un usuario
+		// cuesta, por tanto, O(num_tweets / TAM_BLOQUE_TWEETS).
+		UsuarioTwitter(const UsuarioTwitter &otro_usuario) :
+			id_usuario(otro_usuario.id_usuario), tweets(otro_usuario.tweets), siguiendo(otro_usuario.siguiendo),
+			seguidores(otro_usuario.seguidores), menciones(otro_usuario.menciones) {}
+
+		// Operador de asignación (igual que el constructor de copia)
+		UsuarioTwitter & operator=(const UsuarioTwitter &otro_usuario) {
+			if (this != &otro_usuario) {
+				id_usuario = otro_usuario.id_usuario;
+				tweets = otro_usuario.tweets;
+				siguiendo = otro_usuario.siguiendo;
+				seguidores = otro_usuario.seguidores;
+				menciones = otro_usuario.menciones;
+			}
+			return *this;
+		}
+
+		// Constructor y operador de asignación de movimiento: se traspasan
+		// las listas sin copiarlas y 'otro_usuario' queda sin
+		// identificador, usuarios, tweets ni menciones
+		UsuarioTwitter(UsuarioTwitter &&otro_usuario) noexcept :
+			id_usuario(std::move(otro_usuario.id_usuario)), tweets(), siguiendo(std::move(otro_usuario.siguiendo)),
+			seguidores(std::move(otro_usuario.seguidores)), menciones(std::move(otro_usuario.menciones)) {
+			tweets.num_tweets = otro_usuario.tweets.num_tweets;
+			tweets.listado = std::move(otro_usuario.tweets.listado);
+			otro_usuario.vaciar();
+		}
+		UsuarioTwitter & operator=(UsuarioTwitter &&otro_usuario) noexcept {
+			if (this != &otro_usuario) {
+				id_usuario = std::move(otro_usuario.id_usuario);
+				tweets.num_tweets = otro_usuario.tweets.num_tweets;
+				tweets.listado = std::move(otro_usuario.tweets.listado);
+				siguiendo = std::move(otro_usuario.siguiendo);
+				seguidores = std::move(otro_usuario.seguidores);
+				menciones = std::move(otro_usuario.menciones);
+				otro_usuario.vaciar();
+			}
+			return *this;
+		}
+
+		// Destructor de la clase
+		~UsuarioTwitter() {};
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE CONSULTA
+
+		// Devuelve el idenficador del usuario
+		std::string obtener_id() const {
+			return id_usuario;
+		}
+
+		// Devuelve la lista de seguidores (identificadores ordenados de menor
+		// a mayor; TablaSimbolos::nombre da el nombre de cada uno)
+		void obtener_seguidores(Usuarios &lista_seg) const {
+			MedidaOperacion medida(MET_OBTENER_SEGUIDORES);
+			lista_seg = *seguidores;
+		}
+
+		// Devuelve la lista de usuarios a los que se sigue (identificadores
+		// ordenados de menor a mayor)
+		void obtener_siguiendo(Usuarios &lista_sig) const {
+			MedidaOperacion medida(MET_OBTENER_SIGUIENDO);
+			lista_sig = *siguiendo;
+		}
+
+		// Devuelve la lista de tweets del usuario
+		void obtener_tweets(Tweets &lista_tweets) const {
+			MedidaOperacion medida(MET_OBTENER_TWEETS);
+			lista_tweets = tweets;
+		}
+
+		// Devuelve la lista de tweets escritos entre 'desde' y 'hasta' (ambos
+		// incluidos) (ver ver_tweets_entre) y 'OK' a través de 'res'. Si
+		// alguno está en un bloque sellado que no se puede leer (ver
+		// AlmacenFrio), la lista solo tiene los anteriores y se devuelve
+		// 'FIC_ERROR'.
+		void obtener_tweets_entre(const FechaHora &desde, const FechaHora &hasta, Tweets &lista_tweets,
+			Resultado &res) const {
+			MedidaOperacion medida(MET_OBTENER_TWEETS_ENTRE, &res);
+			VistaTweets vista = ver_tweets_entre(desde, hasta);
+			VistaTweets::const_iterator it = vista.begin();
+			lista_tweets.listado.vaciar();
+			for (; it != vista.end(); ++it) {
+				lista_tweets.listado.insertar_final(*it);
+			}
+			lista_tweets.num_tweets = lista_tweets.listado.longitud();
+			res = it.error() ? FIC_ERROR : OK;
+		}
+
+		// Devuelve el número de tweets escritos entre 'desde' y 'hasta'
+		// (ambos incluidos), sin copiarlos, y 'OK' a través de 'res'. Si
+		// hay que leer un bloque sellado que no se puede leer, se devuelve
+		// 'FIC_ERROR' (y solo se cuentan los tweets anteriores a él).
+		unsigned num_tweets_entre(const FechaHora &desde, const FechaHora &hasta, Resultado &res) const {
+			MedidaOperacion medida(MET_NUM_TWEETS_ENTRE, &res);
+			unsigned num = 0;
+			res = ver_tweets_entre(desde, hasta).contar(num) ? OK : FIC_ERROR;
+			return num;
+		}
+
+		//------------------------------------------------------------------
+		// VISTAS DE SOLO LECTURA
+		//
+		// Dan acceso a las listas del usuario sin copiarlas (a diferencia
+		// de obtener_*). Una vista de usuarios deja de ser válida al
+		// modificar la lista correspondiente; una de tweets, al vaciar o
+		// cargar la lista de tweets (nuevo_tweet no la invalida). Ambas
+		// dejan de ser válidas al asignar, mover o destruir el usuario.
+
+		// Devuelve la lista de seguidores (ordenada de menor a mayor)
+		VistaUsuarios ver_seguidores() const {
+			return VistaUsuarios(seguidores->listado.data(), seguidores->num_usuarios);
+		}
+
+		// Devuelve la lista de usuarios a los que se sigue (ordenada de
+		// menor a mayor)
+		VistaUsuarios ver_siguiendo() const {
+			return VistaUsuarios(siguiendo->listado.data(), siguiendo->num_usuarios);
+		}
+
+		// Devuelve la lista de tweets del usuario
+		VistaTweets ver_tweets() const {
+			return VistaTweets(tweets.listado, 0, tweets.num_tweets);
+		}
+
+		// Devuelve los últimos 'n' tweets del usuario (todos si tiene menos)
+		VistaTweets ver_ultimos_tweets(unsigned n) const {
+			return VistaTweets(tweets.listado, tweets.num_tweets - std::min(n, tweets.num_tweets), tweets.num_tweets);
+		}
+
+		// Devuelve los tweets escritos entre 'desde' y 'hasta' (ambos
+		// incluidos). Como nuevo_tweet solo inserta al final, si los tweets
+		// están en orden cronológico el rango se localiza mediante búsqueda
+		// binaria; si no (o si un bloque sellado de la búsqueda no se
+		// puede leer), la vista recorre la lista completa saltando los
+		// tweets que quedan fuera.
+		VistaTweets ver_tweets_entre(const FechaHora &desde, const FechaHora &hasta) const {
+			MarcaTiempo marca_desde = a_marca_tiempo(desde);
+			MarcaTiempo marca_hasta = a_marca_tiempo(hasta);
+			VistaTweets vista;
+			unsigned ini = 0, fin = 0;
+			if (tweets.listado.es_cronologica() && tweets.listado.primero_desde(marca_desde, ini) &&
+				tweets.listado.primero_desde(marca_hasta + 1, fin)) {
+				vista = VistaTweets(tweets.listado, ini, std::max(ini, fin));
+			}
+			else {
+				vista = VistaTweets(tweets.listado, 0, tweets.num_tweets, marca_desde, marca_hasta);
+			}
+			return vista;
+		}
+
+		// Indica si un determinado usuario es seguidor de este usuario
+		bool me_sigue(const std::string &otro_usuario) const {
+			return me_sigue(TablaSimbolos::global().buscar(otro_usuario));
+		}
+		bool me_sigue(IdUsuario otro_usuario) const {
+			MedidaOperacion medida(MET_ME_SIGUE);
+			bool mismo_usuario;
+			// Primero busco la posición donde debería estar
+			unsigned pos = buscar_usuario(*seguidores, otro_usuario);
+			// Si es el mismo usuario devuelve true, si no, false
+			if (esta_en_pos(*seguidores, pos, otro_usuario)) {
+				mismo_usuario = true;
+			}
+			else {
+				mismo_usuario = false;
+			}
+			return mismo_usuario;
+		}
+
+		// Indica si este usuario está siguiendo a otro
+		bool estoy_siguiendo(const std::string &otro_usuario) const {
+			return estoy_siguiendo(TablaSimbolos::global().buscar(otro_usuario));
+		}
+		bool estoy_siguiendo(IdUsuario otro_usuario) const {
+			MedidaOperacion medida(MET_ESTOY_SIGUIENDO);
+			bool mismo_usuario;
+			// Primero busco la posición donde debería estar
+			unsigned pos = buscar_usuario(*siguiendo, otro_usuario);
+			// Si es el mismo usuario devuelve true, si no, false
+			if (esta_en_pos(*siguiendo, pos, otro_usuario)) {
+				mismo_usuario = true;
+			}
+			else {
+				mismo_usuario = false;
+			}
+			return mismo_usuario;
+		}
+
+		// Devuelve los seguidores mutuos: los seguidores a los que este
+		// usuario también sigue (ordenados por identificador). Ver
+		// interseccion_usuarios.
+		void obtener_seguidores_mutuos(Usuarios &mutuos) const {
+			MedidaOperacion medida(MET_SEGUIDORES_MUTUOS);
+			interseccion_usuarios(seguidores->listado.data(), seguidores->num_usuarios,
+				siguiendo->listado.data(), siguiendo->num_usuarios, mutuos.listado);
+			mutuos.num_usuarios = unsigned(mutuos.listado.size());
+		}
+		unsigned num_seguidores_mutuos() const {
+			MedidaOperacion medida(MET_SEGUIDORES_MUTUOS);
+			return unsigned(num_interseccion_usuarios(seguidores->listado.data(), seguidores->num_usuarios,
+				siguiendo->listado.data(), siguiendo->num_usuarios));
+		}
+
+		// Devuelve los usuarios que siguen a la vez a este usuario y a
+		// 'otro' (ordenados por identificador)
+		void obtener_seguidores_comunes(const UsuarioTwitter &otro, Usuarios &comunes) const {
+			MedidaOperacion medida(MET_SEGUIDORES_COMUNES);
+			interseccion_usuarios(seguidores->listado.data(), seguidores->num_usuarios,
+				otro.seguidores->listado.data(), otro.seguidores->num_usuarios, comunes.listado);
+			comunes.num_usuarios = unsigned(comunes.listado.size());
+		}
+		unsigned num_seguidores_comunes(const UsuarioTwitter &otro) const {
+			MedidaOperacion medida(MET_SEGUIDORES_COMUNES);
+			return unsigned(num_interseccion_usuarios(seguidores->listado.data(), seguidores->num_usuarios,
+				otro.seguidores->listado.data(), otro.seguidores->num_usuarios));
+		}
+
+		// Devuelve los usuarios que siguen a este usuario pero no a 'otro'
+		// (ordenados por identificador)
+		void obtener_seguidores_excepto(const UsuarioTwitter &otro, Usuarios &lista) const {
+			MedidaOperacion medida(MET_SEGUIDORES_EXCEPTO);
+			diferencia_usuarios(seguidores->listado.data(), seguidores->num_usuarios,
+				otro.seguidores->listado.data(), otro.seguidores->num_usuarios, lista.listado);
+			lista.num_usuarios = unsigned(lista.listado.size());
+		}
+		unsigned num_seguidores_excepto(const UsuarioTwitter &otro) const {
+			MedidaOperacion medida(MET_SEGUIDORES_EXCEPTO);
+			return unsigned(num_diferencia_usuarios(seguidores->listado.data(), seguidores->num_usuarios,
+				otro.seguidores->listado.data(), otro.seguidores->num_usuarios));
+		}
+
+		// Devuelve el número de seguidores
+		unsigned num_seguidores() const {
+			return seguidores->num_usuarios;
+		}
+
+		// Devuelve el número de usuarios a los que se sigue
+		unsigned num_siguiendo() const {
+			return siguiendo->num_usuarios;
+		}
+
+		// Devuelve el número de tweets del usuario
+		unsigned num_tweets() const {
+			return tweets.num_tweets;
+		}
+
+		// Devuelve el número de menciones que ha recibido el usuario
+		unsigned num_menciones() const {
+			return unsigned(menciones->size());
+		}
+
+		// Devuelve la lista de menciones que ha recibido el usuario,
+		// ordenada por autor y, para cada autor, por número de tweet
+		void obtener_menciones(ListaMenciones &lista_menciones) const {
+			MedidaOperacion medida(MET_OBTENER_MENCIONES);
+			lista_menciones = *menciones;
+		}
+
+		// Devuelve la lista de usuarios que han mencionado a este usuario
+		// (identificadores ordenados de menor a mayor, sin repetidos)
+		void quien_me_menciona(Usuarios &autores) const {
+			MedidaOperacion medida(MET_QUIEN_ME_MENCIONA);
+			autores.listado.clear();
+			for (unsigned i = 0; i < menciones->size(); i++) {
+				if (autores.listado.empty() || autores.listado.back() != (*menciones)[i].autor) {
+					autores.listado.push_back((*menciones)[i].autor);
+				}
+			}
+			autores.num_usuarios = unsigned(autores.listado.size());
+		}
+
+		// Devuelve los números de tweet (del autor) en los que 'autor' ha
+		// mencionado a este usuario, de menor a mayor
+		void menciones_de(const std::string &autor, std::vector<unsigned> &num_tweets) const {
+			menciones_de(TablaSimbolos::global().buscar(autor), num_tweets);
+		}
+		void menciones_de(IdUsuario autor, std::vector<unsigned> &num_tweets) const {
+			MedidaOperacion medida(MET_MENCIONES_DE);
+			num_tweets.clear();
+			for (unsigned i = buscar_mencion(autor, 0); i < menciones->size() && (*menciones)[i].autor == autor; i++) {
+				num_tweets.push_back((*menciones)[i].num_tweet);
+			}
+		}
+
+		// Imprime por pantalla la lista de seguidores
+		// Si num_imprime == 0, imprime todos los seguidores. Si no,
+		// se imprime el número de seguidores que se indica.
+		// PRECONDICIÓN: num_imprime <= num_seguidores
+		void imprimir_seguidores(unsigned num_imprime) const {
+			MedidaOperacion medida(MET_IMPRIMIR_SEGUIDORES);
+			// PRECONDICIÓN: num_imprime <= num_seguidores
+			bool ok = (num_imprime <= seguidores->num_usuarios) ? true : false;
+			// Si num_imprime == 0, imprime todos los seguidores; si no,
+			// imprime "num_imprime" seguidores
+			if (ok) {
+				EscritorSalida salida(std::cout);
+				escribir_usuarios(*seguidores, 0, (num_imprime == 0) ? seguidores->num_usuarios : num_imprime, true, salida);
+			}
+			// Si no cumple la condición deuvelve error por pantalla
+			else {
+				std::cerr << "Error: El número de seguidores es menor que " << num_imprime << std::endl;
+			}
+		}
+
+		// Escribe en 'salida' una página de la lista de seguidores, en el
+		// formato de imprimir_seguidores: los 'cuantos' seguidores que
+		// empiezan en la posición 'desde' del orden alfabético (menos si la
+		// lista se acaba antes). Solo se ordena lo necesario para la página.
+		// No vacía el escritor, de forma que se pueden acumular varias
+		// páginas antes de escribirlas.
+		void imprimir_seguidores(unsigned desde, unsigned cuantos, EscritorSalida &salida) const {
+			MedidaOperacion medida(MET_IMPRIMIR_SEGUIDORES);
+			escribir_usuarios(*seguidores, desde, cuantos, true, salida);
+		}
+
+		// Imprime por pantalla la lista de usuarios a los que sigue
+		// Si num_imprime == 0, imprime todos los usuarios a los que sigue.
+		// Si no, imprime el número de usuarios que se indica.
+		// PRECONDICIÓN: num_imprime <= num_siguiendo
+		void imprimir_siguiendo(unsigned num_imprime) const {
+			MedidaOperacion medida(MET_IMPRIMIR_SIGUIENDO);
+			// PRECONDICIÓN: num_imprime <= num_siguiendo
+			bool ok = (num_imprime <= siguiendo->num_usuarios) ? true : false;
+			// Si num_imprime == 0, imprime todos los seguidos; si no,
+			// imprime "num_imprime" seguidos
+			if (ok) {
+				EscritorSalida salida(std::cout);
+				escribir_usuarios(*siguiendo, 0, (num_imprime == 0) ? siguiendo->num_usuarios : num_imprime, true, salida);
+			}
+			// Si no cumple la condición deuvelve error por pantalla
+			else {
+				std::cerr << "Error: El número de usuarios seguidos es menor que " << num_imprime << std::endl;
+			}
+		}
+
+		// Escribe en 'salida' una página de la lista de usuarios a los que
+		// sigue (ver imprimir_seguidores con página)
+		void imprimir_siguiendo(unsigned desde, unsigned cuantos, EscritorSalida &salida) const {
+			MedidaOperacion medida(MET_IMPRIMIR_SIGUIENDO);
+			escribir_usuarios(*siguiendo, desde, cuantos, true, salida);
+		}
+
+		// Imprime por pantalla la lista de tweets
+		// Si num_imprime == 0, imprime todos los tweets del usuario.
+		// Si no, imprime el número de tweets que se indica.
+		// PRECONDICIÓN: num_imprime <= num_tweets
+		void imprimir_tweets(unsigned num_imprime) const {
+			MedidaOperacion medida(MET_IMPRIMIR_TWEETS);
+			// PRECONDICIÓN: num_imprime <= num_tweets
+			bool ok = (num_imprime <= tweets.num_tweets) ? true : false;
+			// Si num_imprime == 0, imprime todos los tweets del usuario; si
+			// no, imprime los "num_imprime" últimos.
+			if (ok) {
+				EscritorSalida salida(std::cout);
+				unsigned desde = (num_imprime == 0) ? 0 : tweets.num_tweets - num_imprime;
+				if (!escribir_tweets(desde, tweets.num_tweets - desde, salida)) {
+					salida.vaciar();
+					std::cerr << "Error: No se han podido leer los tweets sellados en disco" << std::endl;
+				}
+			}
+			// Si no cumple la condición deuvelve error por pantalla
+			else {
+				std::cerr << "Error: El número de tweets es menor que " << num_imprime << std::endl;
+			}
+
+		}
+
+		// Escribe en 'salida' una página de la lista de tweets, en el
+		// formato de imprimir_tweets: los 'cuantos' tweets que empiezan en
+		// el número de tweet 'desde', en orden cronológico (menos si la
+		// lista se acaba antes), y devuelve 'OK' a través de 'res'. Si
+		// alguno está en un bloque sellado que no se puede leer (ver
+		// AlmacenFrio), solo se escriben los anteriores y se devuelve
+		// 'FIC_ERROR'. No vacía el escritor.
+		void imprimir_tweets(unsigned desde, unsigned cuantos, EscritorSalida &salida, Resultado &res) const {
+			MedidaOperacion medida(MET_IMPRIMIR_TWEETS, &res);
+			res = escribir_tweets(desde, cuantos, salida) ? OK : FIC_ERROR;
+		}
+
+		// Guarda en fichero la lista de seguidores
+		void guardar_seguidores(const std::string &nom_fic, Resultado &res) const {
+			MedidaOperacion medida(MET_GUARDAR_SEGUIDORES, &res);
+			// Variables
+			std::ofstream fichero;
+			// Abrimos
+			fichero.open(nom_fic.c_str());
+			// Comprobación (un fallo al escribir deja el fichero en error)
+			if (!fichero.fail()) {
+				EscritorSalida salida(fichero);
+				escribir_usuarios(*seguidores, 0, seguidores->num_usuarios, false, salida);
+				salida.vaciar();
+			}
+			res = (!fichero.fail()) ? OK : FIC_ERROR;
+			// Cerrar
+			fichero.close();
+		}
+
+		// Guarda en fichero la lista de usuarios a los que sigue
+		void guardar_seguiendo(const std::string &nom_fic, Resultado &res) const {
+			MedidaOperacion medida(MET_GUARDAR_SIGUIENDO, &res);
+			// Variables
+			std::ofstream fichero;
+			// Abrimos
+			fichero.open(nom_fic.c_str());
+			// Comprobación (un fallo al escribir deja el fichero en error)
+			if (!fichero.fail()) {
+				EscritorSalida salida(fichero);
+				escribir_usuarios(*siguiendo, 0, siguiendo->num_usuarios, false, salida);
+				salida.vaciar();
+			}
+			res = (!fichero.fail()) ? OK : FIC_ERROR;
+			// Cerrar
+			fichero.close();
+		}
+
+		// Guarda en fichero los tweets del usuario. Si alguno está en un
+		// bloque sellado que no se puede leer (ver AlmacenFrio), el fichero
+		// solo tiene los anteriores y se devuelve 'FIC_ERROR'.
+		void guardar_tweets(const std::string &nom_fic, Resultado &res) const {
+			MedidaOperacion medida(MET_GUARDAR_TWEETS, &res);
+			// Variables
+			std::ofstream fichero;
+			bool leidos = false;
+			// Abrimos
+			fichero.open(nom_fic.c_str());
+			// Comprobación (un fallo al escribir deja el fichero en error)
+			if (!fichero.fail()) {
+				EscritorSalida salida(fichero);
+				leidos = escribir_tweets(0, tweets.num_tweets, salida);
+				salida.vaciar();
+			}
+			res = (!fichero.fail() && leidos) ? OK : FIC_ERROR;
+			// Cerrar
+			fichero.close();
+		}
+
+		// Guarda en fichero las listas de usuarios  y tweets
+		void guardar_todo(const std::string &nom_fic_seguidores,
+			const std::string &nom_fic_siguiendo,
+			const std::string &nom_fic_tweets,
+			Resultado &res_seguidores,
+			Resultado &res_siguiendo,
+			Resultado &res_tweets) const
+		{
+			MedidaOperacion medida(MET_GUARDAR_TODO);
+			// Usamos las funciones de guardado de cada uno
+			guardar_seguidores(nom_fic_seguidores, res_seguidores);
+			guardar_seguiendo(nom_fic_siguiendo, res_siguiendo);
+			guardar_tweets(nom_fic_tweets, res_tweets);
+		}
+
+		//------------------------------------------------------------------
+		// MÉTODOS DE ACTUALIZACIÓN
+
+		// Modifica el identificador del usuario
+		void establecer_id(const std::string &nuevo_id) {
+			id_usuario = nuevo_id;
+		}
+
+		// Inserta un seguidor en la lista de seguidores.
+		// Si el nuevo seguidor no existe, se inserta de manera ordenada
+		// (por identificador; imprimir_seguidores y guardar_seguidores
+		// muestran la lista en orden lexicográfico creciente) y se devuelve
+		// 'OK' a través de 'res'. Si ya existe el seguidor, no se inserta y
+		// se devuelve 'YA_EXISTE' a través de 'res'. La lista no tiene un máximo de
+		// usuarios, por lo que nunca se devuelve 'LISTA_LLENA'. Si se recibe
+		// un IdUsuario que no está registrado en la tabla de símbolos (ver
+		// TablaSimbolos), no se inserta y se devuelve 'NO_EXISTE'.
+		void nuevo_seguidor(const std::string &nuevo, Resultado &res) {
+			nuevo_seguidor(TablaSimbolos::global().registrar(nuevo), res);
+		}
+		void nuevo_seguidor(IdUsuario nuevo, Resultado &res) {
+			MedidaOperacion medida(MET_NUEVO_SEGUIDOR, &res);
+			// Posición en la que debería de estar "nuevo"
+			unsigned pos = buscar_usuario(*seguidores, nuevo);
+			// Comprobación de que no existe
+			bool existe = esta_en_pos(*seguidores, pos, nuevo);
+			// Asignación de valor a res (la lista no tiene máximo)
+			if (nuevo >= TablaSimbolos::global().num_simbolos()) {
+				res = NO_EXISTE;
+			}
+			else if (existe) {
+				res = YA_EXISTE;
+			}
+			else {
+				insertar_usuario_pos(propia(seguidores), pos, nuevo);
+				res = OK;
+			}
+		}
+
+		// Inserta un usuario en la lista de usuarios a los que sigue.
+		// Si el nuevo usuario no existe, se inserta de manera ordenada
+		// (por identificador; imprimir_siguiendo y guardar_seguiendo
+		// muestran la lista en orden lexicográfico creciente) y se devuelve
+		// 'OK' a través de 'res'. Si ya existe el usuario, no se inserta y
+		// se devuelve 'YA_EXISTE' a través de 'res'. La lista no tiene un máximo de
+		// usuarios, por lo que nunca se devuelve 'LISTA_LLENA'. Si se recibe
+		// un IdUsuario que no está registrado en la tabla de símbolos (ver
+		// TablaSimbolos), no se inserta y se devuelve 'NO_EXISTE'.
+		void nuevo_siguiendo(const std::string &nuevo, Resultado &res) {
+			nuevo_siguiendo(TablaSimbolos::global().registrar(nuevo), res);
+		}
+		void nuevo_siguiendo(IdUsuario nuevo, Resultado &res) {
+			MedidaOperacion medida(MET_NUEVO_SIGUIENDO, &res);
+			// Posición en la que debería de estar "nuevo"
+			unsigned pos = buscar_usuario(*siguiendo, nuevo);
+			// Comprobación de que no existe
+			bool existe = esta_en_pos(*siguiendo, pos, nuevo);
+			// Asignación de valor a res (la lista no tiene máximo)
+			if (nuevo >= TablaSimbolos::global().num_simbolos()) {
+				res = NO_EXISTE;
+			}
+			else if (existe) {
+				res = YA_EXISTE;
+			}
+			else {
+				insertar_usuario_pos(propia(siguiendo), pos, nuevo);
+				res = OK;
+			}
+		}
+
+		// Inserta varios seguidores de una vez (por ejemplo, al migrar una
+		// cuenta). El resultado de 'nuevos[i]' se devuelve en
+		// 'resultados[i]' y es el mismo que daría nuevo_seguidor llamado
+		// con cada uno en orden: 'OK' si se inserta, 'YA_EXISTE' si ya
+		// estaba en la lista o aparece antes en 'nuevos' y 'NO_EXISTE' si
+		// no está registrado en la tabla de símbolos. En lugar de una
+		// inserción (y un desplazamiento de la lista) por usuario, el lote
+		// se ordena y se fusiona con la lista en una sola pasada.
+		void nuevo_seguidores(const std::vector<std::string> &nuevos, std::vector<Resultado> &resultados) {
+			nuevo_seguidores(registrar_usuarios(nuevos), resultados);
+		}
+		void nuevo_seguidores(const ListaUsuarios &nuevos, std::vector<Resultado> &resultados) {
+			MedidaOperacion medida(MET_NUEVO_SEGUIDORES);
+			insertar_usuarios(seguidores, nuevos, resultados);
+		}
+
+		// Inserta varios usuarios de una vez en la lista de usuarios a los
+		// que sigue (ver nuevo_seguidores)
+		void nuevo_siguiendos(const std::vector<std::string> &nuevos, std::vector<Resultado> &resultados) {
+			nuevo_siguiendos(registrar_usuarios(nuevos), resultados);
+		}
+		void nuevo_siguiendos(const ListaUsuarios &nuevos, std::vector<Resultado> &resultados) {
+			MedidaOperacion medida(MET_NUEVO_SIGUIENDOS);
+			insertar_usuarios(siguiendo, nuevos, resultados);
+		}
+
+		// Inserta un nuevo tweet al final de la lista de tweets y se devuelve
+		// 'OK' a través de 'res' (la lista de tweets no tiene un máximo, por lo
+		// que nunca está llena). La longitud máxima del tweet es 140 caracteres,
+		// por lo que si el texto del tweet tiene más de 140 caracteres, los
+		// caracteres sobrantes por el final se eliminarán.
+		// PRECONDICIÓN: fecha_hora_valida(nuevo.fecha_hora)
+		void nuevo_tweet(const Tweet &nuevo, Resultado &res) {
+			MedidaOperacion medida(MET_NUEVO_TWEET, &res);
+			// Inserta nuevo tweet (se trunca a 140 caracteres al copiarlo)
+			tweets.listado.insertar_final(nuevo);
+			tweets.num_tweets++;
+			// Con el almacén frío activo, los tweets antiguos pasan a disco
+			tweets.listado.sellar_antiguos();
+			res = OK;
+		}
+
+		// Añade a la lista de menciones del usuario que 'autor' le ha
+		// mencionado en su tweet número 'num_tweet' y se devuelve 'OK' a
+		// través de 'res'. Si esa mención ya está en la lista, no se añade y
+		// se devuelve 'YA_EXISTE'.
+		void nueva_mencion(const std::string &autor, unsigned num_tweet, Resultado &res) {
+			nueva_mencion(TablaSimbolos::global().registrar(autor), num_tweet, res);
+		}
+		void nueva_mencion(IdUsuario autor, unsigned num_tweet, Resultado &res) {
+			MedidaOperacion medida(MET_NUEVA_MENCION, &res);
+			// Posición en la que debería estar la mención
+			unsigned pos = buscar_mencion(autor, num_tweet);
+			bool existe = pos < menciones->size() &&
+				(*menciones)[pos].autor == autor && (*menciones)[pos].num_tweet == num_tweet;
+			res = existe ? YA_EXISTE : OK;
+			if (res == OK) {
+				Mencion nueva;
+				nueva.autor = autor;
+				nueva.num_tweet = num_tweet;
+				ListaMenciones &lista = propia(menciones);
+				lista.insert(lista.begin() + pos, nueva);
+			}
+		}
+
+		// Elimina a un usuario de la lista de seguidores
+		// Si el usuario existe, se elimina y se devuelve 'OK' a través de
+		// 'res'. Si no existe el usuario, se devuelve 'NO_EXISTE' a través
+		// de 'res'.
+		void eliminar_seguidor(const std::string &usuario, Resultado &res) {
+			eliminar_seguidor(TablaSimbolos::global().buscar(usuario), res);
+		}
+		void eliminar_seguidor(IdUsuario usuario, Resultado &res) {
+			MedidaOperacion medida(MET_ELIMINAR_SEGUIDOR, &res);
+			unsigned pos;
+			// Posicion donde debería de estar el usuario
+			pos = buscar_usuario(*seguidores, usuario);
+			res = esta_en_pos(*seguidores, pos, usuario) ? OK : NO_EXISTE;
+			// Si el usuario existe eliminarlo
+			if (res == OK) {
+				eliminar_usuario_pos(propia(seguidores), pos);
+			}
+		}
+
+		// Elimina a un usuario de la lista de usuarios a los que sigue
+		// Si el usuario existe, se elimina y se devuelve 'OK' a través de
+		// 'res'. Si no existe el usuario, se devuelve 'NO_EXISTE' a través
+		// de 'res'.
+		void eliminar_siguiendo(const std::string &usuario, Resultado &res) {
+			eliminar_siguiendo(TablaSimbolos::global().buscar(usuario), res);
+		}
+		void eliminar_siguiendo(IdUsuario usuario, Resultado &res) {
+			MedidaOperacion medida(MET_ELIMINAR_SIGUIENDO, &res);
+			unsigned pos;
+			// Posicion donde debería de estar el usuario
+			pos = buscar_usuario(*siguiendo, usuario);
+			res = esta_en_pos(*siguiendo, pos, usuario) ? OK : NO_EXISTE;
+			// Si el usuario existe eliminarlo
+			if (res == OK) {
+				eliminar_usuario_pos(propia(siguiendo), pos);
+			}
+		}
+
+		// Carga desde fichero la lista de seguidores,
+		// eliminando los seguidores actuales. Si el fichero se ha leído
+		// correctamente, se devuelve 'OK' a través de 'res'; en caso
+		// contrario, se devuelve 'FIC_ERROR'. La lista no tiene un máximo
+		// de usuarios, por lo que se insertan todos los leídos y nunca se
+		// devuelve 'LISTA_LLENA'.
+		void cargar_seguidores(const std::string &nom_fic, Resultado &res) {
+			cargar_seguidores(nom_fic, SUSTITUIR_LISTA, res);
+		}
+		// Con FUSIONAR_LISTA, los usuarios del fichero se añaden a los
+		// actuales (como con nuevo_seguidores) en lugar de sustituirlos
+		void cargar_seguidores(const std::string &nom_fic, ModoCarga modo, Resultado &res) {
+			MedidaOperacion medida(MET_CARGAR_SEGUIDORES, &res);
+			// Variables
+			std::ifstream fichero;
+			// Abrir fichero
+			fichero.open(nom_fic.c_str());
+			// Si no falla, leer los usuarios
+			if (!fichero.fail()) {
+				std::string leido;
+				ListaUsuarios leidos;
+				while (getline(fichero, leido)) {
+					leidos.push_back(TablaSimbolos::global().registrar(leido));
+				}
+				if (modo == SUSTITUIR_LISTA) {
+					seguidores = usuarios_vacia();
+				}
+				std::vector<Resultado> resultados;
+				insertar_usuarios(seguidores, leidos, resultados);
+			}
+			// Si el fichero ha llegado al fina, todo correcto
+			res = (fichero.eof()) ? OK : FIC_ERROR;
+			// Cerramos
+			fichero.close();
+		}
+
+		// Carga desde fichero la lista de usuarios a los que se sigue,
+		// eliminando los usuarios seguidos actuales. Si el fichero se ha leído
+		// correctamente, se devuelve 'OK' a través de 'res'; en caso
+		// contrario, se devuelve 'FIC_ERROR'. La lista no tiene un máximo
+		// de usuarios, por lo que se insertan todos los leídos y nunca se
+		// devuelve 'LISTA_LLENA'.
+		void cargar_seguiendo(const std::string &nom_fic, Resultado &res) {
+			cargar_seguiendo(nom_fic, SUSTITUIR_LISTA, res);
+		}
+		// Con FUSIONAR_LISTA, los usuarios del fichero se añaden a los
+		// actuales (como con nuevo_siguiendos) en lugar de sustituirlos
+		void cargar_seguiendo(const std::string &nom_fic, ModoCarga modo, Resultado &res) {
+			MedidaOperacion medida(MET_CARGAR_SIGUIENDO, &res);
+			// Variables
+			std::ifstream fichero;
+			// Abrir fichero
+			fichero.open(nom_fic.c_str());
+			// Si no falla, leer los usuarios
+			if (!fichero.fail()) {
+				std::string leido;
+				ListaUsuarios leidos;
+				while (getline(fichero, leido)) {
+					leidos.push_back(TablaSimbolos::global().registrar(leido));
+				}
+				if (modo == SUSTITUIR_LISTA) {
+					siguiendo = usuarios_vacia();
+				}
+				std::vector<Resultado> resultados;
+				insertar_usuarios(siguiendo, leidos, resultados);
+			}
+			// Si el fichero ha llegado al fina, todo correcto
+			res = (fichero.eof()) ? OK : FIC_ERROR;
+			// Cerramos
+			fichero.close();
+		}
+
+		// Carga desde fichero la lista de tweets del usuario,
+		// eliminando los tweets actuales (ver leer_fichero_tweets). Si el
+		// fichero se ha leído correctamente, se devuelve 'OK' a través de
+		// 'res'. Si no se puede abrir o tiene líneas mal formadas, se
+		// devuelve 'FIC_ERROR' (aunque se insertan todas las líneas
+		// correctas); los números de las líneas mal formadas se devuelven
+		// a través de 'lineas_erroneas'.
+		void cargar_tweets(const std::string &nom_fic, Resultado &res) {
+			std::vector <unsigned> lineas_erroneas;
+			cargar_tweets(nom_fic, lineas_erroneas, res);
+		}
+		void cargar_tweets(const std::string &nom_fic, std::vector <unsigned> &lineas_erroneas, Resultado &res) {
+			MedidaOperacion medida(MET_CARGAR_TWEETS, &res);
+			ListaTweets leidos;
+			bool abierto = leer_fichero_tweets(nom_fic, lineas_erroneas, [&leidos](const LineaTweet &linea) {
+				leidos.insertar_final(a_marca_tiempo(linea), linea.texto, linea.longitud);
+				// Los tweets antiguos se sellan a medida que se leen, de modo
+				// que la historia completa no llega a estar en memoria
+				leidos.sellar_antiguos();
+			});
+			if (abierto) {
+				tweets.listado = std::move(leidos);
+				tweets.num_tweets = tweets.listado.longitud();
+			}
+			res = (abierto && lineas_erroneas.empty()) ? OK : FIC_ERROR;
+		}
+
+		// Carga desde fichero las listas de usuarios y tweets. Si cada fichero se ha leído
+		// correctamente, se devuelve 'OK' a través del parámetro 'res_*' correspondiente;
+		// en caso contrario, se devuelve 'FIC_ERROR' (ver cargar_seguidores,
+		// cargar_seguiendo y cargar_tweets). Ninguna lista tiene un máximo, por lo
+		// que nunca se devuelve 'LISTA_LLENA'.
+		void cargar_todo(const std::string &nom_fic_seguidores,
+			const std::string &nom_fic_siguiendo,
+			const std::string &nom_fic_tweets,
+			Resultado & res_seguidores,
+			Resultado & res_siguiendo,
+			Resultado & res_tweets)
+		{
+			MedidaOperacion medida(MET_CARGAR_TODO);
+			cargar_seguidores(nom_fic_seguidores, res_seguidores);
+			cargar_seguiendo(nom_fic_siguiendo, res_siguiendo);
+			cargar_tweets(nom_fic_tweets, res_tweets);
+		}
+
+	private:
+		//------------------------------------------------------------------
+		// ATRIBUTOS: A DEFINIR POR EL ALUMNO
+		//
+		// Identificador del usuario
+		// ... id_usuario;
+		std::string id_usuario;
+		// Lista de tweets
+		// ... tweets;
+		Tweets tweets;
+		// Lista de usuarios a los que se estoy siguiendo
+		// ... siguiendo;
+		std::shared_ptr<Usuarios> siguiendo;
+		// Lista de usuarios que me siguen
+		// ... seguidores;
+		std::shared_ptr<Usuarios> seguidores;
+		// Lista de menciones que otros usuarios hacen de mí en sus tweets,
+		// ordenada por autor y número de tweet
+		std::shared_ptr<ListaMenciones> menciones;
+		// Las tres listas anteriores pueden estar compartidas con copias
+		// de este usuario: solo se modifican a través de propia()
+		//------------------------------------------------------------------
+
+		//------------------------------------------------------------------
+		// MÉTODOS PRIVADOS:
+		//
+		// Listas vacías compartidas por todos los usuarios que no tienen
+		// usuarios o menciones (nunca se modifican, porque propia() las
+		// copia antes)
+		static const std::shared_ptr<Usuarios> & usuarios_vacia() {
+			static const std::shared_ptr<Usuarios> vacia = std::make_shared<Usuarios>();
+			return vacia;
+		}
+		static const std::shared_ptr<ListaMenciones> & menciones_vacia() {
+			static const std::shared_ptr<ListaMenciones> vacia = std::make_shared<ListaMenciones>();
+			return vacia;
+		}
+
+		// Devuelve la lista 'compartida' para modificarla. Si también la
+		// usa otro usuario, antes se sustituye por una copia propia.
+		template <typename Lista>
+		static Lista & propia(std::shared_ptr<Lista> &compartida) {
+			if (compartida.use_count() > 1) {
+				compartida = std::make_shared<Lista>(*compartida);
+			}
+			return *compartida;
+		}
+
+		// Deja el usuario sin identificador, usuarios, tweets ni menciones
+		// (estado de un usuario del que se ha movido el contenido)
+		void vaciar() noexcept {
+			id_usuario.clear();
+			tweets.listado.vaciar();
+			tweets.num_tweets = 0;
+			siguiendo = usuarios_vacia();
+			seguidores = usuarios_vacia();
+			menciones = menciones_vacia();
+		}
+
+		// Busca a un usuario en la lista ordenada de usuarios. Si lo
+		// encuentra, devuelve la posición de la lista donde está. Si no,
+		// devuelve la posición donde debería estar según el orden de la
+		// lista. Búsqueda binaria: O(log n).
+		unsigned buscar_usuario(const Usuarios &usuarios, IdUsuario user) const {
+			return unsigned(std::lower_bound(usuarios.listado.begin(), usuarios.listado.end(), user) -
+				usuarios.listado.begin());
+		}
+
+		// Indica si el usuario está en la posición 'pos' de la lista
+		bool esta_en_pos(const Usuarios &usuarios, unsigned pos, IdUsuario user) const {
+			return (pos < usuarios.num_usuarios) && (usuarios.listado[pos] == user);
+		}
+
+		// Inserta un usuario en la lista en la posición indicada
+		// PRECONDICIÓN: la posición es correcta
+		void insertar_usuario_pos(Usuarios &usuarios, unsigned pos, IdUsuario usuario) {
+			// PRECONDICIÓN: la posición es correcta. Basta con comparar con
+			// los vecinos, sin repetir la búsqueda.
+			bool posicion_correcta = (pos <= usuarios.num_usuarios) &&
+				(pos == 0 || usuarios.listado[pos - 1] < usuario) &&
+				(pos == usuarios.num_usuarios || usuario < usuarios.listado[pos]);
+			// Si cumple, inserta un usuario en la lista en la posición indicada
+			if (posicion_correcta) {
+				usuarios.listado.insert(usuarios.listado.begin() + pos, usuario);
+				usuarios.num_usuarios++;
+			}
+		}
+
+		// Devuelve los identificadores de los nombres, registrándolos
+		static ListaUsuarios registrar_usuarios(const std::vector<std::string> &nombres) {
+			ListaUsuarios ids(nombres.size());
+			for (std::size_t i = 0; i < nombres.size(); i++) {
+				ids[i] = TablaSimbolos::global().registrar(nombres[i]);
+			}
+			return ids;
+		}
+
+		// Inserta en la lista 'compartida' los usuarios de 'nuevos' que no
+		// estén ya, con el resultado de cada uno en 'resultados' (ver
+		// nuevo_seguidores). El lote se ordena (junto con la posición de
+		// cada usuario en 'nuevos', para que de los repetidos cuente el
+		// primero), se busca cada usuario distinto a partir de la posición
+		// del anterior y los que faltan se fusionan con la lista de atrás
+		// adelante, moviendo cada usuario de la lista una sola vez:
+		// O(k log k + k log n + n) en lugar de O(k n) con k inserciones.
+		// Si no hay ninguno que insertar, la lista no se modifica (ni se
+		// copia si está compartida).
+		void insertar_usuarios(std::shared_ptr<Usuarios> &compartida, const ListaUsuarios &nuevos,
+			std::vector<Resultado> &resultados) {
+			std::vector<std::pair<IdUsuario, unsigned>> lote(nuevos.size());
+			for (unsigned i = 0; i < nuevos.size(); i++) {
+				lote[i] = std::make_pair(nuevos[i], i);
+			}
+			std::sort(lote.begin(), lote.end());
+			resultados.assign(nuevos.size(), YA_EXISTE);
+			// Usuarios del lote que no están en la lista, ordenados
+			ListaUsuarios faltan;
+			const ListaUsuarios &actual = compartida->listado;
+			ListaUsuarios::const_iterator desde = actual.begin();
+			IdUsuario num_simbolos = TablaSimbolos::global().num_simbolos();
+			for (std::size_t i = 0; i < lote.size(); i++) {
+				if (lote[i].first >= num_simbolos) {
+					resultados[lote[i].second] = NO_EXISTE;
+				}
+				else if (i == 0 || lote[i].first != lote[i - 1].first) {
+					desde = std::lower_bound(desde, actual.end(), lote[i].first);
+					if (desde == actual.end() || *desde != lote[i].first) {
+						faltan.push_back(lote[i].first);
+						resultados[lote[i].second] = OK;
+					}
+				}
+			}
+			if (!faltan.empty()) {
+				Usuarios &usuarios = propia(compartida);
+				std::size_t i = usuarios.listado.size(), j = faltan.size();
+				usuarios.listado.resize(i + j);
+				// Fusión de atrás adelante: los usuarios anteriores al primero
+				// que se inserta no se mueven
+				while (j > 0) {
+					if (i > 0 && usuarios.listado[i - 1] > faltan[j - 1]) {
+						usuarios.listado[i + j - 1] = usuarios.listado[i - 1];
+						i--;
+					}
+					else {
+						usuarios.listado[i + j - 1] = faltan[j - 1];
+						j--;
+					}
+				}
+				usuarios.num_usuarios = unsigned(usuarios.listado.size());
+			}
+		}
+
+		// Busca una mención en la lista ordenada de menciones. Devuelve la
+		// posición donde está o donde debería estar. Búsqueda binaria.
+		unsigned buscar_mencion(IdUsuario autor, unsigned num_tweet) const {
+			unsigned ini = 0, fin = unsigned(menciones->size());
+			while (ini < fin) {
+				unsigned mitad = ini + (fin - ini) / 2;
+				if ((*menciones)[mitad].autor < autor ||
+					((*menciones)[mitad].autor == autor && (*menciones)[mitad].num_tweet < num_tweet)) {
+					ini = mitad + 1;
+				}
+				else {
+					fin = mitad;
+				}
+			}
+			return ini;
+		}
+
+		// Devuelve los nombres de los usuarios de la lista de forma que las
+		// posiciones [desde, hasta) son las de ese tramo en orden
+		// lexicográfico creciente (el resto quedan sin ordenar). Los
+		// nombres apuntan a la tabla de símbolos, sin copiarlos.
+		// PRECONDICIÓN: desde <= hasta <= usuarios.num_usuarios
+		void nombres_ordenados(const Usuarios &usuarios, unsigned desde, unsigned hasta,
+			std::vector<std::string_view> &nombres) const {
+			const TablaSimbolos &tabla = TablaSimbolos::global();
+			nombres.clear();
+			nombres.reserve(usuarios.num_usuarios);
+			for (unsigned i = 0; i < usuarios.num_usuarios; i++) {
+				nombres.push_back(tabla.nombre(usuarios.listado[i]));
+			}
+			if (desde > 0 && desde < hasta) {
+				std::nth_element(nombres.begin(), nombres.begin() + desde, nombres.end());
+			}
+			std::partial_sort(nombres.begin() + desde, nombres.begin() + hasta, nombres.end());
+		}
+
+		// Escribe en 'salida' los usuarios de las posiciones [desde,
+		// desde + cuantos) del orden alfabético de 'usuarios', uno por
+		// línea y, si 'numerados', precedidos de su posición ("n: nombre")
+		void escribir_usuarios(const Usuarios &usuarios, unsigned desde, unsigned cuantos, bool numerados,
+			EscritorSalida &salida) const {
+			desde = std::min(desde, usuarios.num_usuarios);
+			unsigned hasta = desde + std::min(cuantos, usuarios.num_usuarios - desde);
+			std::vector<std::string_view> nombres;
+			nombres_ordenados(usuarios, desde, hasta, nombres);
+			for (unsigned i = desde; i < hasta; i++) {
+				if (numerados) {
+					salida.natural(i);
+					salida.texto(": ", 2);
+				}
+				salida.texto(nombres[i]);
+				salida.caracter('\n');
+			}
+		}
+
+		// Escribe en 'salida' los tweets [desde, desde + cuantos), uno por
+		// línea: "dia mes anyo hora minuto segundo texto". Devuelve false si
+		// un bloque sellado no se puede leer (se han escrito los tweets
+		// anteriores a él).
+		bool escribir_tweets(unsigned desde, unsigned cuantos, EscritorSalida &salida) const {
+			desde = std::min(desde, tweets.num_tweets);
+			unsigned hasta = desde + std::min(cuantos, tweets.num_tweets - desde);
+			// A través de una vista, que lee los bloques sellados
+			VistaTweets vista(tweets.listado, desde, hasta);
+			VistaTweets::const_iterator it = vista.begin();
+			for (; it != vista.end(); ++it) {
+				const RegistroTweet &registro = *it;
+				FechaHora fecha_hora = a_fecha_hora(registro.marca_tiempo);
+				const unsigned campos[6] = { fecha_hora.dia, fecha_hora.mes, fecha_hora.anyo,
+					fecha_hora.hora, fecha_hora.minuto, fecha_hora.segundo };
+				for (unsigned c = 0; c < 6; c++) {
+					salida.natural(campos[c]);
+					salida.caracter(' ');
+				}
+				salida.texto(registro.tweet);
+				salida.caracter('\n');
+			}
+			return !it.error();
+		}
+
+		// Elimina un usuario de una posisición
+		// PRECONDICIÓN: la posición es correcta
+		void eliminar_usuario_pos(Usuarios &usuarios, unsigned pos) {
+			// PRECONDICIÓN: la posición es correcta
+			bool posicion_correcta = (pos < usuarios.num_usuarios) ? true : false;
+			// Si todo va bien, eliminar usuario
+			if (posicion_correcta) {
+				usuarios.listado.erase(usuarios.listado.begin() + pos);
+				// Quito 1 de la cuenta de la lista
+				usuarios.num_usuarios--;
+			}
+		}
+	};
+}
 #endif
\ No newline at end of file